@@ -0,0 +1,36 @@
+// Copyright 2025 Sam Windell
+// SPDX-License-Identifier: LGPL-3.0
+//
+// What every bench needs: a clock to time with and a cheap signal that is the
+// same on every platform.
+
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <stdint.h>
+#include <time.h>
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+// Monotonic, so adjustments of the wall clock can't land in a timing
+static inline double now_ns(void) {
+#if defined(_WIN32)
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#endif
+}
+
+static inline float white_noise(uint32_t *seed) {
+  *seed = *seed * 1664525U + 1013904223U;
+  return ((float)(*seed >> 8) / (float)(1U << 24)) * 2.F - 1.F;
+}
+
+#endif
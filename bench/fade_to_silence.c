@@ -0,0 +1,128 @@
+// Copyright 2025 Sam Windell
+// SPDX-License-Identifier: LGPL-3.0
+//
+// Feeds a signal that fades out to digital silence through the denoiser and
+// compares the processing cost of the loud part against the quiet tail. The
+// decaying internal state of the denoiser drifts into the denormal range on
+// the tail, so without flush-to-zero the quiet segments get much slower.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_utils.h"
+#include "specbleach_denoiser.h"
+
+#define SAMPLE_RATE 48000U
+#define FRAME_SIZE_MS 46.F
+#define BLOCK_SIZE 512U
+#define MAX_ALLOWED_SLOWDOWN 2.0
+
+enum Segment {
+  segment_LEARN,
+  segment_LOUD,
+  segment_FADE,
+  segment_SILENCE,
+  segment_COUNT,
+};
+
+static const char *segment_names[segment_COUNT] = {
+    "learn", "loud", "fade", "silence"};
+static const float segment_seconds[segment_COUNT] = {2.F, 4.F, 4.F, 8.F};
+
+int main(void) {
+  SpectralBleachHandle instance =
+      specbleach_initialize(SAMPLE_RATE, FRAME_SIZE_MS);
+  if (!instance) {
+    fprintf(stderr, "failed to initialize the denoiser\n");
+    return 1;
+  }
+
+  SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 20.F,
+      .smoothing_factor = 50.F,
+      .transient_protection = true,
+      .whitening_factor = 50.F,
+      .noise_scaling_type = 0,
+      .noise_rescale = 2.F,
+      .post_filter_threshold = 0.F,
+  };
+
+  float input[BLOCK_SIZE];
+  float output[BLOCK_SIZE];
+  uint32_t seed = 1U;
+  uint32_t phase = 0U;
+  uint64_t denormal_outputs = 0U;
+  double segment_ns[segment_COUNT] = {0};
+  uint64_t segment_samples[segment_COUNT] = {0};
+
+  for (int segment = 0; segment < segment_COUNT; ++segment) {
+    parameters.learn_noise = segment == segment_LEARN ? 1 : 0;
+    specbleach_load_parameters(instance, parameters);
+
+    const uint32_t total =
+        (uint32_t)(segment_seconds[segment] * (float)SAMPLE_RATE);
+    // Roughly -700 dB over the fade so the input itself ends up denormal
+    // before reaching zero.
+    const float fade_step = powf(10.F, -700.F / 20.F / (float)total);
+    float gain = 1.F;
+
+    for (uint32_t done = 0U; done < total; done += BLOCK_SIZE) {
+      for (uint32_t k = 0U; k < BLOCK_SIZE; ++k, ++phase) {
+        float sample = 0.1F * white_noise(&seed);
+        if (segment != segment_LEARN) {
+          sample += 0.3F * sinf(2.F * 3.14159265F * 440.F * (float)phase /
+                                (float)SAMPLE_RATE);
+        }
+        if (segment == segment_FADE) {
+          gain *= fade_step;
+          sample *= gain;
+        } else if (segment == segment_SILENCE) {
+          sample = 0.F;
+        }
+        input[k] = sample;
+      }
+
+      const double start = now_ns();
+      specbleach_process(instance, BLOCK_SIZE, input, output);
+      segment_ns[segment] += now_ns() - start;
+      segment_samples[segment] += BLOCK_SIZE;
+
+      for (uint32_t k = 0U; k < BLOCK_SIZE; ++k) {
+        if (fpclassify(output[k]) == FP_SUBNORMAL) {
+          denormal_outputs++;
+        }
+      }
+    }
+  }
+
+  specbleach_free(instance);
+
+  double ns_per_sample[segment_COUNT];
+  for (int segment = 0; segment < segment_COUNT; ++segment) {
+    ns_per_sample[segment] =
+        segment_ns[segment] / (double)segment_samples[segment];
+    printf("%-8s %8.2f ns/sample\n", segment_names[segment],
+           ns_per_sample[segment]);
+  }
+
+  const double fade_ratio =
+      ns_per_sample[segment_FADE] / ns_per_sample[segment_LOUD];
+  const double silence_ratio =
+      ns_per_sample[segment_SILENCE] / ns_per_sample[segment_LOUD];
+  printf("fade/loud ratio: %.2f\n", fade_ratio);
+  printf("silence/loud ratio: %.2f\n", silence_ratio);
+  printf("denormal output samples: %llu\n",
+         (unsigned long long)denormal_outputs);
+
+  if (denormal_outputs != 0U || fade_ratio > MAX_ALLOWED_SLOWDOWN ||
+      silence_ratio > MAX_ALLOWED_SLOWDOWN) {
+    printf("FAIL: denormal slowdown detected\n");
+    return 1;
+  }
+
+  printf("OK: no denormal slowdown\n");
+  return 0;
+}
@@ -0,0 +1,468 @@
+// Copyright 2025 Sam Windell
+// SPDX-License-Identifier: LGPL-3.0
+//
+// A headless host that drives the plugin through its process() callback the
+// way hosts do, and times every callback. It sweeps the channel layouts,
+// sample rates, latency modes, host block sizes, including irregular ones,
+// and how many parameter changes arrive per callback. For each combination it
+// reports the mean and the worst callback, and the fraction of the real-time
+// budget of a callback they use. The worst callback is the one that matters:
+// a single one over budget is a dropout, whatever the mean is. The host has no
+// thread pool, so the channels of a callback run one after the other.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <clap/clap.h>
+
+#include "bench_utils.h"
+
+#define MAX_BLOCK_SIZE 4096U
+#define MAX_CHANNELS 2U
+#define MAX_EVENTS_PER_CALLBACK 128U
+#define LEARN_SECONDS 0.5F
+#define WARMUP_SECONDS 0.1F
+#define MEASURED_SECONDS 1.F
+// Block size that stands for blocks of random sizes between 1 and the maximum
+#define IRREGULAR_BLOCKS 0U
+
+extern const clap_plugin_factory_t s_plugin_factory;
+
+static const double sample_rates[] = {44100.0, 48000.0, 96000.0, 192000.0};
+static const uint32_t block_sizes[] = {1,   16,   64,
+                                       512, 4096, IRREGULAR_BLOCKS};
+
+// Samples between parameter changes, or 0 for none. Automation usually comes
+// once per block at most, the densest one is a fast drawn in curve
+typedef struct EventDensity {
+  const char *name;
+  uint32_t samples_between_events;
+} EventDensity;
+
+static const EventDensity event_densities[] = {
+    {"none", 0U},
+    {"every 1024", 1024U},
+    {"every 32", 32U},
+};
+
+// Continuous parameters the events move, by their CLAP ids
+static clap_id automated_params[8];
+static double automated_min[8];
+static double automated_max[8];
+static uint32_t automated_param_count = 0U;
+
+typedef struct EventList {
+  clap_event_param_value_t events[MAX_EVENTS_PER_CALLBACK];
+  uint32_t count;
+} EventList;
+
+static const void *host_get_extension(const clap_host_t *host,
+                                      const char *extension_id) {
+  return NULL;
+}
+
+static void host_request_restart(const clap_host_t *host) {}
+
+static void host_request_process(const clap_host_t *host) {}
+
+static void host_request_callback(const clap_host_t *host) {}
+
+static const clap_host_t host = {
+    .clap_version = CLAP_VERSION_INIT,
+    .host_data = NULL,
+    .name = "Bench Host",
+    .vendor = "",
+    .url = "",
+    .version = "1",
+    .get_extension = host_get_extension,
+    .request_restart = host_request_restart,
+    .request_process = host_request_process,
+    .request_callback = host_request_callback,
+};
+
+static uint32_t in_events_size(const clap_input_events_t *list) {
+  return ((const EventList *)list->ctx)->count;
+}
+
+static const clap_event_header_t *in_events_get(const clap_input_events_t *list,
+                                                uint32_t index) {
+  return &((const EventList *)list->ctx)->events[index].header;
+}
+
+static bool out_events_try_push(const clap_output_events_t *list,
+                                const clap_event_header_t *event) {
+  return false;
+}
+
+static void push_param_event(EventList *list, const uint32_t time,
+                             const clap_id param_id, const double value) {
+  if (list->count == MAX_EVENTS_PER_CALLBACK) {
+    return;
+  }
+
+  list->events[list->count++] = (clap_event_param_value_t){
+      .header =
+          {
+              .size = sizeof(clap_event_param_value_t),
+              .time = time,
+              .space_id = CLAP_CORE_EVENT_SPACE_ID,
+              .type = CLAP_EVENT_PARAM_VALUE,
+              .flags = 0,
+          },
+      .param_id = param_id,
+      .cookie = NULL,
+      .note_id = -1,
+      .port_index = -1,
+      .channel = -1,
+      .key = -1,
+      .value = value,
+  };
+}
+
+static void find_automated_params(const clap_plugin_t *plugin) {
+  const clap_plugin_params_t *params =
+      plugin->get_extension(plugin, CLAP_EXT_PARAMS);
+  automated_param_count = 0U;
+  if (!params) {
+    return;
+  }
+
+  for (uint32_t index = 0U; index < params->count(plugin); index++) {
+    clap_param_info_t info;
+    if (params->get_info(plugin, index, &info) &&
+        (info.flags & CLAP_PARAM_IS_AUTOMATABLE) &&
+        !(info.flags & CLAP_PARAM_IS_STEPPED) &&
+        automated_param_count < sizeof(automated_params) / sizeof(clap_id)) {
+      automated_params[automated_param_count] = info.id;
+      automated_min[automated_param_count] = info.min_value;
+      automated_max[automated_param_count] = info.max_value;
+      automated_param_count++;
+    }
+  }
+}
+
+static bool find_param_info(const clap_plugin_t *plugin, const char *name,
+                            clap_param_info_t *info) {
+  const clap_plugin_params_t *params =
+      plugin->get_extension(plugin, CLAP_EXT_PARAMS);
+  for (uint32_t index = 0U; params && index < params->count(plugin);
+       index++) {
+    if (params->get_info(plugin, index, info) &&
+        strcmp(info->name, name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static clap_id find_param(const clap_plugin_t *plugin, const char *name) {
+  clap_param_info_t info;
+  return find_param_info(plugin, name, &info) ? info.id : CLAP_INVALID_ID;
+}
+
+// Sets the latency mode while inactive, as hosts do when loading a project,
+// and gives back the name the plugin shows for it
+static bool set_latency_mode(const clap_plugin_t *plugin, const uint32_t mode,
+                             char *name, const uint32_t name_size) {
+  const clap_plugin_params_t *params =
+      plugin->get_extension(plugin, CLAP_EXT_PARAMS);
+  const clap_id latency_mode = find_param(plugin, "Latency Mode");
+  if (latency_mode == CLAP_INVALID_ID) {
+    return false;
+  }
+
+  EventList events = {.count = 0U};
+  push_param_event(&events, 0U, latency_mode, (double)mode);
+  const clap_input_events_t in_events = {
+      .ctx = &events,
+      .size = in_events_size,
+      .get = in_events_get,
+  };
+  const clap_output_events_t out_events = {
+      .ctx = NULL,
+      .try_push = out_events_try_push,
+  };
+  params->flush(plugin, &in_events, &out_events);
+
+  return params->value_to_text(plugin, latency_mode, (double)mode, name,
+                               name_size);
+}
+
+// Every mode the latency mode parameter has
+static uint32_t count_latency_modes(const clap_plugin_factory_t *factory,
+                                    const char *plugin_id) {
+  const clap_plugin_t *plugin =
+      factory->create_plugin(factory, &host, plugin_id);
+  if (!plugin) {
+    return 0U;
+  }
+
+  clap_param_info_t info;
+  const uint32_t count =
+      plugin->init(plugin) && find_param_info(plugin, "Latency Mode", &info)
+          ? (uint32_t)info.max_value + 1U
+          : 0U;
+  plugin->destroy(plugin);
+  return count;
+}
+
+typedef struct CallbackStats {
+  double total_ns;
+  double worst_ns;
+  double worst_budget_fraction;
+  double audio_seconds;
+  uint32_t callbacks;
+} CallbackStats;
+
+typedef struct Session {
+  const clap_plugin_t *plugin;
+  uint32_t channel_count;
+  double sample_rate;
+  uint64_t position;
+  uint32_t seed;
+  uint32_t block_seed;
+  float inputs[MAX_CHANNELS][MAX_BLOCK_SIZE];
+  float outputs[MAX_CHANNELS][MAX_BLOCK_SIZE];
+  EventList events;
+  // Change sent at the start of the next callback, if there is one
+  clap_id pending_param;
+  double pending_value;
+} Session;
+
+static uint32_t next_block_size(Session *session, const uint32_t block_size) {
+  if (block_size != IRREGULAR_BLOCKS) {
+    return block_size;
+  }
+
+  session->block_seed = session->block_seed * 1664525U + 1013904223U;
+  return 1U + (session->block_seed >> 8) % MAX_BLOCK_SIZE;
+}
+
+// Runs the given seconds of audio through the plugin, timing each callback
+// into the stats if there are any
+static void run(Session *session, const float seconds,
+                const uint32_t block_size, const EventDensity *density,
+                CallbackStats *stats) {
+  float *input_channels[MAX_CHANNELS];
+  float *output_channels[MAX_CHANNELS];
+  for (uint32_t channel = 0U; channel < MAX_CHANNELS; channel++) {
+    input_channels[channel] = session->inputs[channel];
+    output_channels[channel] = session->outputs[channel];
+  }
+  clap_audio_buffer_t input_buffer = {.data32 = input_channels,
+                                      .channel_count = session->channel_count};
+  clap_audio_buffer_t output_buffer = {.data32 = output_channels,
+                                       .channel_count =
+                                           session->channel_count};
+  const clap_input_events_t in_events = {
+      .ctx = &session->events,
+      .size = in_events_size,
+      .get = in_events_get,
+  };
+  const clap_output_events_t out_events = {
+      .ctx = NULL,
+      .try_push = out_events_try_push,
+  };
+  clap_process_t process = {
+      .steady_time = -1,
+      .transport = NULL,
+      .audio_inputs = &input_buffer,
+      .audio_outputs = &output_buffer,
+      .audio_inputs_count = 1,
+      .audio_outputs_count = 1,
+      .in_events = &in_events,
+      .out_events = &out_events,
+  };
+
+  const uint64_t total = (uint64_t)(seconds * session->sample_rate);
+  for (uint64_t done = 0U; done < total;) {
+    const uint32_t frames = next_block_size(session, block_size);
+
+    // Noise with low passed bursts so the denoiser has something to keep
+    for (uint32_t k = 0U; k < frames; k++) {
+      const bool burst =
+          ((session->position + k) / (uint64_t)session->sample_rate) % 2U ==
+          1U;
+      for (uint32_t channel = 0U; channel < session->channel_count;
+           channel++) {
+        session->inputs[channel][k] =
+            0.05F * white_noise(&session->seed) +
+            (burst ? 0.3F * white_noise(&session->seed) : 0.F);
+      }
+    }
+
+    // Events land on the multiples of the density, each one moving the next
+    // parameter to a new value, the way automation lanes do
+    session->events.count = 0U;
+    if (session->pending_param != CLAP_INVALID_ID) {
+      push_param_event(&session->events, 0U, session->pending_param,
+                       session->pending_value);
+      session->pending_param = CLAP_INVALID_ID;
+    }
+    const uint32_t between = density ? density->samples_between_events : 0U;
+    if (between > 0U && automated_param_count > 0U) {
+      const uint64_t first =
+          (session->position + between - 1U) / between * between;
+      for (uint64_t time = first; time < session->position + frames;
+           time += between) {
+        const uint32_t index = (uint32_t)((time / between) %
+                                          automated_param_count);
+        const double phase =
+            (double)((time / between / automated_param_count) % 16U) / 15.0;
+        push_param_event(&session->events,
+                         (uint32_t)(time - session->position),
+                         automated_params[index],
+                         automated_min[index] +
+                             phase * (automated_max[index] -
+                                      automated_min[index]));
+      }
+    }
+
+    process.frames_count = frames;
+    const double start = now_ns();
+    session->plugin->process(session->plugin, &process);
+    const double elapsed = now_ns() - start;
+
+    if (stats) {
+      const double budget_ns = 1e9 * (double)frames / session->sample_rate;
+      stats->total_ns += elapsed;
+      stats->audio_seconds += (double)frames / session->sample_rate;
+      stats->callbacks++;
+      if (elapsed > stats->worst_ns) {
+        stats->worst_ns = elapsed;
+      }
+      if (elapsed / budget_ns > stats->worst_budget_fraction) {
+        stats->worst_budget_fraction = elapsed / budget_ns;
+      }
+    }
+
+    session->position += frames;
+    done += frames;
+  }
+}
+
+// Learns a noise profile through the learn parameter, as a user would. The
+// change that stops learning goes with the next callback
+static bool learn_noise(Session *session) {
+  const clap_id learn = find_param(session->plugin, "Learn Noise Profile");
+  if (learn == CLAP_INVALID_ID) {
+    return false;
+  }
+
+  session->pending_param = learn;
+  session->pending_value = 1.0;
+  run(session, LEARN_SECONDS, 512U, NULL, NULL);
+
+  session->pending_param = learn;
+  session->pending_value = 0.0;
+  return true;
+}
+
+static void print_block_size(const uint32_t block_size) {
+  if (block_size == IRREGULAR_BLOCKS) {
+    printf("%9s", "irregular");
+  } else {
+    printf("%9u", block_size);
+  }
+}
+
+int main(void) {
+  const clap_plugin_factory_t *factory = &s_plugin_factory;
+  const uint32_t plugin_count = factory->get_plugin_count(factory);
+  const uint32_t sample_rate_count =
+      (uint32_t)(sizeof(sample_rates) / sizeof(sample_rates[0]));
+  const uint32_t block_size_count =
+      (uint32_t)(sizeof(block_sizes) / sizeof(block_sizes[0]));
+  const uint32_t density_count =
+      (uint32_t)(sizeof(event_densities) / sizeof(event_densities[0]));
+
+  static Session session;
+
+  printf("%-8s %8s %-24s %9s %-11s %9s %12s %12s %9s %9s\n", "layout",
+         "rate", "mode", "block", "events", "callbacks", "mean ns",
+         "worst ns", "mean %", "worst %");
+
+  for (uint32_t plugin_index = 0U; plugin_index < plugin_count;
+       plugin_index++) {
+    const clap_plugin_descriptor_t *descriptor =
+        factory->get_plugin_descriptor(factory, plugin_index);
+    const uint32_t mode_count = count_latency_modes(factory, descriptor->id);
+    if (mode_count == 0U) {
+      fprintf(stderr, "no latency modes on %s\n", descriptor->id);
+      return 1;
+    }
+
+    for (uint32_t r = 0U; r < sample_rate_count; r++) {
+      for (uint32_t mode = 0U; mode < mode_count; mode++) {
+        const clap_plugin_t *plugin =
+            factory->create_plugin(factory, &host, descriptor->id);
+        char mode_name[CLAP_NAME_SIZE];
+        if (!plugin || !plugin->init(plugin) ||
+            !set_latency_mode(plugin, mode, mode_name, sizeof(mode_name))) {
+          fprintf(stderr, "failed to create %s\n", descriptor->id);
+          return 1;
+        }
+
+        const clap_plugin_audio_ports_t *ports =
+            plugin->get_extension(plugin, CLAP_EXT_AUDIO_PORTS);
+        clap_audio_port_info_t port_info;
+        if (!ports || !ports->get(plugin, 0U, true, &port_info) ||
+            port_info.channel_count > MAX_CHANNELS) {
+          fprintf(stderr, "unexpected audio ports on %s\n", descriptor->id);
+          return 1;
+        }
+
+        if (!plugin->activate(plugin, sample_rates[r], 1U, MAX_BLOCK_SIZE) ||
+            !plugin->start_processing(plugin)) {
+          fprintf(stderr, "failed to activate %s\n", descriptor->id);
+          return 1;
+        }
+
+        memset(&session, 0, sizeof(session));
+        session.plugin = plugin;
+        session.channel_count = port_info.channel_count;
+        session.sample_rate = sample_rates[r];
+        session.seed = 1U;
+        session.pending_param = CLAP_INVALID_ID;
+        find_automated_params(plugin);
+        if (!learn_noise(&session)) {
+          fprintf(stderr, "failed to learn the noise on %s\n", descriptor->id);
+          return 1;
+        }
+
+        for (uint32_t b = 0U; b < block_size_count; b++) {
+          for (uint32_t d = 0U; d < density_count; d++) {
+            CallbackStats stats = {0};
+            run(&session, WARMUP_SECONDS, block_sizes[b], &event_densities[d],
+                NULL);
+            // Every combination gets the same irregular block sizes
+            session.block_seed = 1U;
+            run(&session, MEASURED_SECONDS, block_sizes[b], &event_densities[d],
+                &stats);
+
+            const double mean_ns = stats.total_ns / (double)stats.callbacks;
+            const double mean_budget_fraction =
+                stats.total_ns / (stats.audio_seconds * 1e9);
+
+            printf("%-8s %8.0f %-24s ",
+                   session.channel_count == 1U ? "mono" : "stereo",
+                   sample_rates[r], mode_name);
+            print_block_size(block_sizes[b]);
+            printf(" %-11s %9u %12.0f %12.0f %8.2f%% %8.2f%%\n",
+                   event_densities[d].name, stats.callbacks, mean_ns,
+                   stats.worst_ns, 100.0 * mean_budget_fraction,
+                   100.0 * stats.worst_budget_fraction);
+          }
+        }
+
+        plugin->stop_processing(plugin);
+        plugin->deactivate(plugin);
+        plugin->destroy(plugin);
+      }
+    }
+  }
+
+  return 0;
+}
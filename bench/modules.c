@@ -0,0 +1,427 @@
+// Copyright 2025 Sam Windell
+// SPDX-License-Identifier: LGPL-3.0
+//
+// Times each processing module on its own, and the whole of
+// specbleach_process, at the sample rates sessions run at. Every module runs
+// a number of frames to warm up before the frames that are timed, and each of
+// those is timed on its own so the percentiles show the spread and not only
+// the average. Results go to stdout as JSON, to keep and compare between
+// releases: the time per frame, the time per sample of audio and the
+// real-time factor, all for a single channel.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/shared/configurations.h"
+#include "../src/shared/gain_estimation/gain_estimators.h"
+#include "../src/shared/noise_estimation/noise_estimator.h"
+#include "../src/shared/post_estimation/postfilter.h"
+#include "../src/shared/pre_estimation/noise_scaling_criterias.h"
+#include "../src/shared/stft/fft_transform.h"
+#include "../src/shared/utils/arena.h"
+#include "../src/shared/utils/denoise_mixer.h"
+#include "../src/shared/utils/dsp_tables.h"
+#include "../src/shared/utils/scratch_pool.h"
+#include "../src/shared/utils/spectral_features.h"
+#include "../src/shared/utils/spectral_kernels.h"
+#include "bench_utils.h"
+#include "specbleach_denoiser.h"
+
+#define FRAME_SIZE_MS 46.F
+#define WARMUP_FRAMES 32U
+#define MEASURED_FRAMES 256U
+#define SIGNAL_FRAMES 16U
+
+static const uint32_t sample_rates[] = {44100, 48000, 96000, 192000};
+
+static const char *kernel_isa_names[] = {"auto", "scalar", "sse2", "avx2",
+                                         "avx512"};
+
+// Everything the modules need for one sample rate. The signal frames cycle so
+// modules whose cost depends on the content don't see the same frame over and
+// over
+typedef struct BenchContext {
+  uint32_t sample_rate;
+  uint32_t hop;
+  uint32_t fft_size;
+  uint32_t real_spectrum_size;
+  uint32_t frame;
+  const SpectralKernels *kernels;
+
+  float *signal[SIGNAL_FRAMES];
+  float *fft_spectrum[SIGNAL_FRAMES];
+  float *power_spectrum[SIGNAL_FRAMES];
+  float *noise_spectrum;
+  float *alpha;
+  float *beta;
+  float *gains;
+  float *work_spectrum;
+  float *work_noise;
+  float *work_gains;
+  float *output;
+
+  FftTransform *fft;
+  SpectralFeatures *features;
+  NoiseScalingCriterias *scaling;
+  PostFilter *postfilter;
+  DenoiseMixer *mixer;
+  NoiseProfile *noise_profile;
+  NoiseEstimator *noise_estimator;
+  SpectralBleachHandle denoiser;
+} BenchContext;
+
+typedef struct ModuleBench {
+  const char *name;
+  // Untimed, puts back whatever the previous frame changed
+  void (*prepare)(BenchContext *context);
+  void (*run)(BenchContext *context);
+} ModuleBench;
+
+static uint32_t current_frame(const BenchContext *context) {
+  return context->frame % SIGNAL_FRAMES;
+}
+
+static void prepare_nothing(BenchContext *context) { (void)context; }
+
+static void prepare_gains(BenchContext *context) {
+  memcpy(context->work_noise, context->noise_spectrum,
+         context->real_spectrum_size * sizeof(float));
+}
+
+static void prepare_postfilter(BenchContext *context) {
+  memcpy(context->work_gains, context->gains,
+         context->fft_size * sizeof(float));
+}
+
+static void prepare_mixer(BenchContext *context) {
+  memcpy(context->work_spectrum, context->fft_spectrum[current_frame(context)],
+         context->fft_size * sizeof(float));
+}
+
+static void prepare_learning(BenchContext *context) {
+  memcpy(context->work_spectrum,
+         context->power_spectrum[current_frame(context)],
+         context->real_spectrum_size * sizeof(float));
+}
+
+static void prepare_process(BenchContext *context) {
+  uint32_t seed = context->frame + 1U;
+  for (uint32_t k = 0U; k < context->hop; k++) {
+    context->work_spectrum[k] = 0.1F * white_noise(&seed);
+  }
+}
+
+static void run_fft_round_trip(BenchContext *context) {
+  fft_load_input_samples(context->fft, context->signal[current_frame(context)]);
+  compute_forward_fft(context->fft);
+  compute_backward_fft(context->fft);
+  fft_get_output_samples(context->fft, context->output);
+}
+
+static void run_spectral_feature(BenchContext *context) {
+  get_spectral_feature(context->features,
+                       context->fft_spectrum[current_frame(context)],
+                       context->fft_size, SPECTRAL_TYPE_GENERAL);
+}
+
+static void run_noise_scaling(BenchContext *context,
+                              const NoiseScalingType type) {
+  const NoiseScalingParameters parameters = {
+      .oversubtraction = DEFAULT_OVERSUBTRACTION + 1.26F,
+      .undersubtraction = DEFAULT_UNDERSUBTRACTION,
+      .scaling_type = (int)type,
+  };
+  apply_noise_scaling_criteria(
+      context->scaling, context->power_spectrum[current_frame(context)],
+      context->noise_spectrum, context->alpha, context->beta, parameters);
+}
+
+static void run_a_posteriori_snr(BenchContext *context) {
+  run_noise_scaling(context, A_POSTERIORI_SNR);
+}
+
+static void run_a_posteriori_snr_critical_bands(BenchContext *context) {
+  run_noise_scaling(context, A_POSTERIORI_SNR_CRITICAL_BANDS);
+}
+
+static void run_masking_thresholds(BenchContext *context) {
+  run_noise_scaling(context, MASKING_THRESHOLDS);
+}
+
+static void run_gains(BenchContext *context, const GainEstimationType type) {
+  estimate_gains(context->kernels, context->real_spectrum_size,
+                 context->fft_size,
+                 context->power_spectrum[current_frame(context)],
+                 context->work_noise, context->work_gains, context->alpha,
+                 context->beta, type);
+}
+
+static void run_wiener(BenchContext *context) { run_gains(context, WIENER); }
+
+static void run_gates(BenchContext *context) { run_gains(context, GATES); }
+
+static void run_generalized_spectral_subtraction(BenchContext *context) {
+  run_gains(context, GENERALIZED_SPECTRALSUBTRACION);
+}
+
+static void run_postfilter(BenchContext *context) {
+  const PostFiltersParameters parameters = {.snr_threshold = 1.F};
+  postfilter_apply(context->postfilter,
+                   context->fft_spectrum[current_frame(context)],
+                   context->work_gains, parameters);
+}
+
+static void run_mixer(BenchContext *context) {
+  const DenoiseMixerParameters parameters = {
+      .noise_level = 0.1F,
+      .residual_listen = false,
+      .whitening_amount = 0.5F,
+  };
+  denoise_mixer_run(context->mixer, context->work_spectrum, context->gains,
+                    parameters);
+}
+
+static void run_median_learning(BenchContext *context) {
+  noise_estimation_run(context->noise_estimator, MEDIAN,
+                       context->work_spectrum);
+}
+
+// One hop of input is one frame on average
+static void run_process(BenchContext *context) {
+  specbleach_process(context->denoiser, context->hop, context->work_spectrum,
+                     context->output);
+}
+
+static const ModuleBench module_benches[] = {
+    {"fft_round_trip", prepare_nothing, run_fft_round_trip},
+    {"get_spectral_feature", prepare_nothing, run_spectral_feature},
+    {"noise_scaling_a_posteriori_snr", prepare_nothing, run_a_posteriori_snr},
+    {"noise_scaling_a_posteriori_snr_critical_bands", prepare_nothing,
+     run_a_posteriori_snr_critical_bands},
+    {"noise_scaling_masking_thresholds", prepare_nothing,
+     run_masking_thresholds},
+    {"estimate_gains_wiener", prepare_gains, run_wiener},
+    {"estimate_gains_gates", prepare_gains, run_gates},
+    {"estimate_gains_generalized_spectral_subtraction", prepare_gains,
+     run_generalized_spectral_subtraction},
+    {"postfilter_apply", prepare_postfilter, run_postfilter},
+    {"denoise_mixer_run", prepare_mixer, run_mixer},
+    {"median_learning", prepare_learning, run_median_learning},
+    {"specbleach_process", prepare_process, run_process},
+};
+
+static float *allocate_spectrum(Arena *arena, const uint32_t size) {
+  return (float *)arena_calloc(arena, size, sizeof(float));
+}
+
+static bool initialize_context(BenchContext *context, Arena *arena,
+                               const uint32_t sample_rate) {
+  DspTables *tables = dsp_tables_initialize(arena);
+  if (!tables) {
+    return false;
+  }
+
+  const uint32_t frame_size =
+      (uint32_t)((FRAME_SIZE_MS / 1000.F) * (float)sample_rate);
+  context->sample_rate = sample_rate;
+  context->hop = frame_size / OVERLAP_FACTOR_GENERAL;
+  context->kernels = get_spectral_kernels(resolve_kernel_isa(KERNEL_ISA_AUTO));
+  context->fft = fft_transform_initialize(
+      arena, tables, context->hop * OVERLAP_FACTOR_GENERAL,
+      PADDING_CONFIGURATION_GENERAL, ZEROPADDING_AMOUNT_GENERAL);
+  if (!context->fft) {
+    return false;
+  }
+  context->fft_size = get_fft_size(context->fft);
+  context->real_spectrum_size = get_fft_real_spectrum_size(context->fft);
+
+  const uint32_t fft_size = context->fft_size;
+  const uint32_t real_spectrum_size = context->real_spectrum_size;
+  ScratchPool *scratch = scratch_pool_initialize(arena, fft_size);
+  context->features = spectral_features_initialize(arena, real_spectrum_size);
+  context->scaling = noise_scaling_criterias_initialize(
+      arena, tables, scratch, fft_size, CRITICAL_BANDS_TYPE, sample_rate,
+      SPECTRAL_TYPE_GENERAL);
+  context->postfilter = postfilter_initialize(
+      arena, tables, scratch, context->kernels, fft_size, POSTFILTER_SCALE);
+  context->mixer = denoise_mixer_initialize(
+      arena, scratch, context->kernels, fft_size, sample_rate, context->hop);
+  context->noise_profile = noise_profile_initialize(arena, real_spectrum_size);
+  context->noise_estimator = noise_estimation_initialize(
+      arena, context->kernels, fft_size, NUMBER_OF_MEDIAN_SPECTRUM,
+      context->noise_profile);
+  if (!scratch || !context->features || !context->scaling ||
+      !context->postfilter || !context->mixer || !context->noise_estimator ||
+      !noise_scaling_criterias_prepare_masking(context->scaling, arena,
+                                               tables)) {
+    return false;
+  }
+
+  context->noise_spectrum = allocate_spectrum(arena, real_spectrum_size);
+  context->alpha = allocate_spectrum(arena, real_spectrum_size);
+  context->beta = allocate_spectrum(arena, real_spectrum_size);
+  context->gains = allocate_spectrum(arena, fft_size);
+  context->work_spectrum = allocate_spectrum(arena, fft_size);
+  context->work_noise = allocate_spectrum(arena, real_spectrum_size);
+  context->work_gains = allocate_spectrum(arena, fft_size);
+  context->output = allocate_spectrum(arena, fft_size);
+
+  // Noise with a tone that comes and goes, and the spectra of it the modules
+  // take as input
+  uint32_t seed = 1U;
+  for (uint32_t frame = 0U; frame < SIGNAL_FRAMES; frame++) {
+    context->signal[frame] = allocate_spectrum(arena, fft_size);
+    context->fft_spectrum[frame] = allocate_spectrum(arena, fft_size);
+    context->power_spectrum[frame] =
+        allocate_spectrum(arena, real_spectrum_size);
+
+    for (uint32_t k = 0U; k < context->hop * OVERLAP_FACTOR_GENERAL; k++) {
+      const float tone = (frame % 2U == 0U) ? 0.3F : 0.F;
+      context->signal[frame][k] =
+          0.1F * white_noise(&seed) +
+          tone * (float)((k / (sample_rate / 880U)) % 2U) - tone * 0.5F;
+    }
+
+    fft_load_input_samples(context->fft, context->signal[frame]);
+    compute_forward_fft(context->fft);
+    memcpy(context->fft_spectrum[frame], get_fft_output_buffer(context->fft),
+           fft_size * sizeof(float));
+    memcpy(context->power_spectrum[frame],
+           get_spectral_feature(context->features, context->fft_spectrum[frame],
+                                fft_size, SPECTRAL_TYPE_GENERAL),
+           real_spectrum_size * sizeof(float));
+  }
+
+  // A noise profile at the level of the noise alone, and the gains a Wiener
+  // filter gets from it
+  for (uint32_t k = 0U; k < real_spectrum_size; k++) {
+    context->noise_spectrum[k] = context->power_spectrum[1][k];
+    context->alpha[k] = 1.F;
+  }
+  memcpy(context->work_noise, context->noise_spectrum,
+         real_spectrum_size * sizeof(float));
+  estimate_gains(context->kernels, real_spectrum_size, fft_size,
+                 context->power_spectrum[0], context->work_noise,
+                 context->gains, context->alpha, context->beta, WIENER);
+
+  // The whole library, as the default configuration runs it, with noise
+  // already learned
+  const SpectralBleachConfig config =
+      specbleach_get_default_config(sample_rate, FRAME_SIZE_MS);
+  context->denoiser = specbleach_initialize_with_config(&config);
+  if (!context->denoiser) {
+    return false;
+  }
+
+  SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 20.F,
+      .smoothing_factor = 50.F,
+      .transient_protection = true,
+      .whitening_factor = 50.F,
+      .noise_scaling_type = 2,
+      .noise_rescale = 2.F,
+      .post_filter_threshold = 0.F,
+  };
+  specbleach_load_parameters(context->denoiser, parameters);
+  for (uint32_t frame = 0U; frame < SIGNAL_FRAMES; frame++) {
+    prepare_process(context);
+    run_process(context);
+    context->frame++;
+  }
+  parameters.learn_noise = 0;
+  specbleach_load_parameters(context->denoiser, parameters);
+  context->frame = 0U;
+
+  return true;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  const double first = *(const double *)a;
+  const double second = *(const double *)b;
+  return (first > second) - (first < second);
+}
+
+// Nearest rank percentile of sorted times
+static double percentile(const double *sorted, const double fraction) {
+  uint32_t rank = (uint32_t)(fraction * (double)MEASURED_FRAMES + 0.999999);
+  rank = rank == 0U ? 1U : rank;
+  return sorted[rank - 1U];
+}
+
+static void run_module_bench(BenchContext *context, const ModuleBench *bench,
+                             const bool last) {
+  static double times[MEASURED_FRAMES];
+
+  context->frame = 0U;
+  for (uint32_t frame = 0U; frame < WARMUP_FRAMES + MEASURED_FRAMES;
+       frame++) {
+    bench->prepare(context);
+    const double start = now_ns();
+    bench->run(context);
+    const double elapsed = now_ns() - start;
+    if (frame >= WARMUP_FRAMES) {
+      times[frame - WARMUP_FRAMES] = elapsed;
+    }
+    context->frame++;
+  }
+
+  double mean = 0.0;
+  for (uint32_t k = 0U; k < MEASURED_FRAMES; k++) {
+    mean += times[k] / (double)MEASURED_FRAMES;
+  }
+  qsort(times, MEASURED_FRAMES, sizeof(double), compare_doubles);
+
+  const double frame_ns = 1e9 * (double)context->hop /
+                          (double)context->sample_rate;
+  printf("        {\"module\": \"%s\", \"ns_per_frame\": {\"mean\": %.1f, "
+         "\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f}, "
+         "\"ns_per_sample\": %.3f, \"real_time_factor\": %.6f}%s\n",
+         bench->name, mean, percentile(times, 0.5), percentile(times, 0.9),
+         percentile(times, 0.99), times[MEASURED_FRAMES - 1U],
+         mean / (double)context->hop, mean / frame_ns, last ? "" : ",");
+}
+
+int main(void) {
+  const uint32_t sample_rate_count =
+      (uint32_t)(sizeof(sample_rates) / sizeof(sample_rates[0]));
+  const uint32_t module_count =
+      (uint32_t)(sizeof(module_benches) / sizeof(module_benches[0]));
+
+  printf("{\n  \"kernel_isa\": \"%s\",\n  \"frame_size_ms\": %.1f,\n"
+         "  \"warmup_frames\": %u,\n  \"measured_frames\": %u,\n"
+         "  \"sample_rates\": [\n",
+         kernel_isa_names[resolve_kernel_isa(KERNEL_ISA_AUTO)],
+         (double)FRAME_SIZE_MS, WARMUP_FRAMES, MEASURED_FRAMES);
+
+  for (uint32_t r = 0U; r < sample_rate_count; r++) {
+    Arena arena;
+    arena_initialize(&arena);
+    BenchContext context = {0};
+    if (!initialize_context(&context, &arena, sample_rates[r])) {
+      fprintf(stderr, "failed to initialize the modules at %u Hz\n",
+              sample_rates[r]);
+      if (context.denoiser) {
+        specbleach_free(context.denoiser);
+      }
+      arena_release(&arena);
+      return 1;
+    }
+
+    printf("    {\"sample_rate\": %u, \"fft_size\": %u, \"hop\": %u, "
+           "\"modules\": [\n",
+           context.sample_rate, context.fft_size, context.hop);
+    for (uint32_t m = 0U; m < module_count; m++) {
+      run_module_bench(&context, &module_benches[m], m + 1U == module_count);
+    }
+    printf("    ]}%s\n", r + 1U == sample_rate_count ? "" : ",");
+
+    specbleach_free(context.denoiser);
+    arena_release(&arena);
+  }
+
+  printf("  ]\n}\n");
+  return 0;
+}
@@ -0,0 +1,116 @@
+// Copyright 2025 Sam Windell
+// SPDX-License-Identifier: LGPL-3.0
+//
+// Measures the per-channel real-time factor of each processing preset: the
+// time it takes to denoise a second of audio divided by that second. A factor
+// of 0.01 means one core can run around 100 channels. The numbers are for the
+// machine the bench runs on, and are what to size sessions with. It also
+// reports the memory footprint of one channel of each preset, which is what
+// an instance allocates for all of its modules. A frame only touches part of
+// it, so it is an upper bound of what has to stay in cache.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_utils.h"
+#include "specbleach_denoiser.h"
+
+#define SAMPLE_RATE 48000U
+#define FRAME_SIZE_MS 46.F
+#define BLOCK_SIZE 512U
+#define LEARN_SECONDS 2.F
+#define MEASURED_SECONDS 20.F
+
+static const char *preset_names[SPECBLEACH_PRESET_COUNT] = {
+    "eco", "standard", "hq"};
+
+// Returns the time spent processing, in nanoseconds
+static double run(SpectralBleachHandle instance, uint32_t *seed,
+                  const float seconds, const bool with_signal) {
+  float input[BLOCK_SIZE];
+  float output[BLOCK_SIZE];
+  float previous = 0.F;
+  double elapsed_ns = 0.0;
+
+  const uint32_t total = (uint32_t)(seconds * (float)SAMPLE_RATE);
+  for (uint32_t done = 0U; done < total; done += BLOCK_SIZE) {
+    for (uint32_t k = 0U; k < BLOCK_SIZE; ++k) {
+      float sample = 0.1F * white_noise(seed);
+      if (with_signal) {
+        // Low passed noise bursts so there is something to keep
+        previous = 0.95F * previous + 0.05F * white_noise(seed);
+        sample += ((done / SAMPLE_RATE) % 2U == 0U) ? 4.F * previous : 0.F;
+      }
+      input[k] = sample;
+    }
+
+    const double start = now_ns();
+    specbleach_process(instance, BLOCK_SIZE, input, output);
+    elapsed_ns += now_ns() - start;
+  }
+
+  return elapsed_ns;
+}
+
+int main(void) {
+  SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 20.F,
+      .smoothing_factor = 50.F,
+      .transient_protection = true,
+      .whitening_factor = 50.F,
+      .noise_scaling_type = 2,
+      .noise_rescale = 2.F,
+      .post_filter_threshold = 0.F,
+  };
+
+  double real_time_factor[SPECBLEACH_PRESET_COUNT];
+
+  for (int preset = 0; preset < SPECBLEACH_PRESET_COUNT; ++preset) {
+    SpectralBleachHandle instance = specbleach_initialize_with_preset(
+        SAMPLE_RATE, FRAME_SIZE_MS, (SpectralBleachPreset)preset);
+    if (!instance) {
+      fprintf(stderr, "failed to initialize the %s preset\n",
+              preset_names[preset]);
+      return 1;
+    }
+
+    uint32_t seed = 1U;
+    parameters.learn_noise = 1;
+    specbleach_load_parameters(instance, parameters);
+    run(instance, &seed, LEARN_SECONDS, false);
+
+    parameters.learn_noise = 0;
+    specbleach_load_parameters(instance, parameters);
+    const double elapsed_ns = run(instance, &seed, MEASURED_SECONDS, true);
+
+    real_time_factor[preset] = elapsed_ns / ((double)MEASURED_SECONDS * 1e9);
+    printf("%-9s real-time factor %.5f per channel (%.0f channels per core)\n",
+           preset_names[preset], real_time_factor[preset],
+           1.0 / real_time_factor[preset]);
+
+    const SpectralBleachConfig config = specbleach_get_preset_config(
+        (SpectralBleachPreset)preset, SAMPLE_RATE, FRAME_SIZE_MS);
+    printf("%-9s %zu bytes of instance footprint per channel\n",
+           preset_names[preset],
+           specbleach_get_memory_requirements_with_config(&config));
+
+    specbleach_free(instance);
+  }
+
+  const double standard = real_time_factor[SPECBLEACH_PRESET_STANDARD];
+  printf("eco/standard cost: %.2f\n",
+         real_time_factor[SPECBLEACH_PRESET_ECO] / standard);
+  printf("hq/standard cost: %.2f\n",
+         real_time_factor[SPECBLEACH_PRESET_HQ] / standard);
+
+  if (real_time_factor[SPECBLEACH_PRESET_ECO] >= standard ||
+      real_time_factor[SPECBLEACH_PRESET_HQ] <= standard) {
+    printf("FAIL: presets are not ordered by cost\n");
+    return 1;
+  }
+
+  printf("OK: presets are ordered by cost\n");
+  return 0;
+}
@@ -48,14 +48,27 @@ fn addNoiseReductionLibrary(b: *std.Build, compile_config: *const CompileConfig)
             "src/shared/stft/stft_buffer.c",
             "src/shared/stft/stft_processor.c",
             "src/shared/stft/stft_windows.c",
+            "src/shared/utils/arena.c",
             "src/shared/utils/denoise_mixer.c",
+            "src/shared/utils/denormals.c",
+            "src/shared/utils/dsp_tables.c",
             "src/shared/utils/general_utils.c",
+            "src/shared/utils/scratch_pool.c",
             "src/shared/utils/spectral_features.c",
             "src/shared/utils/spectral_trailing_buffer.c",
             "src/shared/utils/spectral_utils.c",
         },
         .flags = compile_config.flags,
     });
+    // Every kernel variant has to round each product and sum on its own to
+    // give the same output
+    lib.addCSourceFile(.{
+        .file = b.path("src/shared/utils/spectral_kernels.c"),
+        .flags = std.mem.concat(b.allocator, []const u8, &.{
+            compile_config.flags,
+            &.{"-ffp-contract=off"},
+        }) catch @panic("OOM"),
+    });
     lib.addCSourceFile(.{
         .file = pffft.path("pffft.c"),
         .flags = compile_config.flags,
@@ -86,14 +99,116 @@ fn addUnitTests(b: *std.Build, compile_config: *const CompileConfig, test_step:
     const run_tests = b.addRunArtifact(tests);
     test_step.dependOn(&run_tests.step);
 
+    const regression_tests = b.addExecutable(.{
+        .name = "regression-tests",
+        .target = compile_config.target,
+        .optimize = compile_config.optimize,
+    });
+    regression_tests.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "plugin/regression_tests.c",
+        },
+        // The test signals are generated the same way on every platform
+        .flags = std.mem.concat(b.allocator, []const u8, &.{
+            compile_config.flags,
+            &.{"-ffp-contract=off"},
+        }) catch @panic("OOM"),
+    });
+    regression_tests.linkLibC();
+    regression_tests.linkLibrary(plugin_static);
+    regression_tests.addIncludePath(b.path("include"));
+    const run_regression_tests = b.addRunArtifact(regression_tests);
+    test_step.dependOn(&run_regression_tests.step);
+
     if (builtin.os.tag == plugin_static.rootModuleTarget().os.tag and
         builtin.cpu.arch == plugin_static.rootModuleTarget().cpu.arch)
     {
         const install_artifact = b.addInstallArtifact(tests, .{});
         b.default_step.dependOn(&install_artifact.step);
+        const install_regression_tests =
+            b.addInstallArtifact(regression_tests, .{});
+        b.default_step.dependOn(&install_regression_tests.step);
     }
 }
 
+fn addBenchmarks(b: *std.Build, compile_config: *const CompileConfig, bench_step: *std.Build.Step, plugin_static: *std.Build.Step.Compile) void {
+    const fade_to_silence = b.addExecutable(.{
+        .name = "fade-to-silence-bench",
+        .target = compile_config.target,
+        .optimize = compile_config.optimize,
+    });
+    fade_to_silence.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "bench/fade_to_silence.c",
+        },
+        .flags = compile_config.flags,
+    });
+    fade_to_silence.linkLibC();
+    fade_to_silence.linkLibrary(plugin_static);
+    fade_to_silence.addIncludePath(b.path("include"));
+    const run_fade_to_silence = b.addRunArtifact(fade_to_silence);
+    bench_step.dependOn(&run_fade_to_silence.step);
+
+    const presets = b.addExecutable(.{
+        .name = "presets-bench",
+        .target = compile_config.target,
+        .optimize = compile_config.optimize,
+    });
+    presets.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "bench/presets.c",
+        },
+        .flags = compile_config.flags,
+    });
+    presets.linkLibC();
+    presets.linkLibrary(plugin_static);
+    presets.addIncludePath(b.path("include"));
+    const run_presets = b.addRunArtifact(presets);
+    bench_step.dependOn(&run_presets.step);
+
+    const modules = b.addExecutable(.{
+        .name = "modules-bench",
+        .target = compile_config.target,
+        .optimize = compile_config.optimize,
+    });
+    modules.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "bench/modules.c",
+        },
+        .flags = compile_config.flags,
+    });
+    modules.linkLibC();
+    modules.linkLibrary(plugin_static);
+    modules.addIncludePath(b.path("include"));
+    const run_modules = b.addRunArtifact(modules);
+    // Timings differ on every run, so it always runs and the JSON it prints
+    // is kept at zig-out/bench/modules.json
+    run_modules.has_side_effects = true;
+    const install_modules_json = b.addInstallFileWithDir(
+        run_modules.captureStdOut(),
+        .prefix,
+        "bench/modules.json",
+    );
+    bench_step.dependOn(&install_modules_json.step);
+
+    const host = b.addExecutable(.{
+        .name = "host-bench",
+        .target = compile_config.target,
+        .optimize = compile_config.optimize,
+    });
+    host.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "bench/host.c",
+        },
+        .flags = compile_config.flags,
+    });
+    host.linkLibC();
+    host.linkLibrary(plugin_static);
+    host.addIncludePath(compile_config.clap_inlude_path);
+    const run_host = b.addRunArtifact(host);
+    bench_step.dependOn(&run_host.step);
+}
+
 fn getLatestVersion(b: *std.Build) []const u8 {
     var version_str: []const u8 = b.run(&.{ "git", "describe", "--tags", "--abbrev=0" });
     version_str = std.mem.trimRight(u8, version_str, " \n\r\t");
@@ -136,6 +251,7 @@ fn addPluginStatic(b: *std.Build, compile_config: *const CompileConfig) *std.Bui
         .files = &[_][]const u8{
             "plugin/clap_plugin.c",
             "plugin/signal_crossfade.c",
+            "plugin/signal_delay.c",
         },
         .flags = compile_config.flags,
     });
@@ -183,6 +299,9 @@ pub fn build(b: *std.Build) void {
     const test_step = b.step("test", "build and run tests");
     addUnitTests(b, &compile_config, test_step, plugin_static);
     addClapValidatorIfNeeded(b, test_step, install_step);
+
+    const bench_step = b.step("bench", "build and run benchmarks");
+    addBenchmarks(b, &compile_config, bench_step, plugin_static);
 }
 
 fn addClapValidatorIfNeeded(b: *std.Build, test_step: *std.Build.Step, install_step: *PluginInstallStep) void {
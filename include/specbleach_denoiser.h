@@ -26,6 +26,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 typedef void *SpectralBleachHandle;
@@ -83,6 +84,113 @@ typedef struct SpectralBleachParameters {
   float post_filter_threshold;
 } SpectralBleachParameters;
 
+/* Identifies a single field of SpectralBleachParameters so it can be changed
+ * on its own with specbleach_set_parameter */
+typedef enum SpectralBleachParameterId {
+  SPECBLEACH_PARAMETER_LEARN_NOISE = 0,
+  SPECBLEACH_PARAMETER_RESIDUAL_LISTEN = 1,
+  SPECBLEACH_PARAMETER_REDUCTION_AMOUNT = 2,
+  SPECBLEACH_PARAMETER_SMOOTHING_FACTOR = 3,
+  SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION = 4,
+  SPECBLEACH_PARAMETER_WHITENING_FACTOR = 5,
+  SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE = 6,
+  SPECBLEACH_PARAMETER_NOISE_RESCALE = 7,
+  SPECBLEACH_PARAMETER_POST_FILTER_THRESHOLD = 8,
+  SPECBLEACH_PARAMETER_COUNT = 9,
+} SpectralBleachParameterId;
+
+/* Trades CPU for quality. Each preset sets the overlap, the fft size and
+ * which noise scalings are available. Eco analyses half as many frames per
+ * second as standard and hq twice as many, each with a larger fft. The
+ * presets bench prints the per channel real-time factor of each one on the
+ * machine it runs on */
+typedef enum SpectralBleachPreset {
+  /* Overlap of 2, the smallest fft that fits the frame and only a-posteriori
+   * snr scaling, whatever noise_scaling_type is set to */
+  SPECBLEACH_PRESET_ECO = 0,
+  /* Overlap of 4 and the next power of two fft. What specbleach_initialize
+   * uses */
+  SPECBLEACH_PRESET_STANDARD = 1,
+  /* Overlap of 8 and an fft of at least twice the frame size */
+  SPECBLEACH_PRESET_HQ = 2,
+  SPECBLEACH_PRESET_COUNT = 3,
+} SpectralBleachPreset;
+
+/* Instruction sets the per bin loops can run with. Every build has all the
+ * ones of its architecture and each instance picks one when it is built, so
+ * a build for a generic target still uses the widest vectors the machine
+ * has. They all give the same output */
+typedef enum SpectralBleachKernelIsa {
+  /* The SPECBLEACH_KERNEL_ISA environment variable if it is set to scalar,
+   * sse2, avx2 or avx512, or the widest the machine supports otherwise */
+  SPECBLEACH_KERNEL_ISA_AUTO = 0,
+  SPECBLEACH_KERNEL_ISA_SCALAR = 1,
+  SPECBLEACH_KERNEL_ISA_SSE2 = 2,
+  SPECBLEACH_KERNEL_ISA_AVX2 = 3,
+  SPECBLEACH_KERNEL_ISA_AVX512 = 4,
+} SpectralBleachKernelIsa;
+
+/* Bumped every time fields are added to SpectralBleachConfig. Configs with a
+ * version this library doesn't know are rejected */
+#define SPECBLEACH_CONFIG_VERSION 3
+
+/* Everything that is fixed for the lifetime of an instance. Start from
+ * specbleach_get_default_config or specbleach_get_preset_config and change
+ * only the fields that are needed */
+typedef struct SpectralBleachConfig {
+  /* Has to be SPECBLEACH_CONFIG_VERSION or an older one */
+  uint32_t version;
+  uint32_t sample_rate;
+  /* In milliseconds */
+  float frame_size;
+  /* At least 2 */
+  uint32_t overlap_factor;
+  /* 0 Hann, 1 Hamming, 2 Blackman and 3 Vorbis */
+  int input_window_type;
+  int output_window_type;
+  /* 0 next power of two, 1 fixed amount and 2 no padding */
+  int padding_type;
+  /* Percentage of the frame size, only used with fixed amount padding */
+  uint32_t zeropadding_amount;
+  /* 0 Bark, 1 Mel, 2 Opus and 3 octave bands */
+  int critical_bands_type;
+  /* 0 Wiener, 1 gates and 2 generalized spectral subtraction */
+  int gain_estimation_type;
+  /* 1 fixed and 2 transient aware */
+  int time_smoothing_type;
+  /* Number of past spectra the adaptive noise estimation takes the median of */
+  uint32_t median_spectrum_count;
+  /* Widest smoothing of the post filter, in bins */
+  float postfilter_scale;
+  /* Only the a-posteriori snr scaling is used, whatever noise_scaling_type is
+   * set to */
+  bool a_posteriori_snr_only;
+  /* Since version 2. One of SpectralBleachKernelIsa, to force a path when
+   * testing. Ones the machine doesn't support fall back to the widest it
+   * does */
+  int kernel_isa;
+  /* Since version 3. The analysis, the gains, the post filter and the
+   * synthesis of each frame are run at different samples of the hop after it
+   * instead of all in the call that completes it, so small buffers don't see
+   * a spike of CPU once every hop. Adds a hop of latency and gives the same
+   * output delayed by it. Parameters set between calls can reach the frame
+   * in flight */
+  bool spread_frames;
+} SpectralBleachConfig;
+
+/**
+ * Returns the configuration specbleach_initialize uses
+ */
+SpectralBleachConfig specbleach_get_default_config(uint32_t sample_rate,
+                                                   float frame_size);
+/**
+ * Returns the configuration of one of the processing presets. An invalid
+ * preset gives a configuration that initializing rejects
+ */
+SpectralBleachConfig specbleach_get_preset_config(SpectralBleachPreset preset,
+                                                  uint32_t sample_rate,
+                                                  float frame_size);
+
 /**
  * Returns a handle to an instance of the library for the adaptive based
  * noise reduction. Sample rate could be anything from 4000hz to 192khz.
@@ -90,16 +198,148 @@ typedef struct SpectralBleachParameters {
  */
 SpectralBleachHandle specbleach_initialize(uint32_t sample_rate,
                                            float frame_size);
+/**
+ * Same as specbleach_initialize but with the number of frames that overlap
+ * each sample, which has to be at least 2. The default is 4. Higher values
+ * cost proportionally more CPU and give smoother reductions with the same
+ * latency, which only depends on the frame size. The frame size is rounded
+ * down to a multiple of 8 samples, which is the latency, and frames are
+ * analysed in the largest multiple of the overlap factor that fits it, so any
+ * overlap reconstructs the input exactly
+ */
+SpectralBleachHandle
+specbleach_initialize_with_overlap(uint32_t sample_rate, float frame_size,
+                                   uint32_t overlap_factor);
+/**
+ * Same as specbleach_initialize but with one of the processing presets. All
+ * of them analyse the same frame, rounded down to a multiple of 8 samples,
+ * so they have the same latency
+ */
+SpectralBleachHandle specbleach_initialize_with_preset(
+    uint32_t sample_rate, float frame_size, SpectralBleachPreset preset);
+/**
+ * Same as specbleach_initialize but with every choice spelled out. Returns
+ * NULL if the configuration isn't valid
+ */
+SpectralBleachHandle
+specbleach_initialize_with_config(const SpectralBleachConfig *config);
+/**
+ * Bytes of memory specbleach_initialize_in_memory needs for an instance.
+ * Every buffer of an instance is carved out of a single 64 byte aligned block
+ * of this size, which is the same for the same configuration. Only the fft
+ * plans are allocated separately. Returns 0 if the configuration isn't valid
+ */
+size_t specbleach_get_memory_requirements(uint32_t sample_rate,
+                                          float frame_size);
+size_t specbleach_get_memory_requirements_with_config(
+    const SpectralBleachConfig *config);
+/**
+ * Same as specbleach_initialize_with_config but the instance is created in
+ * memory the caller owns, which has to stay valid until specbleach_free and
+ * can have any alignment. Returns NULL if memory_size is smaller than the
+ * requirements. These instances can be reset but can't be reconfigured to a
+ * different configuration
+ */
+SpectralBleachHandle
+specbleach_initialize_in_memory(const SpectralBleachConfig *config,
+                                void *memory, size_t memory_size);
+/**
+ * Creates an instance with the same configuration, parameters and prewarmed
+ * modules as the one passed, but none of its processing state or noise
+ * profile. The clone reads the same windows, fft plans and band tables as the
+ * source instead of computing its own, so each extra channel only costs its
+ * processing state. Instances sharing tables can process and load parameters
+ * from different threads, but have to be created, reconfigured, prewarmed and
+ * freed from one thread at a time. Clones of instances in caller memory get
+ * tables of their own.
+ * Returns NULL on failure
+ */
+SpectralBleachHandle specbleach_clone(SpectralBleachHandle instance);
 /**
  * Free instance associated to the handle passed
  */
 void specbleach_free(SpectralBleachHandle instance);
+/**
+ * Clears all the audio the instance has buffered, as if it had just been
+ * initialized. Parameters and the noise profile are kept. It doesn't allocate
+ */
+void specbleach_reset(SpectralBleachHandle instance);
+/**
+ * Sets the instance up for a new sample rate and frame size keeping its
+ * parameters and noise profile, which gets resampled if its size changes.
+ * When neither changed this is the same as specbleach_reset and nothing is
+ * allocated. If the new configuration can't be created the instance is left
+ * as it was and false is returned
+ */
+bool specbleach_reconfigure(SpectralBleachHandle instance,
+                            uint32_t sample_rate, float frame_size);
+/**
+ * Same as specbleach_reconfigure but also changing the overlap factor, which
+ * specbleach_reconfigure keeps as it was
+ */
+bool specbleach_reconfigure_with_overlap(SpectralBleachHandle instance,
+                                         uint32_t sample_rate, float frame_size,
+                                         uint32_t overlap_factor);
+/**
+ * Same as specbleach_reconfigure but also changing the preset, along with the
+ * overlap factor that comes with it
+ */
+bool specbleach_reconfigure_with_preset(SpectralBleachHandle instance,
+                                        uint32_t sample_rate, float frame_size,
+                                        SpectralBleachPreset preset);
+/**
+ * Same as specbleach_reconfigure but with a whole new configuration
+ */
+bool specbleach_reconfigure_with_config(SpectralBleachHandle instance,
+                                        const SpectralBleachConfig *config);
+/**
+ * Copies the configuration the instance is running with. The version of
+ * config has to be set to the one the caller was built with, usually
+ * SPECBLEACH_CONFIG_VERSION, and only the fields that version has are written
+ */
+bool specbleach_get_config(SpectralBleachHandle instance,
+                           SpectralBleachConfig *config);
 /**
  * Loads the parameters for the reduction.
- * This has to be called before processing
+ * This has to be called before processing. Only the fields that differ from
+ * the previously loaded parameters are converted again. Masking thresholds
+ * scaling and transient protection need modules that are built the first time
+ * they are selected here or with specbleach_set_parameter, which allocates.
+ * Changes queued with specbleach_queue_parameter that are still pending are
+ * dropped
  */
 bool specbleach_load_parameters(SpectralBleachHandle instance,
                                 SpectralBleachParameters parameters);
+/**
+ * Changes a single parameter of the reduction. The value uses the same units
+ * as the matching field of SpectralBleachParameters, with booleans and integer
+ * types passed as 0/1 and whole numbers respectively
+ */
+bool specbleach_set_parameter(SpectralBleachHandle instance,
+                              SpectralBleachParameterId parameter_id,
+                              float value);
+/**
+ * Builds every module the parameters can select ahead of time, so no later
+ * parameter change allocates. Instances in caller memory already have all of
+ * them. The others are rebuilt with all of them in a single block of memory,
+ * which keeps the noise profile and the parameters but restarts the
+ * processing as specbleach_reset does, so prewarm before processing. They
+ * stay prewarmed when they are reconfigured or cloned
+ */
+bool specbleach_prewarm(SpectralBleachHandle instance);
+/**
+ * Queues a change of a single parameter to happen sample_offset samples into
+ * the next call to specbleach_process. It is applied at the first frame that
+ * is processed at or after that sample, so changes can be passed with their
+ * timestamps and still be processed with a single call per buffer. Changes
+ * have to be queued in time order. They never allocate, so changes that
+ * select masking thresholds scaling or turn transient protection on are
+ * rejected, returning false, until their modules are built by loading or
+ * setting them, or by specbleach_prewarm
+ */
+bool specbleach_queue_parameter(SpectralBleachHandle instance,
+                                SpectralBleachParameterId parameter_id,
+                                float value, uint32_t sample_offset);
 /**
  * Process buffer of a number of samples
  */
@@ -110,6 +350,11 @@ bool specbleach_process(SpectralBleachHandle instance,
  * Returns the latency in samples associated with the library instance
  */
 uint32_t specbleach_get_latency(SpectralBleachHandle instance);
+/**
+ * Returns the instruction set the per bin loops of the instance run with
+ */
+SpectralBleachKernelIsa
+specbleach_get_kernel_isa(SpectralBleachHandle instance);
 /**
  * Returns the size of the noise profile spectrum
  */
@@ -125,6 +370,16 @@ bool specbleach_load_noise_profile(SpectralBleachHandle instance,
                                    const float *restored_profile,
                                    uint32_t profile_size,
                                    uint32_t profile_blocks);
+/**
+ * Resamples a noise profile to a different size, such as one captured at
+ * another sample rate, by interpolating between its bins. It doesn't need an
+ * instance, so the conversion can be done ahead of time on another thread and
+ * the result loaded into an instance with a matching size
+ */
+bool specbleach_resample_noise_profile(const float *input_profile,
+                                       uint32_t input_size,
+                                       float *output_profile,
+                                       uint32_t output_size);
 /**
  * Resets the internal noise profile of the library instance
  */
@@ -21,6 +21,7 @@
 #include "config.h"
 #include "debug.h"
 #include "signal_crossfade.h"
+#include "signal_delay.h"
 #include "specbleach_denoiser.h"
 
 static const clap_plugin_descriptor_t s_desc_stereo = {
@@ -65,13 +66,68 @@ enum param_ids {
   pid_ENABLE = 239487,
   pid_NOISE_SCALING_TYPE = 6710386,
   pid_POST_FILTER_THRESHOLD = 18613465,
+  pid_LATENCY_MODE = 8130472,
+  pid_QUALITY = 40918273,
 };
 
-#define PARAMS_COUNT 11
-#define NOISE_PROFILE_MAX_SIZE 9000
+#define PARAMS_COUNT 13
+// In the order of param_get_info()
+static const clap_id s_param_ids[PARAMS_COUNT] = {
+    pid_AMOUNT,
+    pid_OFFSET,
+    pid_SMOOTHING,
+    pid_WHITENING,
+    pid_TRANSIENT_PROTECTION,
+    pid_LEARN_NOISE,
+    pid_RESIDUAL_LISTEN,
+    pid_RESET_PROFILE,
+    pid_ENABLE,
+    pid_NOISE_SCALING_TYPE,
+    pid_POST_FILTER_THRESHOLD,
+    pid_LATENCY_MODE,
+    pid_QUALITY,
+};
+// Only used to reject corrupt state, the storage is sized when activating
+#define NOISE_PROFILE_MAX_SIZE (1u << 20)
+// While learning, the profile is handed to the main thread at most this often
+#define NOISE_PROFILE_PUBLISH_INTERVAL_MS 100
+// Version 1 profiles were learned with the windows spanning the whole fft
+// buffer, see rescale_legacy_noise_profile()
+#define STATE_VERSION 2
+// What version 1 analysed every sample rate with
+#define LEGACY_FRAME_SIZE_MS 46.F
+
+#ifndef M_PI
+#define M_PI 3.1415926535F
+#endif
+
+enum latency_modes {
+  latency_STANDARD,
+  latency_LOW,
+  latency_STEADY_CPU,
+  latency_COUNT,
+};
+
+typedef struct {
+  float frame_size_ms;
+  SpectralBleachPreset preset;
+  bool spread_frames;
+} stft_configuration;
+
+// The latency only depends on the frame size and on spreading the frames.
+// Low latency steps the quality down one preset to afford its shorter hops.
+// Steady CPU keeps the standard frames but spreads the work of each over the
+// hop after it, so small buffers don't get a spike once every hop, for a hop
+// more of latency. Offline renders step the quality up one, so they keep the
+// latency of the mode while costing more CPU.
+static const float s_latency_mode_frame_sizes_ms[latency_COUNT] = {
+    [latency_STANDARD] = 46.f,
+    [latency_LOW] = 10.f,
+    [latency_STEADY_CPU] = 46.f,
+};
 
 typedef struct {
-  float channels[2][NOISE_PROFILE_MAX_SIZE];
+  float *channels[2];
   uint32_t blocks_averaged;
   uint32_t size;
 } noise_profile_state;
@@ -81,17 +137,44 @@ typedef struct {
 
 typedef struct {
   noise_profile_state buffers[3];
+  float *storage;
+  uint32_t capacity; // floats per channel
   _Atomic uint32_t middle_buffer_state; // producer and consumer
   uint32_t back_buffer_index;           // producer
   uint32_t front_buffer_index;          // consumer
 } noise_profile_state_swap_buffers;
 
+// Main-thread, while the audio thread isn't running.
 static void
-init_noise_profile_buffers(noise_profile_state_swap_buffers *buffers) {
-  assert(buffers->buffers[0].channels[0][0] == 0); // Must already be zeroed
+free_noise_profile_buffers(noise_profile_state_swap_buffers *buffers) {
+  free(buffers->storage);
+  memset(buffers, 0, sizeof(*buffers));
+}
+
+// Main-thread, while the audio thread isn't running. Every buffer gets room
+// for a profile of the given size for each channel.
+static bool
+init_noise_profile_buffers(noise_profile_state_swap_buffers *buffers,
+                           uint32_t channel_count, uint32_t capacity) {
+  free_noise_profile_buffers(buffers);
+
+  buffers->storage =
+      calloc((size_t)3 * channel_count * capacity, sizeof(float));
+  if (!buffers->storage) {
+    return false;
+  }
+
+  buffers->capacity = capacity;
+  for (uint32_t i = 0; i < 3; ++i) {
+    for (uint32_t channel = 0; channel < channel_count; ++channel) {
+      buffers->buffers[i].channels[channel] =
+          &buffers->storage[((size_t)i * channel_count + channel) * capacity];
+    }
+  }
   buffers->middle_buffer_state = 1;
   buffers->back_buffer_index = 0;
   buffers->front_buffer_index = 2;
+  return true;
 }
 
 // producer
@@ -124,6 +207,22 @@ bool noise_profile_state_consume(noise_profile_state_swap_buffers *buffers,
   return true;
 }
 
+typedef struct {
+  float amount;
+  float offset;
+  float smoothing;
+  float whitening;
+  bool transient_protection;
+  uint32_t learn_noise;
+  bool residual_listen;
+  bool reset_profile;
+  bool enable;
+  uint32_t noise_scaling_type;
+  float post_filter_threshold;
+  uint32_t latency_mode;
+  uint32_t quality;
+} noiserf_params;
+
 typedef struct {
   clap_plugin_t plugin;
   const clap_host_t *host;
@@ -131,36 +230,101 @@ typedef struct {
   const clap_host_log_t *hostLog;
   const clap_host_thread_check_t *hostThreadCheck;
   const clap_host_params_t *hostParams;
+  const clap_host_thread_pool_t *hostThreadPool;
 
   uint32_t channel_count;
 
-  _Atomic float amount;
-  _Atomic float offset;
-  _Atomic float smoothing;
-  _Atomic float whitening;
-  _Atomic bool transient_protection;
-  _Atomic uint32_t learn_noise;
-  _Atomic bool residual_listen;
-  _Atomic bool reset_profile;
-  _Atomic bool enable;
-  _Atomic uint32_t noise_scaling_type;
-  _Atomic float post_filter_threshold;
+  // The STFT configuration follows the latency mode, the quality and the
+  // render mode. It's only applied when activating, so the host is asked to
+  // restart when any of them changes while active. The active one is only
+  // written while inactive.
+  _Atomic clap_plugin_render_mode render_mode;
+  stft_configuration active_stft; // frame_size_ms is 0 while inactive
+  uint32_t reported_latency;      // main thread
+  uint32_t sample_rate;           // main thread, of the last activation or 0
+
+  // All parameters are published together through a seqlock so that readers
+  // always see a consistent set. The version is odd while a write is in
+  // progress, and it changes every time any parameter is written. Only the
+  // main thread writes it.
+  noiserf_params params;
+  _Atomic uint32_t params_version;
+  // The audio thread's own copy, which events write to directly. It takes a
+  // snapshot of the shared one when that changed, never waiting for a write
+  // in progress, and reloads the instances when that gives other values.
+  noiserf_params audio_params;   // audio thread
+  uint32_t audio_params_version; // audio thread
+  bool audio_params_loaded;      // audio thread, whether the instances have it
+
+  // What the audio thread writes is left for the main thread to merge into
+  // the shared copy: the latest value of each parameter, which of them were
+  // written and how many writes there were. Until all of them are merged the
+  // shared copy is older than the audio thread's, which keeps its own.
+  _Atomic uint64_t audio_param_writes[PARAMS_COUNT]; // bits of the double
+  _Atomic uint32_t audio_param_written_mask;
+  _Atomic uint32_t audio_param_write_count;
+  _Atomic uint32_t merged_audio_param_write_count;
 
   // We use atomic triple buffers for the noise profile state to allow for
   // thread-safe communication between the main thread (which does loading and
-  // saving), and the audio thread (which does processing).
+  // saving), and the audio thread (which does processing). They only exist
+  // while active and are sized for the instances' profile.
   noise_profile_state_swap_buffers pending_noise_profile_change;
   noise_profile_state_swap_buffers current_noise_profile;
 
-  SignalCrossfade *soft_bypass;
+  // The latest noise profile known to the main thread. It's what gets saved
+  // and what new instances start with, and it can be of any size.
+  noise_profile_state noise_profile; // main thread
+  float *noise_profile_storage;      // main thread
+
+  // Only the main thread reads the noise profile, so the audio thread doesn't
+  // copy it out of the library instances every block while learning. It marks
+  // it dirty and publishes it every publish interval, when learning stops and
+  // when processing stops, asking the host for a main thread callback that
+  // picks it up. Saving never waits for the audio thread.
+  bool noise_profile_dirty;                    // audio thread
+  uint32_t samples_since_noise_profile_publish; // audio thread
+  uint32_t noise_profile_publish_interval;      // samples
+  _Atomic bool is_processing;
+
+  SignalCrossfade *soft_bypass[2];
   SpectralBleachHandle lib_instance[2];
-  float noise_profile[2][NOISE_PROFILE_MAX_SIZE]; // audio thread
+
+  // The dry signal is delayed by the latency of the instances. Once the
+  // crossfade settles on it the instances are suspended and only the delay
+  // runs.
+  SignalDelay *bypass_delay[2];
+  float *dry_buffer[2];    // audio thread, max_frames_count samples
+  float *priming_buffer;     // audio thread, latency samples
+  uint32_t priming_hop;      // samples of one hop of the instances
+  uint32_t samples_to_prime; // audio thread
+  bool denoiser_suspended;   // audio thread
+
+  // What the channel tasks of the current process() call work on. Only valid
+  // while process() runs, and each task only touches its own channel.
+  const clap_process_t *channel_task_process; // audio thread
+  uint32_t channel_task_offset;               // audio thread
+  uint32_t channel_task_frame_count;          // audio thread
+  bool channel_task_enable;                   // audio thread
 } clap_noiserf;
 
 static void process_event(clap_noiserf *plug, const clap_event_header_t *hdr);
 
+static void process_event_in_audio_thread(clap_noiserf *plug,
+                                          const clap_event_header_t *hdr);
+
 static void set_all_params_to_default(clap_noiserf *plug);
 
+static void store_noise_profile(clap_noiserf *plug);
+
+static uint32_t params_snapshot(clap_noiserf *plug, noiserf_params *out);
+
+static void write_param(noiserf_params *params, uint32_t param_id,
+                        double value);
+
+static void check_stft_configuration(clap_noiserf *plug,
+                                     const noiserf_params *params);
+
 /////////////////////////////
 // clap_plugin_audio_ports //
 /////////////////////////////
@@ -208,45 +372,252 @@ static const clap_plugin_latency_t s_latency = {
     .get = latency_get,
 };
 
+/////////////////
+// clap_render //
+/////////////////
+
+static bool render_has_hard_realtime_requirement(const clap_plugin_t *plugin) {
+  return false;
+}
+
+static bool render_set(const clap_plugin_t *plugin,
+                       clap_plugin_render_mode mode) {
+  clap_noiserf *plug = plugin->plugin_data;
+  atomic_store(&plug->render_mode, mode);
+  noiserf_params params;
+  params_snapshot(plug, &params);
+  check_stft_configuration(plug, &params);
+  return true;
+}
+
+static const clap_plugin_render_t s_render = {
+    .has_hard_realtime_requirement = render_has_hard_realtime_requirement,
+    .set = render_set,
+};
+
 //////////////////
 // clap_params //
 //////////////////
 
-static void set_value(clap_noiserf *plug, uint32_t param_id, double value) {
+// Main thread, the only writer, so nothing is ever waited for.
+static void params_write_begin(clap_noiserf *plug) {
+  atomic_fetch_add_explicit(&plug->params_version, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+}
+
+static void params_write_end(clap_noiserf *plug) {
+  atomic_fetch_add_explicit(&plug->params_version, 1, memory_order_release);
+}
+
+// Any thread. Takes a consistent copy of all parameters along with the
+// version it corresponds to. Gives up if a write was in progress on the
+// second attempt too.
+static bool params_try_snapshot(clap_noiserf *plug, noiserf_params *out,
+                                uint32_t *version) {
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    const uint32_t before =
+        atomic_load_explicit(&plug->params_version, memory_order_acquire);
+    memcpy(out, &plug->params, sizeof(*out));
+    atomic_thread_fence(memory_order_acquire);
+    const uint32_t after =
+        atomic_load_explicit(&plug->params_version, memory_order_relaxed);
+    if (!(before & 1u) && before == after) {
+      *version = before;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Audio thread. Writes to its own copy, and leaves the value for the main
+// thread to merge into the shared one.
+static void audio_set_value(clap_noiserf *plug, uint32_t param_id,
+                            double value) {
+  uint32_t index = 0;
+  while (index < PARAMS_COUNT && s_param_ids[index] != param_id) {
+    ++index;
+  }
+  if (index == PARAMS_COUNT) {
+    return;
+  }
+
+  write_param(&plug->audio_params, param_id, value);
+
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  atomic_store_explicit(&plug->audio_param_writes[index], bits,
+                        memory_order_relaxed);
+  atomic_fetch_or_explicit(&plug->audio_param_written_mask, 1u << index,
+                           memory_order_relaxed);
+  atomic_fetch_add_explicit(&plug->audio_param_write_count, 1,
+                            memory_order_release);
+
+  if (param_id == pid_LATENCY_MODE || param_id == pid_QUALITY) {
+    check_stft_configuration(plug, &plug->audio_params);
+  }
+}
+
+// Main thread. Writes what the audio thread wrote to the shared copy, in a
+// single write. The value of a parameter the audio thread writes again
+// meanwhile is at least as new as the writes that were counted, and gets
+// merged again next time. The audio thread already asked for any restart.
+static void merge_audio_param_writes(clap_noiserf *plug) {
+  const uint32_t write_count = atomic_load_explicit(
+      &plug->audio_param_write_count, memory_order_acquire);
+  if (write_count == atomic_load_explicit(&plug->merged_audio_param_write_count,
+                                          memory_order_relaxed)) {
+    return;
+  }
+
+  const uint32_t written = atomic_exchange_explicit(
+      &plug->audio_param_written_mask, 0, memory_order_acquire);
+  params_write_begin(plug);
+  for (uint32_t index = 0; index < PARAMS_COUNT; ++index) {
+    if (written & (1u << index)) {
+      const uint64_t bits = atomic_load_explicit(
+          &plug->audio_param_writes[index], memory_order_relaxed);
+      double value;
+      memcpy(&value, &bits, sizeof(value));
+      write_param(&plug->params, s_param_ids[index], value);
+    }
+  }
+  params_write_end(plug);
+  atomic_store_explicit(&plug->merged_audio_param_write_count, write_count,
+                        memory_order_release);
+}
+
+// Main thread. Takes a consistent copy of all parameters, with what the
+// audio thread wrote merged in, and returns the version it corresponds to.
+// Only the main thread writes, so it never has to wait.
+static uint32_t params_snapshot(clap_noiserf *plug, noiserf_params *out) {
+  merge_audio_param_writes(plug);
+  uint32_t version;
+  while (!params_try_snapshot(plug, out, &version)) {
+  }
+  return version;
+}
+
+// Audio thread. Takes a snapshot of the shared copy when it changed, unless a
+// write is in progress or the main thread hasn't merged everything the audio
+// thread wrote yet, in which case its own copy is still the newest. Returns
+// whether that changed any value.
+static bool audio_params_update(clap_noiserf *plug) {
+  const uint32_t write_count = atomic_load_explicit(
+      &plug->audio_param_write_count, memory_order_relaxed);
+  if (atomic_load_explicit(&plug->merged_audio_param_write_count,
+                           memory_order_acquire) != write_count) {
+    return false;
+  }
+
+  noiserf_params params;
+  uint32_t version;
+  if (!params_try_snapshot(plug, &params, &version) ||
+      version == plug->audio_params_version) {
+    return false;
+  }
+
+  plug->audio_params_version = version;
+  if (!memcmp(&params, &plug->audio_params, sizeof(params))) {
+    return false;
+  }
+  plug->audio_params = params;
+  return true;
+}
+
+static stft_configuration
+get_stft_configuration(clap_noiserf *plug, const noiserf_params *params) {
+  const uint32_t latency_mode = params->latency_mode < latency_COUNT
+                                    ? params->latency_mode
+                                    : latency_STANDARD;
+  int preset = (int)params->quality;
+  if (latency_mode == latency_LOW) {
+    --preset;
+  }
+  if (atomic_load(&plug->render_mode) == CLAP_RENDER_OFFLINE) {
+    ++preset;
+  }
+  if (preset < SPECBLEACH_PRESET_ECO) {
+    preset = SPECBLEACH_PRESET_ECO;
+  } else if (preset > SPECBLEACH_PRESET_HQ) {
+    preset = SPECBLEACH_PRESET_HQ;
+  }
+
+  return (stft_configuration){
+      .frame_size_ms = s_latency_mode_frame_sizes_ms[latency_mode],
+      .preset = (SpectralBleachPreset)preset,
+      .spread_frames = latency_mode == latency_STEADY_CPU,
+  };
+}
+
+// Any thread. Asks the host to restart if the active instances no longer
+// match the parameters, so that they get rebuilt when activating.
+static void check_stft_configuration(clap_noiserf *plug,
+                                     const noiserf_params *params) {
+  if (plug->active_stft.frame_size_ms == 0.f) {
+    return;
+  }
+
+  const stft_configuration wanted = get_stft_configuration(plug, params);
+  if (wanted.frame_size_ms != plug->active_stft.frame_size_ms ||
+      wanted.preset != plug->active_stft.preset ||
+      wanted.spread_frames != plug->active_stft.spread_frames) {
+    plug->host->request_restart(plug->host);
+  }
+}
+
+static void write_param(noiserf_params *params, uint32_t param_id,
+                        double value) {
   switch (param_id) {
   case pid_AMOUNT:
-    plug->amount = value;
+    params->amount = value;
     break;
   case pid_OFFSET:
-    plug->offset = value;
+    params->offset = value;
     break;
   case pid_SMOOTHING:
-    plug->smoothing = value;
+    params->smoothing = value;
     break;
   case pid_WHITENING:
-    plug->whitening = value;
+    params->whitening = value;
     break;
   case pid_TRANSIENT_PROTECTION:
-    plug->transient_protection = value >= 0.5;
+    params->transient_protection = value >= 0.5;
     break;
   case pid_LEARN_NOISE:
-    plug->learn_noise = value;
+    params->learn_noise = value;
     break;
   case pid_RESIDUAL_LISTEN:
-    plug->residual_listen = value >= 0.5;
+    params->residual_listen = value >= 0.5;
     break;
   case pid_RESET_PROFILE:
-    plug->reset_profile = value >= 0.5;
+    params->reset_profile = value >= 0.5;
     break;
   case pid_ENABLE:
-    plug->enable = value >= 0.5;
+    params->enable = value >= 0.5;
     break;
   case pid_NOISE_SCALING_TYPE:
-    plug->noise_scaling_type = value;
+    params->noise_scaling_type = value;
     break;
   case pid_POST_FILTER_THRESHOLD:
-    plug->post_filter_threshold = value;
+    params->post_filter_threshold = value;
     break;
+  case pid_LATENCY_MODE:
+    params->latency_mode = value;
+    break;
+  case pid_QUALITY:
+    params->quality = value;
+    break;
+  }
+}
+
+// Main thread.
+static void set_value(clap_noiserf *plug, uint32_t param_id, double value) {
+  params_write_begin(plug);
+  write_param(&plug->params, param_id, value);
+  params_write_end(plug);
+
+  if (param_id == pid_LATENCY_MODE || param_id == pid_QUALITY) {
+    check_stft_configuration(plug, &plug->params);
   }
 }
 
@@ -366,6 +737,29 @@ bool param_get_info(const clap_plugin_t *plugin, uint32_t param_index,
     param_info->flags = CLAP_PARAM_IS_AUTOMATABLE;
     param_info->cookie = NULL;
     break;
+  case 11:
+    // Changing it rebuilds the instances and changes the latency, which needs
+    // a restart, so it can't be automated.
+    param_info->id = pid_LATENCY_MODE;
+    strncpy(param_info->name, "Latency Mode", CLAP_NAME_SIZE);
+    param_info->module[0] = 0;
+    param_info->default_value = latency_STANDARD;
+    param_info->min_value = 0.0;
+    param_info->max_value = latency_COUNT - 1;
+    param_info->flags = CLAP_PARAM_IS_STEPPED;
+    param_info->cookie = NULL;
+    break;
+  case 12:
+    // Same as the latency mode, every change needs a restart.
+    param_info->id = pid_QUALITY;
+    strncpy(param_info->name, "Quality", CLAP_NAME_SIZE);
+    param_info->module[0] = 0;
+    param_info->default_value = SPECBLEACH_PRESET_STANDARD;
+    param_info->min_value = SPECBLEACH_PRESET_ECO;
+    param_info->max_value = SPECBLEACH_PRESET_HQ;
+    param_info->flags = CLAP_PARAM_IS_STEPPED;
+    param_info->cookie = NULL;
+    break;
   default:
     return false;
   }
@@ -376,39 +770,48 @@ bool param_get_value(const clap_plugin_t *plugin, clap_id param_id,
                      double *value) {
   clap_noiserf *plug = plugin->plugin_data;
 
+  noiserf_params params;
+  params_snapshot(plug, &params);
+
   switch (param_id) {
   case pid_AMOUNT:
-    *value = plug->amount;
+    *value = params.amount;
     return true;
   case pid_OFFSET:
-    *value = plug->offset;
+    *value = params.offset;
     return true;
   case pid_SMOOTHING:
-    *value = plug->smoothing;
+    *value = params.smoothing;
     return true;
   case pid_WHITENING:
-    *value = plug->whitening;
+    *value = params.whitening;
     return true;
   case pid_TRANSIENT_PROTECTION:
-    *value = plug->transient_protection ? 1.0 : 0.0;
+    *value = params.transient_protection ? 1.0 : 0.0;
     return true;
   case pid_LEARN_NOISE:
-    *value = round(plug->learn_noise);
+    *value = round(params.learn_noise);
     return true;
   case pid_RESIDUAL_LISTEN:
-    *value = plug->residual_listen ? 1.0 : 0.0;
+    *value = params.residual_listen ? 1.0 : 0.0;
     return true;
   case pid_RESET_PROFILE:
-    *value = plug->reset_profile ? 1.0 : 0.0;
+    *value = params.reset_profile ? 1.0 : 0.0;
     return true;
   case pid_ENABLE:
-    *value = plug->enable ? 1.0 : 0.0;
+    *value = params.enable ? 1.0 : 0.0;
     return true;
   case pid_NOISE_SCALING_TYPE:
-    *value = round(plug->noise_scaling_type);
+    *value = round(params.noise_scaling_type);
     return true;
   case pid_POST_FILTER_THRESHOLD:
-    *value = plug->post_filter_threshold;
+    *value = params.post_filter_threshold;
+    return true;
+  case pid_LATENCY_MODE:
+    *value = round(params.latency_mode);
+    return true;
+  case pid_QUALITY:
+    *value = round(params.quality);
     return true;
   }
 
@@ -475,6 +878,38 @@ bool param_value_to_text(const clap_plugin_t *plugin, clap_id param_id,
   case pid_POST_FILTER_THRESHOLD:
     snprintf(display, size, "%.1f dB", value);
     return true;
+  case pid_LATENCY_MODE: {
+    const char *text = "";
+    switch ((int)round(value)) {
+    case latency_STANDARD:
+      text = "Standard (46 ms)";
+      break;
+    case latency_LOW:
+      text = "Low Latency (10 ms)";
+      break;
+    case latency_STEADY_CPU:
+      text = "Steady CPU (46 ms + hop)";
+      break;
+    }
+    strncpy(display, text, size);
+    return true;
+  }
+  case pid_QUALITY: {
+    const char *text = "";
+    switch ((int)round(value)) {
+    case SPECBLEACH_PRESET_ECO:
+      text = "Eco";
+      break;
+    case SPECBLEACH_PRESET_STANDARD:
+      text = "Standard";
+      break;
+    case SPECBLEACH_PRESET_HQ:
+      text = "HQ";
+      break;
+    }
+    strncpy(display, text, size);
+    return true;
+  }
   }
   return false;
 }
@@ -485,14 +920,25 @@ bool text_to_value(const clap_plugin_t *plugin, clap_id param_id,
   return false;
 }
 
+// Audio thread while active, main thread otherwise.
 void flush(const clap_plugin_t *plugin, const clap_input_events_t *in,
            const clap_output_events_t *out) {
   clap_noiserf *plug = plugin->plugin_data;
+  const bool active = plug->active_stft.frame_size_ms != 0.f;
   int s = in->size(in);
   int q;
   for (q = 0; q < s; ++q) {
     const clap_event_header_t *hdr = in->get(in, q);
-    process_event(plug, hdr);
+    if (active) {
+      process_event_in_audio_thread(plug, hdr);
+    } else {
+      process_event(plug, hdr);
+    }
+  }
+  if (active && s > 0) {
+    // Nothing gets queued in the instances, they get reloaded instead
+    plug->audio_params_loaded = false;
+    plug->host->request_callback(plug->host);
   }
 }
 
@@ -559,48 +1005,156 @@ static bool code(const struct state_coder *coder, const void *buffer,
   }
 }
 
-// Main-thread. Only set consume_pending to true if the audio thread isn't
-// running.
-static noise_profile_state *current_noise_profile(const clap_noiserf *plug,
-                                                  bool consume_pending) {
+// Main-thread.
+static bool resize_noise_profile(clap_noiserf *plug, uint32_t size) {
+  float *storage =
+      realloc(plug->noise_profile_storage,
+              sizeof(float) * plug->channel_count * (size > 0 ? size : 1));
+  if (!storage) {
+    return false;
+  }
+
+  plug->noise_profile_storage = storage;
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    plug->noise_profile.channels[channel] = &storage[channel * size];
+  }
+  plug->noise_profile.size = size;
+  return true;
+}
+
+// Main-thread. Brings the main thread copy up to date with the last profile
+// the audio thread published.
+static void pull_noise_profile(clap_noiserf *plug) {
+  if (!plug->current_noise_profile.storage) {
+    return;
+  }
+
+  // A profile loaded on the main thread that the audio thread hasn't picked
+  // up yet is newer than anything it could have published.
+  if (plug->pending_noise_profile_change.middle_buffer_state &
+      TRIPLE_BUFFER_DIRTY_BIT) {
+    return;
+  }
+
   noise_profile_state *state;
+  if (!noise_profile_state_consume(&plug->current_noise_profile, &state) ||
+      !resize_noise_profile(plug, state->size)) {
+    return;
+  }
 
-  if (consume_pending && noise_profile_state_consume(
-                             &plug->pending_noise_profile_change, &state)) {
-    // Put it as the current
-    noise_profile_state *current =
-        writable_noise_profile_state(&plug->current_noise_profile);
-    current->blocks_averaged = state->blocks_averaged;
-    current->size = state->size;
+  plug->noise_profile.blocks_averaged = state->blocks_averaged;
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    memcpy(plug->noise_profile.channels[channel], state->channels[channel],
+           sizeof(float) * state->size);
+  }
+}
+
+// Main-thread. Hands the main thread copy over to the audio thread. A profile
+// of another size, saved at another sample rate, is resampled here so that the
+// audio thread only ever has to copy it.
+static void push_noise_profile(clap_noiserf *plug) {
+  if (!plug->pending_noise_profile_change.storage) {
+    return; // Picked up when activating
+  }
+
+  const noise_profile_state *profile = &plug->noise_profile;
+  noise_profile_state *state =
+      writable_noise_profile_state(&plug->pending_noise_profile_change);
+  state->blocks_averaged = profile->blocks_averaged;
+  state->size = 0;
+  if (profile->size != 0) {
+    state->size = plug->pending_noise_profile_change.capacity;
     for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
-      memcpy(current->channels[channel], state->channels[channel],
-             sizeof(float) * state->size);
+      const bool resampled = specbleach_resample_noise_profile(
+          profile->channels[channel], profile->size, state->channels[channel],
+          state->size);
+      assert(resampled);
     }
-    publish_noise_profile_state(&plug->current_noise_profile);
-    return state;
   }
+  publish_noise_profile_state(&plug->pending_noise_profile_change);
+}
+
+static uint32_t legacy_fft_size(uint32_t sample_rate) {
+  const uint32_t frame_size =
+      (uint32_t)((LEGACY_FRAME_SIZE_MS / 1000.F) * (float)sample_rate);
+  uint32_t fft_size = 1;
+  while (fft_size < frame_size) {
+    fft_size <<= 1;
+  }
+  return fft_size;
+}
 
-  const uint32_t pending_middle_state =
-      plug->pending_noise_profile_change.middle_buffer_state;
-  if (pending_middle_state & TRIPLE_BUFFER_DIRTY_BIT) {
-    state = &plug->pending_noise_profile_change
-                 .buffers[pending_middle_state & TRIPLE_BUFFER_MASK];
-  } else {
-    noise_profile_state_consume(&plug->current_noise_profile, &state);
+static double legacy_hann(uint32_t k, uint32_t n) {
+  return 0.5 - 0.5 * cos(2.0 * M_PI * (double)k / (double)n);
+}
+
+// Main-thread. Version 1 analysed 46 ms frames with the input window spanning
+// the whole fft buffer, centred on the frame, where now it spans the frame
+// itself. The profile is a power spectrum of the windowed frame, so it gets
+// the ratio of the energies of both windows over the frame. That's -2.45 dB
+// at 48 kHz, where the frame is about half the fft, but only -0.04 dB at
+// 44.1 kHz. The sample rate wasn't saved, so the frame is the one of the
+// rate we last ran at when it gives the profile's fft size, and otherwise of
+// the most common rate that does.
+static void rescale_legacy_noise_profile(clap_noiserf *plug) {
+  noise_profile_state *state = &plug->noise_profile;
+  if (state->size < 2) {
+    return;
+  }
+
+  static const uint32_t common_sample_rates[] = {
+      48000, 44100, 96000, 88200, 192000, 176400, 32000, 24000, 22050, 16000,
+  };
+  const uint32_t common_count =
+      sizeof(common_sample_rates) / sizeof(common_sample_rates[0]);
+  const uint32_t fft_size = 2 * (state->size - 1);
+  uint32_t sample_rate = 0;
+  if (plug->sample_rate && legacy_fft_size(plug->sample_rate) == fft_size) {
+    sample_rate = plug->sample_rate;
+  }
+  for (uint32_t i = 0; i < common_count && !sample_rate; ++i) {
+    if (legacy_fft_size(common_sample_rates[i]) == fft_size) {
+      sample_rate = common_sample_rates[i];
+    }
+  }
+  if (!sample_rate) {
+    return;
+  }
+
+  const uint32_t frame_size =
+      (uint32_t)((LEGACY_FRAME_SIZE_MS / 1000.F) * (float)sample_rate);
+  const uint32_t copy_position = fft_size / 2 - frame_size / 2;
+  double energy = 0.0;
+  double legacy_energy = 0.0;
+  for (uint32_t k = 0; k < frame_size; ++k) {
+    const double window = legacy_hann(k, frame_size);
+    const double legacy_window = legacy_hann(copy_position + k, fft_size);
+    energy += window * window;
+    legacy_energy += legacy_window * legacy_window;
   }
 
-  return state;
+  const float gain = (float)(energy / legacy_energy);
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    for (uint32_t k = 0; k < state->size; ++k) {
+      state->channels[channel][k] *= gain;
+    }
+  }
 }
 
 static bool code_state(const clap_plugin_t *plugin,
                        const struct state_coder *coder) {
   clap_noiserf *plug = plugin->plugin_data;
 
-  // We might need to use this in the future.
-  uint32_t version = 1;
+  // Anything the audio thread wrote is older than what gets loaded
+  merge_audio_param_writes(plug);
+
+  uint32_t version = STATE_VERSION;
   if (!code(coder, &version, sizeof(version))) {
     return false;
   }
+  if (version == 0 || version > STATE_VERSION) {
+    return false;
+  }
 
   uint32_t params_count = PARAMS_COUNT;
   if (!code(coder, &params_count, sizeof(params_count))) {
@@ -637,23 +1191,27 @@ static bool code_state(const clap_plugin_t *plugin,
     }
   }
 
-  noise_profile_state *state;
-  if (coder->mode == coding_DECODE) {
-    state = writable_noise_profile_state(&plug->pending_noise_profile_change);
-  } else {
-    // The audio thread might consume this buffer while we use it - making it
-    // the front buffer - but it's safe due to the fact that neither us nor
-    // the audio thread modify it.
-    state = current_noise_profile(plug, false);
+  if (coder->mode == coding_ENCODE) {
+    pull_noise_profile(plug);
   }
 
-  assert(state->size <= NOISE_PROFILE_MAX_SIZE);
-  if (!code(coder, &state->blocks_averaged, sizeof(state->blocks_averaged))) {
+  noise_profile_state *state = &plug->noise_profile;
+  uint32_t blocks_averaged = state->blocks_averaged;
+  uint32_t size = state->size;
+  if (!code(coder, &blocks_averaged, sizeof(blocks_averaged))) {
     return false;
   }
-  if (!code(coder, &state->size, sizeof(state->size))) {
+  if (!code(coder, &size, sizeof(size))) {
     return false;
   }
+
+  if (coder->mode == coding_DECODE) {
+    if (size > NOISE_PROFILE_MAX_SIZE || !resize_noise_profile(plug, size)) {
+      return false;
+    }
+    state->blocks_averaged = blocks_averaged;
+  }
+
   for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
     if (!code(coder, state->channels[channel], sizeof(float) * state->size)) {
       return false;
@@ -661,15 +1219,17 @@ static bool code_state(const clap_plugin_t *plugin,
   }
 
   if (coder->mode == coding_DECODE) {
-    publish_noise_profile_state(&plug->pending_noise_profile_change);
+    if (version == 1) {
+      rescale_legacy_noise_profile(plug);
+    }
+    push_noise_profile(plug);
   }
 
   return true;
 }
 
 bool state_save(const clap_plugin_t *plugin, const clap_ostream_t *stream) {
-  clap_noiserf *plug = plugin->plugin_data;
-
+  // Serializes the last profile the audio thread published
   const struct state_coder coder = {
       .mode = coding_ENCODE,
       .ostream = stream,
@@ -727,9 +1287,9 @@ static bool init(const struct clap_plugin *plugin) {
       plug->host->get_extension(plug->host, CLAP_EXT_THREAD_CHECK);
   plug->hostLatency = plug->host->get_extension(plug->host, CLAP_EXT_LATENCY);
   plug->hostParams = plug->host->get_extension(plug->host, CLAP_EXT_PARAMS);
+  plug->hostThreadPool =
+      plug->host->get_extension(plug->host, CLAP_EXT_THREAD_POOL);
 
-  init_noise_profile_buffers(&plug->pending_noise_profile_change);
-  init_noise_profile_buffers(&plug->current_noise_profile);
   set_all_params_to_default(plug);
 
   return true;
@@ -738,6 +1298,15 @@ static bool init(const struct clap_plugin *plugin) {
 static void destroy(const struct clap_plugin *plugin) {
   clap_noiserf *plug = plugin->plugin_data;
 
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    if (plug->lib_instance[channel]) {
+      specbleach_free(plug->lib_instance[channel]);
+    }
+  }
+
+  free_noise_profile_buffers(&plug->pending_noise_profile_change);
+  free_noise_profile_buffers(&plug->current_noise_profile);
+  free(plug->noise_profile_storage);
   free(plug);
 }
 
@@ -745,20 +1314,56 @@ static bool activate(const struct clap_plugin *plugin, double sample_rate,
                      uint32_t min_frames_count, uint32_t max_frames_count) {
   clap_noiserf *plug = plugin->plugin_data;
 
-  if (sample_rate > 192000.0)
-    return false; // IMPROVE: support higher sample rates
-
-  plug->soft_bypass = signal_crossfade_initialize((uint32_t)sample_rate);
-  if (!plug->soft_bypass) {
-    return false;
+  plug->sample_rate = (uint32_t)sample_rate;
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    plug->soft_bypass[channel] =
+        signal_crossfade_initialize((uint32_t)sample_rate);
+    if (!plug->soft_bypass[channel]) {
+      return false;
+    }
   }
 
-  const float frame_size_ms = 46;
-
+  noiserf_params params;
+  plug->audio_params_version = params_snapshot(plug, &params);
+  plug->audio_params = params;
+  const stft_configuration stft = get_stft_configuration(plug, &params);
+  plug->noise_profile_publish_interval =
+      (uint32_t)(sample_rate * NOISE_PROFILE_PUBLISH_INTERVAL_MS / 1000.0);
+  plug->samples_since_noise_profile_publish = 0;
+  SpectralBleachConfig config = specbleach_get_preset_config(
+      stft.preset, (uint32_t)sample_rate, stft.frame_size_ms);
+  config.spread_frames = stft.spread_frames;
+
+  // The new instances haven't been given any parameters yet
+  plug->audio_params_loaded = false;
+
+  // Instances are kept between activations. Hosts deactivate and activate
+  // again on many configuration changes, often with the same sample rate.
   for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
-    plug->lib_instance[channel] =
-        specbleach_initialize((uint32_t)sample_rate, frame_size_ms);
-    if (!plug->lib_instance[channel]) {
+    if (plug->lib_instance[channel]) {
+      if (!specbleach_reconfigure_with_config(plug->lib_instance[channel],
+                                              &config)) {
+        return false;
+      }
+      continue;
+    }
+
+    // Noise scaling and transient protection can change from the audio
+    // thread, where the library can't build the modules they need, so all of
+    // them are built here. Reconfiguring keeps them built. The other
+    // channels are clones of the first, which read its tables and come
+    // prewarmed too.
+    if (channel > 0) {
+      plug->lib_instance[channel] = specbleach_clone(plug->lib_instance[0]);
+      if (!plug->lib_instance[channel]) {
+        return false;
+      }
+      continue;
+    }
+
+    plug->lib_instance[channel] = specbleach_initialize_with_config(&config);
+    if (!plug->lib_instance[channel] ||
+        !specbleach_prewarm(plug->lib_instance[channel])) {
       return false;
     }
   }
@@ -766,13 +1371,21 @@ static bool activate(const struct clap_plugin *plugin, double sample_rate,
   const uint32_t noise_profile_size =
       specbleach_get_noise_profile_size(plug->lib_instance[0]);
 
-  assert(noise_profile_size <= NOISE_PROFILE_MAX_SIZE);
+  if (!init_noise_profile_buffers(&plug->pending_noise_profile_change,
+                                  plug->channel_count, noise_profile_size) ||
+      !init_noise_profile_buffers(&plug->current_noise_profile,
+                                  plug->channel_count, noise_profile_size)) {
+    return false;
+  }
 
   // If we have a current noise profile, load it into the instance. This might
-  // not be the first time we have been activated.
-  noise_profile_state *state = current_noise_profile(plug, true);
-  if (state->size != 0) {
-    for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+  // not be the first time we have been activated, possibly at another sample
+  // rate, in which case the library resamples it.
+  const noise_profile_state *state = &plug->noise_profile;
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    if (state->size == 0) {
+      specbleach_reset_noise_profile(plug->lib_instance[channel]);
+    } else {
       const bool loaded = specbleach_load_noise_profile(
           plug->lib_instance[channel], state->channels[channel], state->size,
           state->blocks_averaged);
@@ -780,29 +1393,194 @@ static bool activate(const struct clap_plugin *plugin, double sample_rate,
     }
   }
 
+  const uint32_t latency = specbleach_get_latency(plug->lib_instance[0]);
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    plug->bypass_delay[channel] = signal_delay_initialize(latency);
+    if (!plug->bypass_delay[channel]) {
+      return false;
+    }
+  }
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    plug->dry_buffer[channel] = calloc(max_frames_count, sizeof(float));
+    if (!plug->dry_buffer[channel]) {
+      return false;
+    }
+  }
+  plug->priming_buffer = calloc(latency > 0 ? latency : 1, sizeof(float));
+  if (!plug->priming_buffer) {
+    return false;
+  }
+  plug->priming_hop = (uint32_t)(config.frame_size / 1000.f *
+                                 (float)config.sample_rate) /
+                      config.overlap_factor;
+  plug->samples_to_prime = 0;
+  plug->denoiser_suspended = false;
+  plug->active_stft = stft;
+
+  // The latency is only allowed to change while activating
+  if (latency != plug->reported_latency) {
+    plug->reported_latency = latency;
+    if (plug->hostLatency) {
+      plug->hostLatency->changed(plug->host);
+    }
+  }
+
   return true;
 }
 
 static void deactivate(const struct clap_plugin *plugin) {
   clap_noiserf *plug = plugin->plugin_data;
 
+  if (plug->noise_profile_dirty) {
+    store_noise_profile(plug);
+  }
+  pull_noise_profile(plug);
+  free_noise_profile_buffers(&plug->pending_noise_profile_change);
+  free_noise_profile_buffers(&plug->current_noise_profile);
+
   for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
-    if (plug->lib_instance[channel]) {
-      specbleach_free(plug->lib_instance[channel]);
+    if (plug->soft_bypass[channel]) {
+      signal_crossfade_free(plug->soft_bypass[channel]);
+      plug->soft_bypass[channel] = NULL;
     }
+    if (plug->bypass_delay[channel]) {
+      signal_delay_free(plug->bypass_delay[channel]);
+      plug->bypass_delay[channel] = NULL;
+    }
+    free(plug->dry_buffer[channel]);
+    plug->dry_buffer[channel] = NULL;
   }
 
-  if (plug->soft_bypass) {
-    signal_crossfade_free(plug->soft_bypass);
+  free(plug->priming_buffer);
+  plug->priming_buffer = NULL;
+  plug->active_stft.frame_size_ms = 0.f;
+}
+
+static bool start_processing(const struct clap_plugin *plugin) {
+  clap_noiserf *plug = plugin->plugin_data;
+
+  atomic_store(&plug->is_processing, true);
+  return true;
+}
+
+static void stop_processing(const struct clap_plugin *plugin) {
+  clap_noiserf *plug = plugin->plugin_data;
+
+  if (plug->noise_profile_dirty) {
+    store_noise_profile(plug);
+    plug->host->request_callback(plug->host);
+  }
+  atomic_store(&plug->is_processing, false);
+}
+
+static void reset(const struct clap_plugin *plugin) {
+  clap_noiserf *plug = plugin->plugin_data;
+
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    specbleach_reset(plug->lib_instance[channel]);
+    signal_delay_reset(plug->bypass_delay[channel]);
   }
+  plug->samples_to_prime = 0;
 }
 
-static bool start_processing(const struct clap_plugin *plugin) { return true; }
+// Audio thread. The instances stopped receiving audio while bypassed, so
+// they start over from the input the delay line still holds.
+static void resume_denoiser(clap_noiserf *plug) {
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    specbleach_reset(plug->lib_instance[channel]);
+  }
+  plug->samples_to_prime = signal_delay_get_delay(plug->bypass_delay[0]);
+}
+
+// Audio thread. Feeds the instances the input they are behind on, a hop
+// more than the block each callback so that none of them carries the whole
+// latency. Returns whether they caught up, after which their output lines
+// up with the delayed dry signal from the first sample.
+static bool prime_denoiser(clap_noiserf *plug, const uint32_t frame_count) {
+  const uint32_t catch_up = frame_count + plug->priming_hop;
+  const uint32_t chunk =
+      plug->samples_to_prime < catch_up ? plug->samples_to_prime : catch_up;
+  for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+    signal_delay_get_history(plug->bypass_delay[channel],
+                             plug->samples_to_prime, chunk,
+                             plug->priming_buffer);
+    specbleach_process(plug->lib_instance[channel], chunk,
+                       plug->priming_buffer, plug->priming_buffer);
+  }
+  plug->samples_to_prime -= chunk;
 
-static void stop_processing(const struct clap_plugin *plugin) {}
+  return plug->samples_to_prime == 0;
+}
+
+// Audio thread, or main thread while the audio thread isn't running.
+static void store_noise_profile(clap_noiserf *plug) {
+  if (specbleach_noise_profile_available(plug->lib_instance[0])) {
+    noise_profile_state *state =
+        writable_noise_profile_state(&plug->current_noise_profile);
+    state->size = specbleach_get_noise_profile_size(plug->lib_instance[0]);
+    state->blocks_averaged =
+        specbleach_get_noise_profile_blocks_averaged(plug->lib_instance[0]);
+    assert(state->size <= plug->current_noise_profile.capacity);
+    for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+      memcpy(state->channels[channel],
+             specbleach_get_noise_profile(plug->lib_instance[channel]),
+             sizeof(float) * state->size);
+    }
+    publish_noise_profile_state(&plug->current_noise_profile);
+  }
 
-static void reset(const struct clap_plugin *plugin) {}
+  plug->noise_profile_dirty = false;
+  plug->samples_since_noise_profile_publish = 0;
+}
 
+// Maps a plugin parameter to the library parameter it drives, converting the
+// value the same way set_value does. Returns false for parameters that are
+// handled by the plugin itself.
+static bool library_parameter(uint32_t param_id, double value,
+                              SpectralBleachParameterId *library_id,
+                              float *library_value) {
+  switch (param_id) {
+  case pid_AMOUNT:
+    *library_id = SPECBLEACH_PARAMETER_REDUCTION_AMOUNT;
+    *library_value = (float)value;
+    return true;
+  case pid_OFFSET:
+    *library_id = SPECBLEACH_PARAMETER_NOISE_RESCALE;
+    *library_value = (float)value;
+    return true;
+  case pid_SMOOTHING:
+    *library_id = SPECBLEACH_PARAMETER_SMOOTHING_FACTOR;
+    *library_value = (float)value;
+    return true;
+  case pid_WHITENING:
+    *library_id = SPECBLEACH_PARAMETER_WHITENING_FACTOR;
+    *library_value = (float)value;
+    return true;
+  case pid_TRANSIENT_PROTECTION:
+    *library_id = SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION;
+    *library_value = value >= 0.5 ? 1.F : 0.F;
+    return true;
+  case pid_LEARN_NOISE:
+    *library_id = SPECBLEACH_PARAMETER_LEARN_NOISE;
+    *library_value = (float)(uint32_t)value;
+    return true;
+  case pid_RESIDUAL_LISTEN:
+    *library_id = SPECBLEACH_PARAMETER_RESIDUAL_LISTEN;
+    *library_value = value >= 0.5 ? 1.F : 0.F;
+    return true;
+  case pid_NOISE_SCALING_TYPE:
+    *library_id = SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE;
+    *library_value = (float)(uint32_t)value;
+    return true;
+  case pid_POST_FILTER_THRESHOLD:
+    *library_id = SPECBLEACH_PARAMETER_POST_FILTER_THRESHOLD;
+    *library_value = (float)value;
+    return true;
+  }
+  return false;
+}
+
+// Main thread.
 static void process_event(clap_noiserf *plug, const clap_event_header_t *hdr) {
   if (hdr->space_id == CLAP_CORE_EVENT_SPACE_ID) {
     switch (hdr->type) {
@@ -810,6 +1588,7 @@ static void process_event(clap_noiserf *plug, const clap_event_header_t *hdr) {
       const clap_event_param_value_t *ev =
           (const clap_event_param_value_t *)hdr;
 
+      merge_audio_param_writes(plug);
       set_value(plug, ev->param_id, ev->value);
       break;
     }
@@ -817,13 +1596,144 @@ static void process_event(clap_noiserf *plug, const clap_event_header_t *hdr) {
   }
 }
 
+// Audio thread. Same as process_event, but only the audio thread's copy is
+// written.
+static void process_event_in_audio_thread(clap_noiserf *plug,
+                                          const clap_event_header_t *hdr) {
+  if (hdr->space_id == CLAP_CORE_EVENT_SPACE_ID &&
+      hdr->type == CLAP_EVENT_PARAM_VALUE) {
+    const clap_event_param_value_t *ev = (const clap_event_param_value_t *)hdr;
+    audio_set_value(plug, ev->param_id, ev->value);
+  }
+}
+
+// Audio thread. Whether the event switches the plugin on or off.
+static bool changes_enable(const clap_noiserf *plug,
+                           const clap_event_header_t *hdr) {
+  if (hdr->space_id != CLAP_CORE_EVENT_SPACE_ID ||
+      hdr->type != CLAP_EVENT_PARAM_VALUE) {
+    return false;
+  }
+
+  const clap_event_param_value_t *ev = (const clap_event_param_value_t *)hdr;
+  return ev->param_id == pid_ENABLE &&
+         (ev->value >= 0.5) != plug->audio_params.enable;
+}
+
+// Audio thread. Same as process_event_in_audio_thread but the library
+// instances get the change queued at the event time instead of being
+// reloaded. Their next call starts at the given frame of the block.
+static void process_event_in_block(clap_noiserf *plug,
+                                   const clap_event_header_t *hdr,
+                                   const uint32_t frame_offset) {
+  if (hdr->space_id != CLAP_CORE_EVENT_SPACE_ID ||
+      hdr->type != CLAP_EVENT_PARAM_VALUE) {
+    return;
+  }
+
+  const clap_event_param_value_t *ev = (const clap_event_param_value_t *)hdr;
+  audio_set_value(plug, ev->param_id, ev->value);
+
+  SpectralBleachParameterId library_id;
+  float library_value;
+  if (library_parameter(ev->param_id, ev->value, &library_id,
+                        &library_value)) {
+    // The instances are prewarmed so nothing should be rejected, but if it
+    // were the next block reloads them, which builds what's missing
+    for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+      if (!specbleach_queue_parameter(plug->lib_instance[channel], library_id,
+                                      library_value,
+                                      hdr->time - frame_offset)) {
+        plug->audio_params_loaded = false;
+      }
+    }
+  }
+}
+
+// Audio thread or a host thread pool thread.
+static void process_channel(clap_noiserf *plug, uint32_t channel) {
+  const clap_process_t *process = plug->channel_task_process;
+  const uint32_t frame_count = plug->channel_task_frame_count;
+  const float *input =
+      &process->audio_inputs[0].data32[channel][plug->channel_task_offset];
+  float *output =
+      &process->audio_outputs[0].data32[channel][plug->channel_task_offset];
+
+  signal_delay_run(plug->bypass_delay[channel], frame_count, input,
+                   plug->dry_buffer[channel]);
+  specbleach_process(plug->lib_instance[channel], frame_count, input, output);
+  signal_crossfade_run(plug->soft_bypass[channel], frame_count,
+                       plug->dry_buffer[channel], output,
+                       plug->channel_task_enable);
+}
+
+// Audio thread. Runs frame_count frames of the block from offset on with the
+// parameters as they are now.
+static void process_frames(clap_noiserf *plug, const clap_process_t *process,
+                           const uint32_t offset, const uint32_t frame_count) {
+  const noiserf_params *params = &plug->audio_params;
+
+  // Handle reset noise profile if needed
+  if (params->reset_profile) {
+    for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+      specbleach_reset_noise_profile(plug->lib_instance[channel]);
+    }
+    // Reset the trigger. The library instances don't use it.
+    audio_set_value(plug, pid_RESET_PROFILE, 0.0);
+  }
+
+  // Once the fade out has finished only the delay is needed. The instances
+  // keep running while learning so that the profile keeps being captured.
+  const bool bypassed = !params->enable && params->learn_noise == 0 &&
+                        signal_crossfade_is_dry(plug->soft_bypass[0]);
+  if (!bypassed && plug->denoiser_suspended) {
+    resume_denoiser(plug);
+    plug->denoiser_suspended = false;
+  }
+
+  // Until the instances catch up the output stays on the delayed dry signal,
+  // and the frames join the input they are behind on
+  const bool priming = !bypassed && plug->samples_to_prime > 0 &&
+                       !prime_denoiser(plug, frame_count);
+
+  if (bypassed || priming) {
+    for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+      signal_delay_run(plug->bypass_delay[channel], frame_count,
+                       &process->audio_inputs[0].data32[channel][offset],
+                       &process->audio_outputs[0].data32[channel][offset]);
+    }
+    if (priming) {
+      plug->samples_to_prime += frame_count;
+    } else {
+      plug->denoiser_suspended = true;
+    }
+    return;
+  }
+
+  plug->channel_task_process = process;
+  plug->channel_task_offset = offset;
+  plug->channel_task_frame_count = frame_count;
+  plug->channel_task_enable = params->enable;
+
+  // Channels are independent, so let the host spread them over its
+  // threads when it can. request_exec only returns once all tasks ran.
+  const bool executed =
+      plug->channel_count > 1 && plug->hostThreadPool &&
+      plug->hostThreadPool->request_exec(plug->host, plug->channel_count);
+  if (!executed) {
+    for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
+      process_channel(plug, channel);
+    }
+  }
+
+  plug->channel_task_process = NULL;
+}
+
 static clap_process_status process(const struct clap_plugin *plugin,
                                    const clap_process_t *process) {
   clap_noiserf *plug = plugin->plugin_data;
   const uint32_t frame_count = process->frames_count;
   const uint32_t ev_count = process->in_events->size(process->in_events);
-  uint32_t ev_index = 0;
-  uint32_t next_ev_frame = ev_count > 0 ? 0 : frame_count;
 
   bool noise_profile_changed = false;
 
@@ -848,90 +1758,95 @@ static clap_process_status process(const struct clap_plugin *plugin,
     }
   }
 
-  for (uint32_t i = 0; i < frame_count;) {
-    // handle every events that happens at the frame "i"
-    while (ev_index < ev_count && next_ev_frame == i) {
-      const clap_event_header_t *hdr =
-          process->in_events->get(process->in_events, ev_index);
-      if (hdr->time != i) {
-        next_ev_frame = hdr->time;
-        break;
-      }
-
-      process_event(plug, hdr);
-      ++ev_index;
-
-      if (ev_index == ev_count) {
-        // we reached the end of the event list
-        next_ev_frame = frame_count;
-        break;
-      }
-    }
-
-    // process audio until the next event
-    const uint32_t block_size = next_ev_frame - i;
+  const uint32_t param_write_count = atomic_load_explicit(
+      &plug->audio_param_write_count, memory_order_relaxed);
 
-    // Update the parameters struct for the spectral bleach instances
+  // Update the spectral bleach instances only if the main thread wrote
+  // something since the last time they were loaded. Events below write the
+  // audio thread's copy, so it always has the values of the block.
+  const noiserf_params *params = &plug->audio_params;
+  if (audio_params_update(plug) || !plug->audio_params_loaded) {
     SpectralBleachParameters parameters = {
-        .learn_noise = (int)plug->learn_noise,
-        .residual_listen = plug->residual_listen,
-        .reduction_amount = plug->amount,
-        .smoothing_factor = plug->smoothing,
-        .transient_protection = plug->transient_protection,
-        .whitening_factor = plug->whitening,
-        .noise_scaling_type = (int)plug->noise_scaling_type,
-        .noise_rescale = plug->offset,
-        .post_filter_threshold = plug->post_filter_threshold,
+        .learn_noise = (int)params->learn_noise,
+        .residual_listen = params->residual_listen,
+        .reduction_amount = params->amount,
+        .smoothing_factor = params->smoothing,
+        .transient_protection = params->transient_protection,
+        .whitening_factor = params->whitening,
+        .noise_scaling_type = (int)params->noise_scaling_type,
+        .noise_rescale = params->offset,
+        .post_filter_threshold = params->post_filter_threshold,
     };
 
-    if (plug->learn_noise != 0)
-      noise_profile_changed = true;
-
     for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
       specbleach_load_parameters(plug->lib_instance[channel], parameters);
     }
+    plug->audio_params_loaded = true;
+  }
 
-    // Handle reset noise profile if needed
-    if (plug->reset_profile) {
-      for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
-        specbleach_reset_noise_profile(plug->lib_instance[channel]);
-      }
-      plug->reset_profile = false; // Reset the trigger
-    }
-
-    for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
-      specbleach_process(plug->lib_instance[channel], block_size,
-                         &process->audio_inputs[0].data32[channel][i],
-                         &process->audio_outputs[0].data32[channel][i]);
-      signal_crossfade_run(plug->soft_bypass, block_size,
-                           &process->audio_inputs[0].data32[channel][i],
-                           &process->audio_outputs[0].data32[channel][i],
-                           plug->enable);
+  if (params->learn_noise != 0)
+    noise_profile_changed = true;
+
+  // Parameters only take effect once per hop, so rather than splitting the
+  // block at every event they are queued with their time and the library
+  // applies them at the hop boundary where they first matter. Enable is the
+  // exception, as the bypass crossfade follows it sample by sample, so the
+  // block is split where it changes.
+  uint32_t offset = 0;
+  for (uint32_t ev_index = 0; ev_index < ev_count; ++ev_index) {
+    const clap_event_header_t *hdr =
+        process->in_events->get(process->in_events, ev_index);
+    if (changes_enable(plug, hdr) && hdr->time > offset &&
+        hdr->time < frame_count) {
+      process_frames(plug, process, offset, hdr->time - offset);
+      offset = hdr->time;
     }
+    process_event_in_block(plug, hdr, offset);
+    if (params->learn_noise != 0)
+      noise_profile_changed = true;
+  }
+  process_frames(plug, process, offset, frame_count - offset);
 
-    i = next_ev_frame;
+  if (noise_profile_changed) {
+    plug->noise_profile_dirty = true;
   }
 
-  // Store the noise profile
-  if (specbleach_noise_profile_available(plug->lib_instance[0]) &&
-      noise_profile_changed) {
-    noise_profile_state *state =
-        writable_noise_profile_state(&plug->current_noise_profile);
-    state->size = specbleach_get_noise_profile_size(plug->lib_instance[0]);
-    state->blocks_averaged =
-        specbleach_get_noise_profile_blocks_averaged(plug->lib_instance[0]);
-    assert(state->size <= NOISE_PROFILE_MAX_SIZE);
-    for (uint32_t channel = 0; channel < plug->channel_count; ++channel) {
-      memcpy(state->channels[channel],
-             specbleach_get_noise_profile(plug->lib_instance[channel]),
-             sizeof(float) * state->size);
+  // Publish the noise profile once it's final, and every interval while it's
+  // being learned, so a save made meanwhile isn't far behind
+  if (plug->noise_profile_dirty) {
+    plug->samples_since_noise_profile_publish += frame_count;
+    if (params->learn_noise == 0 || plug->samples_since_noise_profile_publish >=
+                                       plug->noise_profile_publish_interval) {
+      store_noise_profile(plug);
+      plug->host->request_callback(plug->host);
     }
-    publish_noise_profile_state(&plug->current_noise_profile);
+  }
+
+  // The main thread merges what the events wrote
+  if (atomic_load_explicit(&plug->audio_param_write_count,
+                           memory_order_relaxed) != param_write_count) {
+    plug->host->request_callback(plug->host);
   }
 
   return CLAP_PROCESS_CONTINUE;
 }
 
+//////////////////////
+// clap_thread_pool //
+//////////////////////
+
+static void thread_pool_exec(const clap_plugin_t *plugin,
+                             uint32_t task_index) {
+  clap_noiserf *plug = plugin->plugin_data;
+  if (task_index < plug->channel_count && plug->channel_task_process) {
+    process_channel(plug, task_index);
+  }
+}
+
+static const clap_plugin_thread_pool_t s_thread_pool = {
+    .exec = thread_pool_exec,
+};
+
 static const void *get_extension(const struct clap_plugin *plugin,
                                  const char *id) {
   if (!strcmp(id, CLAP_EXT_LATENCY))
@@ -942,10 +1857,22 @@ static const void *get_extension(const struct clap_plugin *plugin,
     return &s_params;
   if (!strcmp(id, CLAP_EXT_STATE))
     return &s_state;
+  if (!strcmp(id, CLAP_EXT_THREAD_POOL))
+    return &s_thread_pool;
+  if (!strcmp(id, CLAP_EXT_RENDER))
+    return &s_render;
   return NULL;
 }
 
-static void on_main_thread(const struct clap_plugin *plugin) {}
+// Main-thread. Requested by the audio thread after it publishes a noise
+// profile or writes parameters, so the copies that get saved are kept up to
+// date.
+static void on_main_thread(const struct clap_plugin *plugin) {
+  clap_noiserf *plug = plugin->plugin_data;
+
+  merge_audio_param_writes(plug);
+  pull_noise_profile(plug);
+}
 
 clap_plugin_t *create(const clap_host_t *host,
                       const clap_plugin_descriptor_t *desc,
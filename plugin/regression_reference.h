@@ -0,0 +1,895 @@
+// Generated by `regression-tests --generate` from the scalar kernels.
+// For each case and sample rate of regression_tests.c, the RMS and peak
+// level of each 20 ms block of output after learning, in hundredths of a
+// dB, and one sample of it every 5 ms, in fixed point
+
+#define REGRESSION_REFERENCE_CASE_COUNT 8U
+#define REGRESSION_REFERENCE_SAMPLE_RATE_COUNT 4U
+
+static const int16_t regression_reference[REGRESSION_REFERENCE_CASE_COUNT]
+    [REGRESSION_REFERENCE_SAMPLE_RATE_COUNT][25U][2] = {
+        // wiener_mean_snr
+        {
+            // 22050 Hz
+            {
+                {-3093, -2118}, {-3567, -2564}, {-2435, -860}, {-3673, -2848},
+                {-4456, -3632}, {-4488, -3579}, {-4567, -3614}, {-4689, -3767},
+                {-2314, -1284}, {-1342, -962}, {-1365, -998}, {-1330, -951},
+                {-1321, -458}, {-1311, -948}, {-1401, -988}, {-2864, -1622},
+                {-3806, -3080}, {-3893, -3078}, {-5542, -4566}, {-4567, -3651},
+                {-3806, -2949}, {-1523, -959}, {-1332, -600}, {-1355, -979},
+                {-1344, -971},
+            },
+            // 44100 Hz
+            {
+                {-3058, -2178}, {-3562, -2431}, {-2501, -794}, {-4314, -3017},
+                {-5142, -4308}, {-5700, -4737}, {-5222, -3854}, {-4095, -3005},
+                {-2215, -1076}, {-1345, -970}, {-1342, -960}, {-1348, -963},
+                {-1320, -459}, {-1330, -953}, {-1394, -1026}, {-2805, -1561},
+                {-4011, -3133}, {-4224, -3081}, {-4433, -3429}, {-3976, -3026},
+                {-4024, -3122}, {-1550, -971}, {-1337, -499}, {-1335, -959},
+                {-1335, -975},
+            },
+            // 48000 Hz
+            {
+                {-3122, -2189}, {-3647, -2550}, {-2598, -850}, {-4375, -3183},
+                {-4158, -3159}, {-4464, -3569}, {-5176, -4146}, {-4583, -3456},
+                {-2210, -1155}, {-1355, -981}, {-1350, -971}, {-1347, -946},
+                {-1318, -434}, {-1346, -934}, {-1394, -959}, {-2774, -1521},
+                {-4064, -3091}, {-4305, -3332}, {-4929, -3616}, {-5147, -4081},
+                {-4369, -3338}, {-1572, -960}, {-1345, -494}, {-1348, -976},
+                {-1344, -976},
+            },
+            // 96000 Hz
+            {
+                {-3207, -2079}, {-3863, -2724}, {-2618, -876}, {-4075, -2776},
+                {-4279, -3287}, {-4219, -3269}, {-4520, -3539}, {-4304, -3142},
+                {-2278, -1163}, {-1347, -991}, {-1334, -947}, {-1337, -907},
+                {-1312, -462}, {-1322, -958}, {-1370, -960}, {-2755, -1479},
+                {-4145, -3147}, {-4409, -3347}, {-4439, -3365}, {-4285, -3016},
+                {-3939, -2884}, {-1540, -940}, {-1316, -465}, {-1339, -940},
+                {-1346, -983},
+            },
+        },
+        // gates_median_bands
+        {
+            // 22050 Hz
+            {
+                {-3086, -2118}, {-3375, -2420}, {-2324, -710}, {-3357, -2507},
+                {-3970, -3116}, {-3793, -2774}, {-3915, -3080}, {-4063, -3213},
+                {-2311, -1326}, {-1340, -946}, {-1363, -991}, {-1326, -920},
+                {-1315, -421}, {-1310, -934}, {-1398, -1006}, {-2835, -1608},
+                {-3520, -2779}, {-3483, -2761}, {-4300, -3305}, {-3858, -2970},
+                {-3487, -2662}, {-1517, -960}, {-1324, -576}, {-1355, -974},
+                {-1341, -978},
+            },
+            // 44100 Hz
+            {
+                {-3058, -2160}, {-3442, -2432}, {-2402, -708}, {-3817, -2696},
+                {-3911, -2989}, {-4072, -3003}, {-4008, -3037}, {-3804, -2804},
+                {-2209, -1062}, {-1341, -965}, {-1342, -973}, {-1347, -928},
+                {-1313, -424}, {-1328, -940}, {-1390, -1006}, {-2774, -1529},
+                {-3635, -2734}, {-3796, -2671}, {-3788, -2856}, {-3708, -2728},
+                {-3856, -2898}, {-1541, -949}, {-1331, -469}, {-1334, -972},
+                {-1336, -988},
+            },
+            // 48000 Hz
+            {
+                {-3120, -2189}, {-3534, -2549}, {-2462, -751}, {-3863, -2911},
+                {-3770, -2785}, {-4032, -3153}, {-4096, -3089}, {-3939, -2721},
+                {-2202, -1167}, {-1352, -979}, {-1349, -960}, {-1345, -935},
+                {-1311, -384}, {-1343, -907}, {-1390, -949}, {-2762, -1481},
+                {-3664, -2701}, {-3913, -2958}, {-4085, -2945}, {-3916, -2989},
+                {-4076, -3163}, {-1567, -952}, {-1337, -474}, {-1347, -976},
+                {-1342, -972},
+            },
+            // 96000 Hz
+            {
+                {-3187, -2079}, {-3589, -2497}, {-2477, -736}, {-3760, -2552},
+                {-3927, -2865}, {-3837, -2894}, {-3949, -2976}, {-4010, -2834},
+                {-2274, -1161}, {-1345, -979}, {-1333, -940}, {-1337, -904},
+                {-1305, -418}, {-1321, -939}, {-1368, -935}, {-2739, -1492},
+                {-3802, -2799}, {-3984, -2887}, {-3848, -2714}, {-3803, -2583},
+                {-3696, -2557}, {-1537, -910}, {-1311, -422}, {-1337, -943},
+                {-1345, -983},
+            },
+        },
+        // gss_max_masking
+        {
+            // 22050 Hz
+            {
+                {-3088, -2118}, {-3451, -2498}, {-2400, -825}, {-3355, -2567},
+                {-3435, -2642}, {-2977, -2056}, {-3309, -2240}, {-3238, -2246},
+                {-2294, -1232}, {-1340, -867}, {-1357, -866}, {-1167, -525},
+                {-1302, -480}, {-1309, -867}, {-1376, -805}, {-2524, -1401},
+                {-3102, -2185}, {-3201, -2200}, {-3203, -2166}, {-3205, -2207},
+                {-3148, -2172}, {-1518, -926}, {-1332, -598}, {-1344, -832},
+                {-1338, -887},
+            },
+            // 44100 Hz
+            {
+                {-3050, -2104}, {-3310, -2322}, {-2416, -773}, {-3016, -1819},
+                {-3147, -2121}, {-3320, -2191}, {-3195, -2031}, {-3294, -2302},
+                {-2179, -1068}, {-1336, -830}, {-1327, -853}, {-1345, -837},
+                {-1317, -490}, {-1318, -875}, {-1383, -829}, {-2643, -1401},
+                {-3127, -1963}, {-3080, -2160}, {-2995, -2040}, {-2692, -1720},
+                {-2791, -1682}, {-1550, -939}, {-1332, -494}, {-1328, -857},
+                {-1320, -779},
+            },
+            // 48000 Hz
+            {
+                {-3110, -2189}, {-3444, -2347}, {-2543, -810}, {-3403, -2507},
+                {-3312, -2176}, {-3243, -2321}, {-3375, -2409}, {-3327, -2319},
+                {-2189, -999}, {-1339, -828}, {-1344, -851}, {-1344, -907},
+                {-1318, -460}, {-1340, -912}, {-1371, -797}, {-2545, -1240},
+                {-3228, -2243}, {-3316, -2332}, {-3239, -2146}, {-3111, -2017},
+                {-3067, -2076}, {-1562, -923}, {-1344, -456}, {-1332, -809},
+                {-1333, -879},
+            },
+            // 96000 Hz
+            {
+                {-3123, -2079}, {-3185, -1968}, {-2569, -805}, {-3197, -2009},
+                {-3067, -1911}, {-3104, -1894}, {-3138, -2108}, {-3150, -2037},
+                {-2230, -1089}, {-1340, -867}, {-1324, -810}, {-1336, -889},
+                {-1315, -471}, {-1316, -864}, {-1361, -830}, {-2418, -1292},
+                {-2982, -1874}, {-2936, -1880}, {-3073, -2020}, {-2997, -2022},
+                {-3093, -2012}, {-1527, -855}, {-1312, -438}, {-1335, -821},
+                {-1339, -854},
+            },
+        },
+        // smoothing_transients
+        {
+            // 22050 Hz
+            {
+                {-3098, -2118}, {-3850, -2813}, {-2608, -1135}, {-3887, -2960},
+                {-4790, -4047}, {-5489, -4602}, {-6036, -5256}, {-5684, -4595},
+                {-2324, -1262}, {-1346, -980}, {-1366, -1043}, {-1335, -993},
+                {-1338, -695}, {-1313, -965}, {-1403, -1043}, {-2869, -1628},
+                {-5285, -4338}, {-5646, -5010}, {-6017, -5475}, {-5120, -4659},
+                {-4526, -3468}, {-1532, -953}, {-1338, -609}, {-1359, -1017},
+                {-1343, -1026},
+            },
+            // 44100 Hz
+            {
+                {-3062, -2178}, {-3746, -2496}, {-2632, -866}, {-4807, -3372},
+                {-5425, -4932}, {-6051, -5277}, {-5787, -4981}, {-5217, -4287},
+                {-2252, -1184}, {-1349, -1011}, {-1342, -1006}, {-1347, -1005},
+                {-1338, -637}, {-1334, -999}, {-1396, -1034}, {-2796, -1594},
+                {-5300, -4789}, {-6007, -5203}, {-5669, -5248}, {-6509, -5487},
+                {-4953, -3597}, {-1560, -989}, {-1343, -557}, {-1335, -997},
+                {-1338, -1014},
+            },
+            // 48000 Hz
+            {
+                {-3125, -2189}, {-3862, -2588}, {-2838, -1019}, {-5020, -3544},
+                {-5921, -5056}, {-6287, -5463}, {-5802, -5304}, {-5890, -4760},
+                {-2259, -1214}, {-1356, -1023}, {-1352, -1026}, {-1348, -1005},
+                {-1339, -616}, {-1347, -1005}, {-1398, -1034}, {-2766, -1522},
+                {-6000, -4914}, {-6143, -5446}, {-5947, -5415}, {-5945, -5155},
+                {-4686, -3570}, {-1580, -988}, {-1354, -551}, {-1350, -1022},
+                {-1344, -1013},
+            },
+            // 96000 Hz
+            {
+                {-3216, -2079}, {-4434, -2872}, {-2995, -1209}, {-4759, -3240},
+                {-6581, -5625}, {-6757, -5791}, {-6636, -5686}, {-5979, -4766},
+                {-2308, -1231}, {-1350, -1025}, {-1336, -1005}, {-1338, -964},
+                {-1320, -507}, {-1323, -989}, {-1373, -997}, {-2739, -1467},
+                {-6304, -4990}, {-6737, -5819}, {-6602, -5678}, {-6496, -5302},
+                {-4664, -3751}, {-1544, -951}, {-1325, -523}, {-1340, -981},
+                {-1348, -1027},
+            },
+        },
+        // whitening_residual
+        {
+            // 22050 Hz
+            {
+                {-3068, -2118}, {-3104, -2125}, {-2734, -1066}, {-2942, -2017},
+                {-2913, -1864}, {-2896, -1927}, {-3000, -2006}, {-2967, -1980},
+                {-3015, -2025}, {-3094, -2245}, {-3090, -2087}, {-3319, -2314},
+                {-3025, -1546}, {-3181, -2177}, {-3101, -2057}, {-3023, -2075},
+                {-2984, -2111}, {-2964, -1963}, {-2987, -2157}, {-2994, -2085},
+                {-3016, -2058}, {-3281, -2302}, {-3132, -1793}, {-3189, -2109},
+                {-3091, -2154},
+            },
+            // 44100 Hz
+            {
+                {-3044, -2085}, {-3204, -2196}, {-2933, -1467}, {-3132, -2159},
+                {-3063, -2189}, {-3119, -2218}, {-3104, -2160}, {-3172, -2195},
+                {-3216, -2200}, {-3255, -2009}, {-3280, -2215}, {-3404, -2375},
+                {-3180, -1555}, {-3405, -2495}, {-3270, -2339}, {-3225, -2302},
+                {-3220, -2185}, {-3170, -2245}, {-3180, -2264}, {-3209, -2168},
+                {-3203, -2093}, {-3477, -2285}, {-3246, -1604}, {-3372, -2383},
+                {-3274, -2316},
+            },
+            // 48000 Hz
+            {
+                {-3110, -2189}, {-3314, -2267}, {-2914, -1364}, {-3168, -2146},
+                {-3130, -2154}, {-3153, -2258}, {-3126, -2006}, {-3154, -2203},
+                {-3239, -2240}, {-3283, -2229}, {-3249, -2231}, {-3483, -2576},
+                {-3185, -1400}, {-3334, -2375}, {-3278, -2239}, {-3220, -2214},
+                {-3162, -2229}, {-3181, -2298}, {-3133, -2072}, {-3125, -2169},
+                {-3196, -2182}, {-3481, -2147}, {-3207, -1730}, {-3355, -2248},
+                {-3265, -2284},
+            },
+            // 96000 Hz
+            {
+                {-3121, -2079}, {-3354, -2228}, {-3117, -1682}, {-3393, -2276},
+                {-3313, -2316}, {-3320, -2326}, {-3298, -2325}, {-3339, -2199},
+                {-3374, -2329}, {-3415, -2302}, {-3429, -2411}, {-3637, -2578},
+                {-3355, -1659}, {-3496, -2464}, {-3405, -2349}, {-3368, -2276},
+                {-3334, -2380}, {-3312, -2295}, {-3297, -2227}, {-3323, -2358},
+                {-3371, -2375}, {-3606, -2374}, {-3389, -1891}, {-3510, -2380},
+                {-3408, -2267},
+            },
+        },
+        // postfilter
+        {
+            // 22050 Hz
+            {
+                {-3097, -2118}, {-3855, -2751}, {-2697, -1152}, {-4922, -3905},
+                {-5133, -4621}, {-5401, -4536}, {-5748, -4891}, {-5840, -5036},
+                {-3513, -2496}, {-2597, -2186}, {-2702, -2273}, {-2569, -1946},
+                {-2230, -893}, {-2636, -2113}, {-2587, -2152}, {-4039, -2778},
+                {-5204, -4420}, {-5193, -4293}, {-5915, -5208}, {-5136, -4565},
+                {-4555, -3927}, {-2659, -1956}, {-2171, -906}, {-2647, -2179},
+                {-2630, -2196},
+            },
+            // 44100 Hz
+            {
+                {-3062, -2178}, {-3741, -2480}, {-2730, -967}, {-5142, -3708},
+                {-5369, -4715}, {-5914, -5003}, {-5671, -4717}, {-5127, -4192},
+                {-3363, -2232}, {-2599, -2157}, {-2815, -2422}, {-2710, -2102},
+                {-2359, -854}, {-2842, -2292}, {-2674, -2239}, {-4019, -2796},
+                {-5145, -4353}, {-5581, -4530}, {-5485, -4639}, {-5413, -4421},
+                {-5287, -4360}, {-2795, -2030}, {-2370, -926}, {-2758, -2303},
+                {-2611, -2219},
+            },
+            // 48000 Hz
+            {
+                {-3124, -2189}, {-3846, -2574}, {-2828, -1019}, {-5206, -3680},
+                {-5612, -4583}, {-5877, -4989}, {-5624, -4622}, {-5661, -4628},
+                {-3013, -1960}, {-2365, -1924}, {-2528, -2116}, {-2636, -2115},
+                {-2361, -898}, {-2518, -2033}, {-2307, -1843}, {-3798, -2502},
+                {-5477, -4563}, {-5597, -4640}, {-5675, -4875}, {-5778, -4796},
+                {-5670, -4636}, {-2582, -1923}, {-2209, -933}, {-2400, -2006},
+                {-2400, -2022},
+            },
+            // 96000 Hz
+            {
+                {-3214, -2079}, {-4280, -2836}, {-2894, -1066}, {-5194, -3621},
+                {-5781, -4751}, {-5742, -4830}, {-5751, -4829}, {-5656, -4560},
+                {-3151, -2040}, {-2290, -1879}, {-2408, -2048}, {-2442, -1813},
+                {-2070, -795}, {-2276, -1889}, {-2270, -1853}, {-3610, -2294},
+                {-5549, -4476}, {-5835, -4763}, {-5691, -4605}, {-5563, -4419},
+                {-5135, -4041}, {-2406, -1779}, {-2189, -826}, {-2572, -2053},
+                {-2433, -2043},
+            },
+        },
+        // eco
+        {
+            // 22050 Hz
+            {
+                {-3073, -2118}, {-3343, -2290}, {-2817, -1288}, {-5586, -4768},
+                {-5430, -4981}, {-5786, -5144}, {-6390, -5680}, {-5831, -5295},
+                {-2300, -1259}, {-1352, -988}, {-1366, -1036}, {-1336, -983},
+                {-1336, -636}, {-1315, -977}, {-1403, -1024}, {-2931, -1706},
+                {-4632, -3543}, {-5855, -5128}, {-6634, -5916}, {-5165, -4562},
+                {-4529, -3441}, {-1532, -979}, {-1352, -701}, {-1360, -998},
+                {-1347, -999},
+            },
+            // 44100 Hz
+            {
+                {-3042, -2106}, {-3313, -2278}, {-2793, -1039}, {-5623, -4724},
+                {-5308, -4975}, {-6335, -5382}, {-5788, -5255}, {-5419, -5027},
+                {-2265, -1180}, {-1353, -1007}, {-1347, -972}, {-1347, -1002},
+                {-1331, -568}, {-1338, -977}, {-1395, -1009}, {-2877, -1652},
+                {-5395, -4909}, {-5918, -5200}, {-5523, -5160}, {-6738, -5725},
+                {-5556, -3805}, {-1559, -984}, {-1358, -702}, {-1338, -986},
+                {-1342, -1018},
+            },
+            // 48000 Hz
+            {
+                {-3109, -2189}, {-3408, -2346}, {-3044, -1234}, {-5967, -4906},
+                {-5335, -4902}, {-5953, -5241}, {-5234, -4938}, {-5717, -5128},
+                {-2254, -1176}, {-1363, -1028}, {-1355, -988}, {-1346, -1015},
+                {-1331, -546}, {-1347, -974}, {-1402, -999}, {-2829, -1534},
+                {-5733, -4929}, {-5784, -5221}, {-5355, -4930}, {-5374, -4642},
+                {-4432, -3606}, {-1591, -1001}, {-1362, -650}, {-1356, -991},
+                {-1348, -988},
+            },
+            // 96000 Hz
+            {
+                {-3344, -2079}, {-4715, -2965}, {-2970, -1148}, {-5234, -3649},
+                {-6405, -5467}, {-6831, -5786}, {-6841, -5933}, {-4899, -3782},
+                {-2328, -1236}, {-1353, -1024}, {-1333, -979}, {-1339, -992},
+                {-1329, -629}, {-1327, -970}, {-1374, -990}, {-2750, -1460},
+                {-6862, -5576}, {-6913, -5858}, {-6777, -5730}, {-6598, -5160},
+                {-4477, -3468}, {-1551, -953}, {-1336, -651}, {-1339, -957},
+                {-1350, -1000},
+            },
+        },
+        // hq
+        {
+            // 22050 Hz
+            {
+                {-3135, -2120}, {-3934, -2870}, {-2528, -1026}, {-3895, -2938},
+                {-4693, -3920}, {-4952, -3879}, {-5722, -4869}, {-5235, -4341},
+                {-2328, -1256}, {-1344, -984}, {-1367, -1045}, {-1336, -998},
+                {-1333, -615}, {-1314, -968}, {-1402, -1042}, {-2865, -1621},
+                {-5210, -4257}, {-5932, -5032}, {-6500, -5782}, {-5696, -5078},
+                {-4747, -3604}, {-1532, -985}, {-1345, -664}, {-1359, -1022},
+                {-1343, -1023},
+            },
+            // 44100 Hz
+            {
+                {-3099, -2178}, {-3938, -2723}, {-2574, -840}, {-4575, -3117},
+                {-5854, -5016}, {-6335, -5337}, {-6020, -4947}, {-5020, -3695},
+                {-2244, -1169}, {-1347, -1014}, {-1343, -1010}, {-1348, -998},
+                {-1333, -579}, {-1334, -1000}, {-1396, -1035}, {-2800, -1594},
+                {-5629, -4629}, {-6354, -5296}, {-6109, -5415}, {-6152, -5230},
+                {-4686, -3569}, {-1562, -995}, {-1348, -612}, {-1334, -997},
+                {-1338, -1025},
+            },
+            // 48000 Hz
+            {
+                {-3162, -2194}, {-4031, -2775}, {-2759, -974}, {-4772, -3329},
+                {-5807, -4891}, {-6172, -5282}, {-5850, -5171}, {-5404, -4226},
+                {-2254, -1197}, {-1354, -1013}, {-1353, -1027}, {-1347, -1006},
+                {-1336, -568}, {-1348, -1011}, {-1395, -1021}, {-2770, -1536},
+                {-5608, -4412}, {-6151, -5407}, {-6046, -5451}, {-5917, -5008},
+                {-4746, -3480}, {-1581, -1012}, {-1362, -589}, {-1348, -1020},
+                {-1343, -1015},
+            },
+            // 96000 Hz
+            {
+                {-3173, -2079}, {-4031, -2562}, {-2843, -1050}, {-4884, -3320},
+                {-6598, -5599}, {-6726, -5713}, {-6671, -5671}, {-6217, -4962},
+                {-2300, -1217}, {-1350, -1026}, {-1335, -1005}, {-1339, -1004},
+                {-1327, -576}, {-1323, -999}, {-1372, -1001}, {-2746, -1457},
+                {-6310, -4936}, {-6731, -5750}, {-6508, -5511}, {-6231, -4802},
+                {-4702, -3750}, {-1544, -979}, {-1332, -624}, {-1339, -989},
+                {-1348, -1028},
+            },
+        },
+};
+
+static const int16_t regression_fingerprint[REGRESSION_REFERENCE_CASE_COUNT]
+    [REGRESSION_REFERENCE_SAMPLE_RATE_COUNT][100U] = {
+        // wiener_mean_snr
+        {
+            // 22050 Hz
+            {
+                -327, -165, -356, 287, -126, -85, 64, -38,
+                135, 100, -247, -70, 223, 284, 15, -207,
+                34, 28, 58, -14, 43, 13, 36, 4,
+                15, 25, 36, 69, 2, -37, -41, -4,
+                -13, 82, -73, -897, -949, 1985, 2132, -193,
+                -2183, -1490, 1455, 2292, 160, -2166, -1847, 1163,
+                2466, 1097, -2441, -1730, 874, 2579, 1027, -1999,
+                -2207, 367, 2410, 1235, -1043, -191, -27, -45,
+                -151, -88, 77, 87, -56, 85, -19, 11,
+                -3, 20, -6, -2, -3, 13, -4, -6,
+                -12, -101, -25, -86, 33, 81, -1952, -2099,
+                1008, 1961, 1235, -1949, -1941, 611, 2351, 859,
+                -1963, -2161, 258, 2343,
+            },
+            // 44100 Hz
+            {
+                -524, -300, 195, 586, 41, -75, -14, 88,
+                -55, 181, -655, 93, -172, 29, -165, -41,
+                -33, -19, -26, -24, -16, -7, -17, -3,
+                -9, -3, -9, -36, 5, -65, 41, 132,
+                82, 56, -176, -778, -1891, 638, 2465, 1192,
+                -1564, -2300, 66, 2206, 1491, -1346, -2457, -205,
+                2094, 1611, -1195, -2356, -627, 2087, 2201, -464,
+                -2537, -861, 1889, 2157, -245, -542, 72, 137,
+                110, 42, 33, 110, -32, 45, -41, -20,
+                -61, -19, -53, -152, -82, 27, -75, 144,
+                -75, 2, 75, -86, 73, 373, -1003, -2526,
+                -419, 2095, 2383, -895, -2394, -918, 2004, 2084,
+                -399, -2299, -1210, 1957,
+            },
+            // 48000 Hz
+            {
+                -168, -162, 41, 88, -169, 197, -80, -19,
+                181, 54, -357, 205, -100, 26, 33, -22,
+                123, -6, 153, 51, 105, 46, -71, 23,
+                5, -23, -1, -23, -21, 0, 1, -32,
+                0, -203, -171, -907, -513, 2177, 1785, -1129,
+                -2430, -744, 1977, 1815, -999, -2396, -353, 2123,
+                1496, -747, -2919, -478, 2194, 1715, -1008, -2391,
+                -413, 1971, 1706, -1000, -1422, -20, -19, -22,
+                43, -105, 80, 91, 91, 104, 12, 34,
+                -58, 27, -14, -5, 19, 27, -5, -25,
+                -6, 37, -1, -21, -16, -911, -506, 2011,
+                1371, -1159, -2247, -77, 2337, 1838, -1199, -2442,
+                -568, 2229, 1871, -968,
+            },
+            // 96000 Hz
+            {
+                -258, 70, 346, -154, 65, -104, -24, -99,
+                -134, -49, 239, 5, 40, -106, -7, 2,
+                -20, -61, 37, 17, 0, -18, 87, 1,
+                110, 8, -37, -33, -66, -46, 1, -47,
+                30, 86, 81, -840, -482, 2139, 1960, -995,
+                -2490, -710, 2052, 1759, -1059, -2425, -664, 2145,
+                2145, -1110, -2921, -491, 2218, 1949, -1052, -2428,
+                -496, 2193, 1666, -1055, -1493, 15, 135, 19,
+                81, 151, -21, 21, -47, -34, -69, -91,
+                75, -5, -95, 30, 87, -42, -46, 48,
+                70, 138, 29, -136, -26, -964, -444, 2412,
+                1731, -1254, -2551, -551, 1949, 1919, -1154, -2410,
+                -528, 2195, 1815, -893,
+            },
+        },
+        // gates_median_bands
+        {
+            // 22050 Hz
+            {
+                -327, -165, -355, 289, -151, -76, 108, -30,
+                148, 150, -320, -38, 333, 383, 17, -301,
+                73, 14, 81, -38, 43, 1, 111, 57,
+                63, 25, 74, 141, 42, -85, -67, -6,
+                -29, 135, -96, -901, -925, 1953, 2127, -243,
+                -2153, -1484, 1447, 2294, 187, -2081, -1904, 1183,
+                2456, 1167, -2520, -1745, 883, 2520, 1061, -1992,
+                -2203, 381, 2456, 1256, -1075, -142, 14, -9,
+                -178, -172, 112, 54, -98, 151, -15, 49,
+                65, 105, -18, 41, -62, 64, 44, -17,
+                -46, -203, -25, -48, -5, 84, -2019, -2136,
+                1017, 1959, 1260, -1929, -1944, 624, 2282, 843,
+                -1976, -2147, 273, 2294,
+            },
+            // 44100 Hz
+            {
+                -524, -300, 195, 589, 39, -52, -66, 96,
+                -73, 99, -740, 24, -292, -7, -301, -76,
+                -94, -56, -71, 30, 10, 0, -106, -47,
+                -121, 35, -62, -66, 68, -75, 74, 162,
+                173, 43, -165, -748, -1907, 605, 2419, 1203,
+                -1507, -2292, 65, 2187, 1485, -1348, -2415, -189,
+                2125, 1686, -1191, -2320, -577, 2147, 2213, -477,
+                -2530, -928, 1953, 2158, -267, -645, 41, 178,
+                112, 28, 111, 150, -42, 82, -96, 25,
+                -151, -34, -134, -304, -199, 54, -79, 179,
+                -39, 26, 113, -172, 41, 416, -1016, -2556,
+                -415, 2054, 2475, -973, -2491, -963, 1967, 2114,
+                -424, -2321, -1175, 1908,
+            },
+            // 48000 Hz
+            {
+                -168, -162, 42, 91, -172, 220, -100, -17,
+                264, -3, -416, 280, -203, -17, 133, -89,
+                196, -19, 261, 73, 142, 81, -110, 52,
+                -14, -39, -7, -75, -61, 8, 49, -29,
+                5, -224, -109, -881, -544, 2170, 1761, -1148,
+                -2368, -748, 2028, 1829, -948, -2451, -316, 2138,
+                1441, -770, -2907, -449, 2221, 1622, -984, -2365,
+                -471, 1968, 1746, -1016, -1488, 4, -21, 22,
+                99, -125, 116, 127, 128, 189, -33, 36,
+                -102, 11, -71, -78, 18, 77, -18, -131,
+                19, 32, 34, -3, -13, -974, -451, 2021,
+                1369, -1225, -2227, -14, 2407, 1844, -1209, -2439,
+                -561, 2266, 1856, -997,
+            },
+            // 96000 Hz
+            {
+                -258, 70, 344, -187, 55, -134, -21, -188,
+                -149, -5, 309, 8, 26, -152, 6, 1,
+                -65, -52, 49, 45, -7, 42, 83, -36,
+                161, -21, -103, -83, -106, -55, -52, -37,
+                25, 153, 125, -835, -467, 2190, 1944, -1036,
+                -2511, -739, 2105, 1748, -1011, -2450, -726, 2093,
+                2157, -1102, -2884, -518, 2209, 1915, -1027, -2409,
+                -507, 2223, 1689, -1076, -1471, 31, 138, 19,
+                130, 196, -71, 38, -128, -51, -64, -210,
+                105, 27, -180, 32, 186, -100, -46, 91,
+                118, 147, 41, -205, -29, -984, -424, 2419,
+                1699, -1319, -2608, -477, 2012, 1901, -1137, -2393,
+                -585, 2154, 1819, -867,
+            },
+        },
+        // gss_max_masking
+        {
+            // 22050 Hz
+            {
+                -327, -165, -355, 310, -85, 50, 211, -129,
+                108, 141, -149, -5, 242, 411, -45, -126,
+                -27, 186, 143, -122, 156, 325, 579, 297,
+                72, 210, 113, 333, -248, -172, -146, 8,
+                -131, 68, -5, -883, -701, 1902, 2190, 100,
+                -2225, -1666, 1358, 2609, 284, -2216, -783, 2733,
+                3839, 1703, -2211, -1904, 888, 2234, 1290, -2310,
+                -2358, 484, 2492, 926, -1176, 262, -477, 194,
+                -218, -61, 70, 103, 99, 168, -15, 195,
+                -393, 264, -26, 406, 109, -219, -2, 297,
+                250, 152, 44, -97, -289, -92, -1868, -1975,
+                1111, 2004, 1379, -2165, -1648, 754, 2004, 801,
+                -1772, -1761, 328, 2215,
+            },
+            // 44100 Hz
+            {
+                -524, -300, 194, 571, 88, -203, 153, 109,
+                -45, 313, -866, 133, -48, 167, 325, -117,
+                -424, -414, -444, 149, 186, -145, -63, 374,
+                -61, -199, 186, 97, -14, -445, -2, 9,
+                -51, 89, -334, -960, -1644, 811, 2379, 964,
+                -1471, -2219, 64, 2264, 1737, -1352, -2453, -229,
+                2243, 1500, -1084, -2402, -807, 2463, 2433, -371,
+                -2926, -698, 2131, 2348, 77, -592, 431, 409,
+                -51, -210, -62, 15, 239, 200, -30, -59,
+                -314, -505, -117, -363, -25, -284, -317, -1055,
+                -720, -429, -334, 437, -18, 298, -825, -2496,
+                -723, 2117, 2421, -1063, -2501, -574, 2103, 1839,
+                -437, -2312, -1269, 2316,
+            },
+            // 48000 Hz
+            {
+                -168, -162, 42, 80, -116, 198, 21, 11,
+                16, 90, -341, 132, -227, 129, -145, 4,
+                354, 76, 304, 17, 190, -77, -125, -235,
+                -250, -188, 212, -149, -214, -52, 167, -12,
+                -38, -7, -257, -1016, -638, 2224, 1579, -802,
+                -2123, -780, 1974, 2042, -1149, -2234, -182, 1966,
+                1470, -635, -2918, -183, 2184, 1723, -1053, -2290,
+                -975, 1806, 2891, -656, -1966, 319, 150, 257,
+                -41, -253, 30, -90, 43, -31, -172, 57,
+                27, 267, -109, 211, 363, 110, -74, 68,
+                -187, -63, 37, 34, -17, -948, -647, 1912,
+                1341, -1320, -2261, -42, 2752, 2416, -573, -2228,
+                -306, 2571, 1807, -710,
+            },
+            // 96000 Hz
+            {
+                -258, 64, 271, -241, 104, -107, -119, 37,
+                -346, -153, 377, 42, 211, 112, 17, 212,
+                -251, -379, -89, 576, -109, 593, 88, 20,
+                301, -193, -6, 199, -12, -340, -234, 249,
+                135, 7, 163, -1099, -521, 2244, 1892, -936,
+                -2236, -479, 2308, 2211, -1136, -2546, -591, 2208,
+                2061, -974, -2878, -403, 2193, 2165, -920, -2295,
+                -368, 2009, 1790, -1282, -1414, -301, 686, 33,
+                -280, -68, -164, -156, 211, -115, -75, -164,
+                308, 306, -45, -173, -176, 186, 72, 196,
+                64, 143, -254, -513, -123, -761, -359, 2389,
+                1906, -1458, -2432, -649, 2032, 1966, -1375, -2631,
+                -310, 2114, 1783, -607,
+            },
+        },
+        // smoothing_transients
+        {
+            // 22050 Hz
+            {
+                -327, -165, -356, 275, -111, -71, 35, -32,
+                30, 72, -92, -51, 128, 235, 9, -161,
+                49, 52, 42, 18, 25, 12, 23, 4,
+                1, -2, -6, 1, -4, -4, -4, 1,
+                8, 19, -14, -864, -950, 1807, 2226, -235,
+                -2316, -1347, 1389, 2355, 201, -2213, -1737, 1039,
+                2465, 948, -2016, -1761, 814, 2629, 977, -1944,
+                -2142, 368, 2359, 1261, -991, -314, 34, -33,
+                -13, -2, 0, -6, -7, -7, -9, -9,
+                -11, -3, -8, -5, -8, -10, -17, -28,
+                -33, -37, -35, -87, 35, 84, -1797, -2030,
+                1012, 1996, 1254, -1937, -1961, 697, 2372, 910,
+                -1882, -2143, 300, 2330,
+            },
+            // 44100 Hz
+            {
+                -524, -300, 194, 580, 26, -80, -13, 21,
+                -77, 154, -659, 69, -131, 34, -36, -10,
+                -19, -14, -21, -14, -15, -9, -8, -2,
+                -1, -2, -6, -17, -15, -25, -17, 11,
+                5, 33, -138, -725, -1811, 578, 2429, 1263,
+                -1566, -2362, 137, 2310, 1397, -1360, -2394, -364,
+                2107, 1589, -1018, -2424, -698, 2069, 2105, -551,
+                -2398, -995, 1807, 2095, -241, -496, 48, 34,
+                37, 20, 18, 21, 13, 10, -3, -6,
+                -16, -15, -16, -17, -11, -3, -5, 9,
+                -4, 0, 1, -41, 108, 456, -974, -2474,
+                -396, 2063, 2261, -964, -2435, -841, 2027, 2074,
+                -485, -2418, -1130, 1797,
+            },
+            // 48000 Hz
+            {
+                -168, -162, 41, 87, -153, 169, -45, -17,
+                54, 162, -231, 47, -65, 22, 26, 2,
+                19, 8, 16, 9, 10, 3, -7, -5,
+                -8, -13, -9, -12, -9, -4, -2, -10,
+                -23, -134, -97, -946, -389, 2164, 1799, -1020,
+                -2434, -536, 2124, 1808, -1053, -2392, -403, 2181,
+                1611, -696, -2646, -294, 2166, 1745, -1035, -2390,
+                -474, 2122, 1774, -986, -1420, -83, -6, 14,
+                25, 5, 9, 5, 7, 8, 6, 7,
+                3, 9, 7, 9, 11, 14, 4, -1,
+                1, 28, 8, -59, -105, -994, -482, 2053,
+                1473, -1193, -2250, -134, 2268, 1820, -1103, -2409,
+                -486, 2147, 1828, -1030,
+            },
+            // 96000 Hz
+            {
+                -258, 70, 344, -138, 76, -85, -13, 0,
+                -76, -161, 145, 36, -5, -1, 23, 8,
+                1, -1, 3, 4, 5, 5, 4, -2,
+                4, -5, -6, -6, -1, 4, 7, 1,
+                -1, -21, 19, -830, -423, 2169, 1892, -983,
+                -2446, -617, 2145, 1853, -1007, -2456, -574, 2120,
+                2085, -1073, -2801, -474, 2167, 1960, -984, -2506,
+                -474, 2158, 1839, -953, -1514, 6, 51, 6,
+                21, 11, -4, 1, -1, -1, 1, -1,
+                6, 2, -5, -4, -3, -5, -3, 5,
+                9, 14, 13, -66, 1, -943, -430, 2390,
+                1819, -1249, -2560, -547, 2098, 1922, -1058, -2433,
+                -580, 2117, 1828, -994,
+            },
+        },
+        // whitening_residual
+        {
+            // 22050 Hz
+            {
+                -327, -165, -358, 306, -202, -92, 51, -23,
+                84, 286, -307, -61, 313, 336, 203, -460,
+                15, 521, 385, 489, -102, -42, 43, -92,
+                271, 374, 106, 471, -207, 89, 142, -223,
+                -137, 400, -90, -121, 4, 488, -176, 343,
+                171, -644, 269, -266, 79, -50, -38, 4,
+                -139, 327, -94, 157, 199, -553, 244, -205,
+                -139, 16, 283, -260, -31, 445, -152, 301,
+                -309, -139, 237, -162, 206, -8, 22, -114,
+                -754, 228, -322, 202, 200, -57, 0, -86,
+                80, 232, -167, -227, -186, -144, -260, -99,
+                38, 18, 152, 54, 119, -42, -140, -533,
+                191, 246, 173, -89,
+            },
+            // 44100 Hz
+            {
+                -524, -300, 193, 603, -22, -183, 108, 356,
+                326, 69, -52, 302, -428, 0, -369, -157,
+                -167, 145, -168, 276, 207, -194, 11, 201,
+                -30, 120, 43, -261, 36, -373, -384, 165,
+                254, 53, -164, -315, 63, -3, -111, -40,
+                24, 234, -46, 54, 392, 49, -23, 86,
+                -100, 165, -188, 185, -101, 45, 274, 255,
+                -206, 471, 182, -95, 94, 93, 175, 84,
+                208, 222, -261, 114, 254, 292, -170, 102,
+                -382, -11, -200, -349, -203, -4, -107, 373,
+                105, -161, 114, 184, 6, -285, -5, -174,
+                -239, 14, 144, 12, -4, -22, -100, -179,
+                165, 80, -200, 388,
+            },
+            // 48000 Hz
+            {
+                -168, -162, 42, 87, -136, 323, 45, -98,
+                162, -231, -72, 157, -339, 76, 23, 15,
+                298, 148, 467, 136, 92, 133, -234, -90,
+                3, -390, 172, -227, -255, -47, -87, 187,
+                43, -16, -452, 9, -125, 345, 24, 41,
+                -298, -343, -113, 4, 180, 70, 119, -170,
+                -14, -15, -345, -240, 142, -37, -213, 46,
+                -145, -72, 303, -149, -57, 450, -130, 420,
+                -90, -272, 242, -154, -97, 25, -197, -192,
+                -307, -157, 77, 169, 269, 224, -182, -291,
+                108, -81, 195, 35, -6, -78, -187, -64,
+                -98, 99, -179, -24, 98, -16, -55, -221,
+                -273, 276, 175, -176,
+            },
+            // 96000 Hz
+            {
+                -258, 70, 354, -133, 216, -346, 26, -158,
+                19, 100, 166, 151, 0, 257, -188, 24,
+                -67, -234, -72, 153, 257, 239, 139, -114,
+                344, -227, -174, -334, -26, 96, 135, 82,
+                294, 251, 313, 192, -139, 108, 157, 45,
+                -145, 43, -62, -20, -218, -90, -107, 0,
+                97, -117, -184, -84, -12, 14, -178, 248,
+                -58, -14, 66, -89, 241, 17, -17, -104,
+                197, 142, -180, 220, -31, -183, -67, -227,
+                180, 70, -236, -231, -58, 147, -3, 58,
+                152, 276, -39, -90, -70, 67, -2, 206,
+                -53, -162, -122, -55, -117, 99, -252, -10,
+                251, -76, -145, 225,
+            },
+        },
+        // postfilter
+        {
+            // 22050 Hz
+            {
+                -327, -165, -356, 277, -112, -65, 34, -62,
+                124, 55, -170, -68, 117, 72, 16, -17,
+                16, 22, 28, 21, 26, 16, 18, 7,
+                2, 1, -1, 10, -4, -12, -5, 3,
+                -2, 47, -27, -235, -252, 492, 477, -62,
+                -491, -365, 306, 477, 26, -459, -418, 267,
+                729, 492, -909, -430, 285, 521, 232, -422,
+                -510, 99, 616, 319, -275, -18, -4, -1,
+                -26, -11, 25, 8, -20, 5, -16, -8,
+                -13, 1, -8, -5, -7, -5, -16, -29,
+                -33, -50, -40, -43, -22, 18, -493, -632,
+                249, 581, 663, -619, -526, 126, 479, 160,
+                -468, -524, 56, 531,
+            },
+            // 44100 Hz
+            {
+                -524, -300, 194, 581, 24, -73, -4, 41,
+                -46, 138, -387, 39, -83, 11, -34, -17,
+                -18, -14, -19, -14, -11, -9, -12, -1,
+                -4, -1, -8, -22, -13, -28, -11, 15,
+                16, 28, -36, -185, -506, 180, 600, 264,
+                -288, -393, 5, 401, 281, -256, -512, -28,
+                490, 359, -325, -456, -138, 357, 391, -50,
+                -484, -156, 443, 547, -63, -126, 28, 46,
+                44, 26, 20, 35, 9, 16, -6, -11,
+                -22, -18, -25, -36, -18, 3, -18, 35,
+                -10, -13, 20, -21, 10, 56, -222, -612,
+                -106, 623, 920, -199, -478, -214, 357, 400,
+                -100, -510, -263, 460,
+            },
+            // 48000 Hz
+            {
+                -168, -162, 41, 87, -157, 178, -37, -20,
+                103, 87, -234, 124, -80, 2, 17, 4,
+                25, 10, 28, 16, 15, 7, -17, -5,
+                -5, -14, -6, -17, -13, -3, -7, -4,
+                0, -57, -76, -390, -185, 728, 539, -309,
+                -666, -211, 503, 451, -233, -546, -73, 445,
+                225, -40, -909, -156, 506, 413, -236, -663,
+                -113, 678, 610, -355, -460, 9, -5, 16,
+                13, -15, 17, 21, 23, 17, 11, 8,
+                -10, 12, 3, 2, 11, 18, 4, -6,
+                6, 4, 0, -17, -7, -268, -169, 609,
+                349, -410, -757, 55, 749, 571, -356, -713,
+                -147, 667, 561, -299,
+            },
+            // 96000 Hz
+            {
+                -258, 70, 344, -142, 76, -82, -13, -37,
+                -98, -68, 226, 26, -8, -9, -7, 6,
+                -3, -14, 8, 8, 4, 1, 20, -6,
+                20, -4, -15, -11, -14, 4, 4, -3,
+                14, 8, 15, -290, -173, 746, 654, -300,
+                -759, -200, 604, 538, -285, -623, -167, 628,
+                817, -487, -1257, -185, 765, 687, -348, -761,
+                -161, 731, 616, -390, -584, 5, 24, -1,
+                22, 34, -6, 7, -8, -7, -12, -12,
+                20, 3, -16, 1, 18, -10, -11, 11,
+                20, 24, 12, -31, -3, -358, -191, 906,
+                582, -495, -950, -118, 516, 477, -276, -564,
+                -122, 617, 534, -253,
+            },
+        },
+        // eco
+        {
+            // 22050 Hz
+            {
+                -327, -165, -356, 289, -134, -126, 111, -22,
+                -5, 136, -82, 68, 4, 26, 7, -6,
+                15, 17, 22, 16, 16, 10, 11, 6,
+                6, 2, -4, -2, -2, 4, 10, 10,
+                9, -33, -55, -927, -987, 1758, 2208, -278,
+                -2237, -1464, 1404, 2305, 169, -2213, -1785, 1100,
+                2439, 1119, -2021, -1761, 718, 2656, 981, -1927,
+                -2148, 389, 2435, 1279, -928, -275, -28, -82,
+                -22, -2, -10, -11, -11, -7, -7, -5,
+                -6, 2, -4, -1, -2, -1, -8, -27,
+                -40, -44, -44, -32, -7, 69, -1758, -1968,
+                1019, 2064, 1228, -1894, -1960, 697, 2313, 876,
+                -1879, -2224, 290, 2308,
+            },
+            // 44100 Hz
+            {
+                -524, -300, 194, 597, 38, -116, 3, 120,
+                -52, 84, -549, 44, -31, -2, -22, -18,
+                -22, -18, -19, -15, -13, -7, -2, 0,
+                -4, -7, -10, -13, -12, -20, -18, -10,
+                -8, -3, -88, -657, -1807, 615, 2372, 1206,
+                -1587, -2445, 92, 2211, 1386, -1403, -2404, -249,
+                2071, 1458, -970, -2430, -628, 2083, 2107, -509,
+                -2381, -946, 1840, 2127, -245, -403, 40, 25,
+                22, 16, 15, 18, 11, 11, -1, -7,
+                -19, -17, -18, -19, -9, 0, -1, 5,
+                -4, -1, 3, -14, 47, 448, -971, -2444,
+                -231, 2052, 2036, -994, -2407, -810, 1987, 2114,
+                -467, -2399, -1141, 1825,
+            },
+            // 48000 Hz
+            {
+                -168, -162, 41, 90, -180, 307, -102, 6,
+                67, 221, -102, 5, -29, -1, 5, 8,
+                22, 20, 24, 18, 13, 0, -10, -10,
+                -15, -25, -19, -21, -20, -16, -8, 1,
+                -3, -40, -117, -910, -455, 2136, 1729, -1023,
+                -2469, -553, 2090, 1762, -966, -2496, -343, 2132,
+                1652, -618, -2745, -189, 1946, 1728, -998, -2497,
+                -468, 1988, 1825, -1004, -1401, -59, 15, 2,
+                16, 11, 15, 8, 5, 8, 10, 13,
+                10, 14, 15, 20, 21, 19, 13, 9,
+                -14, 71, 14, -36, 19, -744, -475, 2127,
+                1570, -1265, -2192, -168, 2428, 1693, -1182, -2475,
+                -517, 2291, 1781, -999,
+            },
+            // 96000 Hz
+            {
+                -258, 69, 304, -75, -1, -13, -9, 72,
+                -92, -183, 75, 20, -3, -14, 1, 8,
+                2, 1, 4, 5, 5, 4, 2, -3,
+                4, -4, -2, -2, 0, 7, 7, -44,
+                8, -89, -34, -764, -455, 2159, 1903, -961,
+                -2475, -662, 2186, 1824, -992, -2409, -656, 2026,
+                1968, -990, -2729, -466, 2105, 1831, -990, -2495,
+                -499, 2156, 1758, -1011, -1526, -61, 36, -5,
+                9, 3, -2, 3, 0, 0, 1, -3,
+                3, -1, -6, -2, 1, -1, -1, 6,
+                13, 41, 50, -94, -18, -990, -390, 2346,
+                1878, -1227, -2511, -484, 2069, 1930, -1169, -2414,
+                -578, 2202, 1787, -966,
+            },
+        },
+        // hq
+        {
+            // 22050 Hz
+            {
+                -327, -165, -347, 245, -92, -43, 43, -25,
+                64, 46, -138, -81, 243, 220, 2, -134,
+                58, -3, 46, -24, 40, -8, 27, -3,
+                15, 3, 13, 19, -4, -16, -11, -3,
+                5, 35, -28, -857, -985, 1845, 2258, -228,
+                -2279, -1389, 1422, 2361, 198, -2194, -1758, 1030,
+                2442, 965, -2070, -1714, 766, 2613, 1003, -1924,
+                -2155, 372, 2364, 1258, -1008, -305, 15, -42,
+                -23, -18, 10, -5, -4, 2, -5, -3,
+                -7, 1, -5, -1, -3, -5, -8, -14,
+                -19, -21, -11, -63, 27, 91, -1834, -2013,
+                989, 2059, 1250, -1988, -1931, 690, 2415, 922,
+                -1881, -2150, 298, 2324,
+            },
+            // 44100 Hz
+            {
+                -524, -300, 190, 528, 16, -50, 19, 25,
+                -45, 184, -636, 86, -199, 9, -69, -16,
+                -14, -4, -12, -8, -7, -3, -3, 1,
+                -5, -5, -2, -17, -4, -16, -2, 57,
+                39, 51, -143, -768, -1850, 575, 2431, 1241,
+                -1563, -2348, 150, 2322, 1409, -1346, -2390, -303,
+                2131, 1582, -1063, -2401, -675, 2042, 2103, -579,
+                -2407, -986, 1790, 2099, -259, -495, 7, 40,
+                30, 14, 10, 14, 4, 6, -4, -3,
+                -11, -9, -10, -13, -12, -3, -7, 12,
+                -8, 1, 9, -72, 110, 482, -983, -2422,
+                -373, 2188, 2119, -898, -2413, -814, 2003, 2076,
+                -507, -2423, -1108, 1788,
+            },
+            // 48000 Hz
+            {
+                -168, -162, 40, 78, -123, 122, -28, -27,
+                99, 150, -268, 137, -105, -11, 21, 1,
+                17, 2, 20, 7, 14, 7, -11, -5,
+                -3, -10, -7, -13, -11, -4, 4, -31,
+                -40, -139, -110, -934, -359, 2161, 1798, -1031,
+                -2419, -539, 2133, 1808, -1044, -2417, -369, 2229,
+                1599, -738, -2734, -409, 2153, 1741, -1017, -2383,
+                -472, 2103, 1766, -968, -1398, -75, 1, 17,
+                45, -5, 12, 6, 8, 9, 8, 5,
+                3, 7, 7, 7, 10, 14, 1, -7,
+                1, 10, 7, -45, -112, -992, -483, 2111,
+                1520, -1183, -2221, -217, 2219, 1816, -1075, -2444,
+                -459, 2168, 1820, -1040,
+            },
+            // 96000 Hz
+            {
+                -258, 70, 352, -154, 104, -154, 4, -3,
+                -105, -141, 197, -32, 1, 7, 6, 9,
+                3, -2, 3, 3, 5, 3, 4, -2,
+                4, -4, -6, -7, -1, 3, 4, -1,
+                11, -36, 11, -853, -439, 2164, 1917, -961,
+                -2428, -587, 2164, 1844, -1028, -2462, -602, 2115,
+                2046, -996, -2763, -486, 2092, 1917, -983, -2528,
+                -477, 2137, 1824, -974, -1530, -18, 35, -13,
+                20, 13, -2, 2, 0, -2, 1, -1,
+                7, 0, -7, -2, 0, -6, -6, 10,
+                11, 18, 21, -64, 17, -945, -438, 2246,
+                1878, -1211, -2625, -480, 2080, 1937, -1056, -2442,
+                -563, 2146, 1828, -987,
+            },
+        },
+};
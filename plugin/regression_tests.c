@@ -0,0 +1,506 @@
+// Copyright 2025 Sam Windell
+// SPDX-License-Identifier: LGPL-3.0
+//
+// Numerical regression tests. Deterministic signals go through the library
+// with the scalar kernels, which is the reference pipeline, and with every
+// optimized variant, at several sample rates and in every parameter mode.
+// Variants have to stay within a bound of the reference, and both have to
+// stay within a bound of what is checked in to regression_reference.h: the
+// RMS and peak level of each 20 ms block of output, and one output sample
+// every 5 ms. When a change to the processing is intended, regenerate them
+// with `regression-tests --generate > plugin/regression_reference.h` and
+// review the difference.
+
+#include "specbleach_denoiser.h"
+#include "utest.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LEARN_SECONDS 0.25F
+#define MEASURED_SECONDS 0.5F
+#define BLOCK_SIZE 512U
+#define LEVEL_BLOCKS_PER_SECOND 50U
+#define LEVEL_BLOCK_COUNT 25U
+#define LEVEL_FLOOR_DB -80.F
+#define MAX_MEASURED_SAMPLES 48000U
+#define FINGERPRINT_SAMPLE_COUNT 100U
+// Checked in samples are fixed point with this scale
+#define FINGERPRINT_SCALE 8192.F
+
+// Optimized variants against the reference. The current ones give the same
+// output, these leave room for kernels that round differently
+#define VARIANT_MAX_ABS_DIFFERENCE 1e-4F
+#define VARIANT_MAX_DIFFERENCE_DB -80.F
+// The reference against the checked in levels. Rounding of a different fft
+// can move single blocks around onsets by a few tenths of a dB, so blocks get
+// some room, but it doesn't move the levels as a whole the way a change to
+// the processing does, so their mean difference gets very little
+#define REFERENCE_MAX_RMS_DIFFERENCE_DB 0.35F
+#define REFERENCE_MAX_PEAK_DIFFERENCE_DB 0.75F
+#define REFERENCE_MAX_MEAN_DIFFERENCE_DB 0.05F
+// Checked in samples against the output of the reference and the variants.
+// Their fixed point is within 6e-5, and rounding of a different fft moves
+// samples by a few times that at most
+#define REFERENCE_MAX_ABS_DIFFERENCE 1e-3F
+
+typedef struct RegressionCase {
+  const char *name;
+  SpectralBleachPreset preset;
+  int gain_estimation_type;
+  SpectralBleachParameters parameters;
+} RegressionCase;
+
+#define BASE_PARAMETERS .reduction_amount = 20.F, .noise_rescale = 2.F
+
+// Every gain estimator, noise learning mode, noise scaling and preset, and
+// each of the optional stages on its own
+static const RegressionCase regression_cases[] = {
+    {"wiener_mean_snr", SPECBLEACH_PRESET_STANDARD, 0,
+     {BASE_PARAMETERS, .learn_noise = 1, .noise_scaling_type = 0,
+      .post_filter_threshold = -10.F}},
+    {"gates_median_bands", SPECBLEACH_PRESET_STANDARD, 1,
+     {BASE_PARAMETERS, .learn_noise = 2, .noise_scaling_type = 1,
+      .post_filter_threshold = -10.F}},
+    {"gss_max_masking", SPECBLEACH_PRESET_STANDARD, 2,
+     {BASE_PARAMETERS, .learn_noise = 3, .noise_scaling_type = 2,
+      .post_filter_threshold = -10.F}},
+    {"smoothing_transients", SPECBLEACH_PRESET_STANDARD, 0,
+     {BASE_PARAMETERS, .learn_noise = 1, .noise_scaling_type = 2,
+      .smoothing_factor = 50.F, .transient_protection = true,
+      .post_filter_threshold = -10.F}},
+    {"whitening_residual", SPECBLEACH_PRESET_STANDARD, 0,
+     {BASE_PARAMETERS, .learn_noise = 1, .whitening_factor = 100.F,
+      .residual_listen = true, .post_filter_threshold = -10.F}},
+    {"postfilter", SPECBLEACH_PRESET_STANDARD, 0,
+     {BASE_PARAMETERS, .learn_noise = 1, .post_filter_threshold = 10.F}},
+    {"eco", SPECBLEACH_PRESET_ECO, 0,
+     {BASE_PARAMETERS, .learn_noise = 1, .noise_scaling_type = 2,
+      .smoothing_factor = 50.F, .post_filter_threshold = -10.F}},
+    {"hq", SPECBLEACH_PRESET_HQ, 0,
+     {BASE_PARAMETERS, .learn_noise = 1, .noise_scaling_type = 2,
+      .smoothing_factor = 50.F, .whitening_factor = 50.F,
+      .post_filter_threshold = -10.F}},
+};
+
+static const uint32_t regression_sample_rates[] = {22050, 44100, 48000,
+                                                   96000};
+
+#define REGRESSION_CASE_COUNT                                                  \
+  (sizeof(regression_cases) / sizeof(regression_cases[0]))
+#define REGRESSION_SAMPLE_RATE_COUNT                                           \
+  (sizeof(regression_sample_rates) / sizeof(regression_sample_rates[0]))
+
+#include "regression_reference.h"
+
+static const char *kernel_isa_names[] = {"auto", "scalar", "sse2", "avx2",
+                                         "avx512"};
+
+// Everything is generated with plain arithmetic only, and this file is built
+// with -ffp-contract=off so it isn't fused either. The input is then the
+// same on every platform without depending on its libm
+
+typedef struct SignalGenerator {
+  uint32_t sample_rate;
+  uint32_t position;
+  uint32_t seed;
+  float lowpass;
+  float rotation[2];
+  float oscillator[2];
+  float tone_level;
+  float click_level;
+} SignalGenerator;
+
+// Cosine and sine of the small angles the oscillator rotates by, from their
+// series, which is exact in double precision well before the last term
+static void get_rotation(const double angle, float rotation[2]) {
+  double cosine = 0.0;
+  double sine = 0.0;
+  double term = 1.0;
+  for (uint32_t n = 0U; n < 20U; n++) {
+    const double signed_term = n % 4U < 2U ? term : -term;
+    if (n % 2U == 0U) {
+      cosine += signed_term;
+    } else {
+      sine += signed_term;
+    }
+    term *= angle / (double)(n + 1U);
+  }
+
+  rotation[0] = (float)cosine;
+  rotation[1] = (float)sine;
+}
+
+static void signal_generator_initialize(SignalGenerator *self,
+                                        const uint32_t sample_rate) {
+  *self = (SignalGenerator){
+      .sample_rate = sample_rate,
+      .seed = 1U,
+      .oscillator = {1.F, 0.F},
+  };
+  get_rotation(2.0 * 3.14159265358979323846 * 440.0 / (double)sample_rate,
+               self->rotation);
+}
+
+static float next_noise(uint32_t *seed) {
+  *seed = *seed * 1664525U + 1013904223U;
+  return ((float)(*seed >> 8) / (float)(1U << 24)) * 2.F - 1.F;
+}
+
+// Colored noise, and when asked, tone bursts and clicks over it so the
+// transient protection and the masking thresholds have something to act on.
+// The bursts fade in and out over 10 ms and the clicks decay over 2 ms
+static void generate_signal(SignalGenerator *self, const bool with_signal,
+                            float *signal, const uint32_t length) {
+  const float fade_step = 100.F / (float)self->sample_rate;
+  const float click_decay = 1.F - 500.F / (float)self->sample_rate;
+
+  for (uint32_t k = 0U; k < length; k++) {
+    self->lowpass = 0.9F * self->lowpass + 0.1F * next_noise(&self->seed);
+    float sample = 0.02F * next_noise(&self->seed) + 0.2F * self->lowpass;
+
+    if (with_signal) {
+      const float *rotation = self->rotation;
+      float *oscillator = self->oscillator;
+      const float real =
+          oscillator[0] * rotation[0] - oscillator[1] * rotation[1];
+      oscillator[1] = oscillator[0] * rotation[1] + oscillator[1] * rotation[0];
+      oscillator[0] = real;
+
+      const bool in_burst =
+          (self->position / (self->sample_rate / 8U)) % 2U == 1U;
+      self->tone_level = in_burst ? fminf(self->tone_level + fade_step, 1.F)
+                                  : fmaxf(self->tone_level - fade_step, 0.F);
+      sample += 0.3F * self->tone_level * oscillator[1];
+
+      if (self->position % (self->sample_rate / 5U) == 0U) {
+        self->click_level = 0.5F;
+      }
+      sample += self->click_level * next_noise(&self->seed);
+      self->click_level *= click_decay;
+
+      self->position++;
+    }
+
+    signal[k] = sample;
+  }
+}
+
+static SpectralBleachHandle create_instance(const RegressionCase *test_case,
+                                            const uint32_t sample_rate,
+                                            const int kernel_isa) {
+  SpectralBleachConfig config =
+      specbleach_get_preset_config(test_case->preset, sample_rate, 46.F);
+  config.gain_estimation_type = test_case->gain_estimation_type;
+  config.kernel_isa = kernel_isa;
+
+  return specbleach_initialize_with_config(&config);
+}
+
+// Learns the noise profile and returns the number of samples of output after
+// that, or 0 on failure
+static uint32_t render(SpectralBleachHandle instance,
+                       const RegressionCase *test_case,
+                       const uint32_t sample_rate, float *output) {
+  float input[BLOCK_SIZE];
+  float discarded[BLOCK_SIZE];
+  SignalGenerator generator;
+  signal_generator_initialize(&generator, sample_rate);
+
+  SpectralBleachParameters parameters = test_case->parameters;
+  if (!specbleach_load_parameters(instance, parameters)) {
+    return 0U;
+  }
+
+  const uint32_t learned = (uint32_t)(LEARN_SECONDS * (float)sample_rate);
+  for (uint32_t done = 0U; done < learned; done += BLOCK_SIZE) {
+    generate_signal(&generator, false, input, BLOCK_SIZE);
+    specbleach_process(instance, BLOCK_SIZE, input, discarded);
+  }
+
+  parameters.learn_noise = 0;
+  if (!specbleach_load_parameters(instance, parameters)) {
+    return 0U;
+  }
+
+  const uint32_t measured = (uint32_t)(MEASURED_SECONDS * (float)sample_rate);
+  for (uint32_t done = 0U; done < measured; done += BLOCK_SIZE) {
+    const uint32_t length =
+        measured - done < BLOCK_SIZE ? measured - done : BLOCK_SIZE;
+    generate_signal(&generator, true, input, length);
+    specbleach_process(instance, length, input, &output[done]);
+  }
+
+  return measured;
+}
+
+static float to_db(const float value) {
+  return fmaxf(20.F * log10f(fmaxf(value, 1e-30F)), LEVEL_FLOOR_DB);
+}
+
+// RMS and peak level of each block, in hundredths of a dB
+static void measure_levels(const float *output, const uint32_t sample_rate,
+                           int16_t levels[LEVEL_BLOCK_COUNT][2]) {
+  const uint32_t block_length = sample_rate / LEVEL_BLOCKS_PER_SECOND;
+
+  for (uint32_t block = 0U; block < LEVEL_BLOCK_COUNT; block++) {
+    const float *samples = &output[block * block_length];
+    double sum = 0.0;
+    float peak = 0.F;
+    for (uint32_t k = 0U; k < block_length; k++) {
+      sum += (double)samples[k] * (double)samples[k];
+      peak = fmaxf(peak, fabsf(samples[k]));
+    }
+
+    const float rms = (float)sqrt(sum / (double)block_length);
+    levels[block][0] = (int16_t)lroundf(to_db(rms) * 100.F);
+    levels[block][1] = (int16_t)lroundf(to_db(peak) * 100.F);
+  }
+}
+
+// Output samples evenly spaced over the measured output, in fixed point
+static void measure_fingerprint(const float *output, const uint32_t length,
+                                int16_t fingerprint[FINGERPRINT_SAMPLE_COUNT]) {
+  for (uint32_t i = 0U; i < FINGERPRINT_SAMPLE_COUNT; i++) {
+    const float sample = output[i * (length / FINGERPRINT_SAMPLE_COUNT)];
+    const float scaled = fminf(fmaxf(sample * FINGERPRINT_SCALE, -32768.F),
+                               32767.F);
+    fingerprint[i] = (int16_t)lroundf(scaled);
+  }
+}
+
+// Largest difference of the output from the checked in samples
+static float get_fingerprint_difference(const float *output,
+                                        const uint32_t length,
+                                        const int16_t *expected) {
+  float max_abs_difference = 0.F;
+  for (uint32_t i = 0U; i < FINGERPRINT_SAMPLE_COUNT; i++) {
+    const float sample = output[i * (length / FINGERPRINT_SAMPLE_COUNT)];
+    max_abs_difference =
+        fmaxf(max_abs_difference,
+              fabsf(sample - (float)expected[i] / FINGERPRINT_SCALE));
+  }
+
+  return max_abs_difference;
+}
+
+static float output_reference[MAX_MEASURED_SAMPLES];
+static float output_variant[MAX_MEASURED_SAMPLES];
+
+UTEST(regression, variants_match_reference) {
+  for (uint32_t c = 0U; c < REGRESSION_CASE_COUNT; c++) {
+    const RegressionCase *test_case = &regression_cases[c];
+
+    for (uint32_t r = 0U; r < REGRESSION_SAMPLE_RATE_COUNT; r++) {
+      const uint32_t sample_rate = regression_sample_rates[r];
+
+      SpectralBleachHandle reference = create_instance(
+          test_case, sample_rate, SPECBLEACH_KERNEL_ISA_SCALAR);
+      ASSERT_TRUE(reference != NULL);
+      const uint32_t length =
+          render(reference, test_case, sample_rate, output_reference);
+      specbleach_free(reference);
+      ASSERT_GT(length, 0U);
+
+      double signal_sum = 0.0;
+      for (uint32_t k = 0U; k < length; k++) {
+        signal_sum += (double)output_reference[k] * output_reference[k];
+      }
+
+      for (int isa = SPECBLEACH_KERNEL_ISA_SSE2;
+           isa <= SPECBLEACH_KERNEL_ISA_AVX512; isa++) {
+        SpectralBleachHandle variant =
+            create_instance(test_case, sample_rate, isa);
+        ASSERT_TRUE(variant != NULL);
+        // Sets the machine doesn't have run one it does, which is already
+        // checked
+        const bool supported = (int)specbleach_get_kernel_isa(variant) == isa;
+        const uint32_t variant_length =
+            supported ? render(variant, test_case, sample_rate, output_variant)
+                      : length;
+        specbleach_free(variant);
+        if (!supported) {
+          continue;
+        }
+        ASSERT_EQ(variant_length, length);
+
+        float max_abs_difference = 0.F;
+        double difference_sum = 0.0;
+        for (uint32_t k = 0U; k < length; k++) {
+          const float difference = output_variant[k] - output_reference[k];
+          max_abs_difference = fmaxf(max_abs_difference, fabsf(difference));
+          difference_sum += (double)difference * difference;
+        }
+        const float difference_db =
+            10.F * log10f((float)((difference_sum + 1e-30) /
+                                  (signal_sum + 1e-30)));
+
+        EXPECT_LE_MSG(max_abs_difference, VARIANT_MAX_ABS_DIFFERENCE,
+                      kernel_isa_names[isa]);
+        EXPECT_LE_MSG(difference_db, VARIANT_MAX_DIFFERENCE_DB,
+                      test_case->name);
+        EXPECT_LE_MSG(get_fingerprint_difference(
+                          output_variant, length,
+                          regression_fingerprint[c][r]),
+                      REFERENCE_MAX_ABS_DIFFERENCE, kernel_isa_names[isa]);
+      }
+    }
+  }
+}
+
+UTEST(regression, reference_matches_checked_in_output) {
+  ASSERT_EQ(REGRESSION_REFERENCE_CASE_COUNT, REGRESSION_CASE_COUNT);
+  ASSERT_EQ(REGRESSION_REFERENCE_SAMPLE_RATE_COUNT,
+            REGRESSION_SAMPLE_RATE_COUNT);
+
+  for (uint32_t c = 0U; c < REGRESSION_CASE_COUNT; c++) {
+    const RegressionCase *test_case = &regression_cases[c];
+
+    for (uint32_t r = 0U; r < REGRESSION_SAMPLE_RATE_COUNT; r++) {
+      const uint32_t sample_rate = regression_sample_rates[r];
+
+      SpectralBleachHandle reference = create_instance(
+          test_case, sample_rate, SPECBLEACH_KERNEL_ISA_SCALAR);
+      ASSERT_TRUE(reference != NULL);
+      const uint32_t length =
+          render(reference, test_case, sample_rate, output_reference);
+      specbleach_free(reference);
+      ASSERT_GT(length, 0U);
+
+      int16_t levels[LEVEL_BLOCK_COUNT][2];
+      measure_levels(output_reference, sample_rate, levels);
+
+      float mean_difference = 0.F;
+      for (uint32_t block = 0U; block < LEVEL_BLOCK_COUNT; block++) {
+        const int16_t *expected = regression_reference[c][r][block];
+        const float rms_difference =
+            (float)(levels[block][0] - expected[0]) / 100.F;
+        const float peak_difference =
+            (float)(levels[block][1] - expected[1]) / 100.F;
+        mean_difference += rms_difference / (float)LEVEL_BLOCK_COUNT;
+
+        if (fabsf(rms_difference) > REFERENCE_MAX_RMS_DIFFERENCE_DB ||
+            fabsf(peak_difference) > REFERENCE_MAX_PEAK_DIFFERENCE_DB) {
+          printf("%s at %u Hz, block %u: rms %.2f dB (expected %.2f), peak "
+                 "%.2f dB (expected %.2f)\n",
+                 test_case->name, sample_rate, block,
+                 (float)levels[block][0] / 100.F, (float)expected[0] / 100.F,
+                 (float)levels[block][1] / 100.F, (float)expected[1] / 100.F);
+        }
+        EXPECT_LE(fabsf(rms_difference), REFERENCE_MAX_RMS_DIFFERENCE_DB);
+        EXPECT_LE(fabsf(peak_difference), REFERENCE_MAX_PEAK_DIFFERENCE_DB);
+      }
+
+      EXPECT_LE_MSG(fabsf(mean_difference), REFERENCE_MAX_MEAN_DIFFERENCE_DB,
+                    test_case->name);
+
+      const float sample_difference = get_fingerprint_difference(
+          output_reference, length, regression_fingerprint[c][r]);
+      if (sample_difference > REFERENCE_MAX_ABS_DIFFERENCE) {
+        printf("%s at %u Hz: samples differ by up to %g\n", test_case->name,
+               sample_rate, (double)sample_difference);
+      }
+      EXPECT_LE(sample_difference, REFERENCE_MAX_ABS_DIFFERENCE);
+    }
+  }
+}
+
+static int16_t generated_levels[REGRESSION_CASE_COUNT]
+                               [REGRESSION_SAMPLE_RATE_COUNT]
+                               [LEVEL_BLOCK_COUNT][2];
+static int16_t generated_fingerprints[REGRESSION_CASE_COUNT]
+                                     [REGRESSION_SAMPLE_RATE_COUNT]
+                                     [FINGERPRINT_SAMPLE_COUNT];
+
+// Prints regression_reference.h for the current reference pipeline
+static int generate_reference(void) {
+  for (uint32_t c = 0U; c < REGRESSION_CASE_COUNT; c++) {
+    const RegressionCase *test_case = &regression_cases[c];
+
+    for (uint32_t r = 0U; r < REGRESSION_SAMPLE_RATE_COUNT; r++) {
+      const uint32_t sample_rate = regression_sample_rates[r];
+      SpectralBleachHandle reference = create_instance(
+          test_case, sample_rate, SPECBLEACH_KERNEL_ISA_SCALAR);
+      const uint32_t length =
+          reference ? render(reference, test_case, sample_rate,
+                             output_reference)
+                    : 0U;
+      if (length == 0U) {
+        fprintf(stderr, "failed to render %s at %u Hz\n", test_case->name,
+                sample_rate);
+        return 1;
+      }
+      specbleach_free(reference);
+
+      measure_levels(output_reference, sample_rate, generated_levels[c][r]);
+      measure_fingerprint(output_reference, length,
+                          generated_fingerprints[c][r]);
+    }
+  }
+
+  printf("// Generated by `regression-tests --generate` from the scalar "
+         "kernels.\n"
+         "// For each case and sample rate of regression_tests.c, the RMS "
+         "and peak\n"
+         "// level of each %u ms block of output after learning, in "
+         "hundredths of a\n"
+         "// dB, and one sample of it every %u ms, in fixed point\n\n",
+         1000U / LEVEL_BLOCKS_PER_SECOND,
+         (uint32_t)(MEASURED_SECONDS * 1000.F) / FINGERPRINT_SAMPLE_COUNT);
+  printf("#define REGRESSION_REFERENCE_CASE_COUNT %uU\n",
+         (uint32_t)REGRESSION_CASE_COUNT);
+  printf("#define REGRESSION_REFERENCE_SAMPLE_RATE_COUNT %uU\n\n",
+         (uint32_t)REGRESSION_SAMPLE_RATE_COUNT);
+
+  printf("static const int16_t regression_reference"
+         "[REGRESSION_REFERENCE_CASE_COUNT]\n"
+         "    [REGRESSION_REFERENCE_SAMPLE_RATE_COUNT][%uU][2] = {\n",
+         LEVEL_BLOCK_COUNT);
+  for (uint32_t c = 0U; c < REGRESSION_CASE_COUNT; c++) {
+    printf("        // %s\n        {\n", regression_cases[c].name);
+    for (uint32_t r = 0U; r < REGRESSION_SAMPLE_RATE_COUNT; r++) {
+      printf("            // %u Hz\n            {",
+             regression_sample_rates[r]);
+      for (uint32_t block = 0U; block < LEVEL_BLOCK_COUNT; block++) {
+        printf("%s{%d, %d},", block % 4U == 0U ? "\n                " : " ",
+               generated_levels[c][r][block][0],
+               generated_levels[c][r][block][1]);
+      }
+      printf("\n            },\n");
+    }
+    printf("        },\n");
+  }
+  printf("};\n\n");
+
+  printf("static const int16_t regression_fingerprint"
+         "[REGRESSION_REFERENCE_CASE_COUNT]\n"
+         "    [REGRESSION_REFERENCE_SAMPLE_RATE_COUNT][%uU] = {\n",
+         FINGERPRINT_SAMPLE_COUNT);
+  for (uint32_t c = 0U; c < REGRESSION_CASE_COUNT; c++) {
+    printf("        // %s\n        {\n", regression_cases[c].name);
+    for (uint32_t r = 0U; r < REGRESSION_SAMPLE_RATE_COUNT; r++) {
+      printf("            // %u Hz\n            {",
+             regression_sample_rates[r]);
+      for (uint32_t i = 0U; i < FINGERPRINT_SAMPLE_COUNT; i++) {
+        printf("%s%d,", i % 8U == 0U ? "\n                " : " ",
+               generated_fingerprints[c][r][i]);
+      }
+      printf("\n            },\n");
+    }
+    printf("        },\n");
+  }
+  printf("};\n");
+
+  return 0;
+}
+
+UTEST_STATE();
+
+int main(int argc, const char *const argv[]) {
+  if (argc > 1 && strcmp(argv[1], "--generate") == 0) {
+    return generate_reference();
+  }
+
+  return utest_main(argc, argv);
+}
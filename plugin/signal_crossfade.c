@@ -29,6 +29,8 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #endif
 
 #define RELEASE_TIME_MS 30.F
+// Distance to the target at which the fade is considered finished
+#define SETTLED_THRESHOLD 0.001F
 
 struct SignalCrossfade {
   float tau;
@@ -40,8 +42,10 @@ SignalCrossfade *signal_crossfade_initialize(const uint32_t sample_rate) {
   SignalCrossfade *self =
       (SignalCrossfade *)calloc(1U, sizeof(SignalCrossfade));
 
-  self->tau =
-      (1.F - expf(-128.F * M_PI * RELEASE_TIME_MS / (float)sample_rate));
+  // Per sample coefficient that gets within the threshold of the target in
+  // the release time
+  self->tau = 1.F - expf(logf(SETTLED_THRESHOLD) /
+                         (RELEASE_TIME_MS / 1000.F * (float)sample_rate));
   self->wet_dry = 0.F;
   self->wet_dry_target = 0.F;
 
@@ -57,8 +61,10 @@ static void signal_crossfade_update_wetdry_target(SignalCrossfade *self,
   } else {
     self->wet_dry_target = 0.F;
   }
+}
 
-  self->wet_dry += self->tau * (self->wet_dry_target - self->wet_dry);
+bool signal_crossfade_is_dry(const SignalCrossfade *self) {
+  return self->wet_dry == 0.F && self->wet_dry_target == 0.F;
 }
 
 bool signal_crossfade_run(SignalCrossfade *self,
@@ -70,9 +76,22 @@ bool signal_crossfade_run(SignalCrossfade *self,
 
   signal_crossfade_update_wetdry_target(self, enable);
 
-  for (uint32_t k = 0U; k < number_of_samples; k++) {
+  // Only the samples while fading need the mix, the coefficient moves every
+  // sample so the fade doesn't depend on the block size
+  uint32_t k = 0U;
+  for (; k < number_of_samples && self->wet_dry != self->wet_dry_target; k++) {
+    self->wet_dry += self->tau * (self->wet_dry_target - self->wet_dry);
+    if (fabsf(self->wet_dry_target - self->wet_dry) < SETTLED_THRESHOLD) {
+      self->wet_dry = self->wet_dry_target;
+    }
+
     output[k] = (1.F - self->wet_dry) * input[k] + output[k] * self->wet_dry;
   }
 
+  // Fully dry is the input as it is, while fully wet leaves the output alone
+  if (k < number_of_samples && self->wet_dry == 0.F) {
+    memmove(&output[k], &input[k], (number_of_samples - k) * sizeof(float));
+  }
+
   return true;
 }
\ No newline at end of file
@@ -30,4 +30,6 @@ SignalCrossfade *signal_crossfade_initialize(uint32_t sample_rate);
 void signal_crossfade_free(SignalCrossfade *self);
 bool signal_crossfade_run(SignalCrossfade *self, uint32_t number_of_samples,
                           const float *input, float *output, bool enable);
+// True once it has completely faded out to the input
+bool signal_crossfade_is_dry(const SignalCrossfade *self);
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Copyright 2025 Sam Windell
+// SPDX-License-Identifier: LGPL-3.0
+
+#include "signal_delay.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct SignalDelay {
+  uint32_t delay;
+  uint32_t position;
+
+  float *buffer;
+};
+
+SignalDelay *signal_delay_initialize(const uint32_t delay) {
+  SignalDelay *self = (SignalDelay *)calloc(1U, sizeof(SignalDelay));
+  if (!self) {
+    return NULL;
+  }
+
+  self->delay = delay;
+  self->position = 0U;
+  self->buffer = (float *)calloc(delay > 0U ? delay : 1U, sizeof(float));
+  if (!self->buffer) {
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+void signal_delay_free(SignalDelay *self) {
+  free(self->buffer);
+
+  free(self);
+}
+
+void signal_delay_reset(SignalDelay *self) {
+  memset(self->buffer, 0, self->delay * sizeof(float));
+  self->position = 0U;
+}
+
+uint32_t signal_delay_get_delay(const SignalDelay *self) { return self->delay; }
+
+bool signal_delay_run(SignalDelay *self, const uint32_t number_of_samples,
+                      const float *input, float *output) {
+  if (!input || !output || number_of_samples <= 0U) {
+    return false;
+  }
+
+  if (self->delay == 0U) {
+    memmove(output, input, number_of_samples * sizeof(float));
+    return true;
+  }
+
+  for (uint32_t k = 0U; k < number_of_samples; k++) {
+    const float sample = input[k];
+    output[k] = self->buffer[self->position];
+    self->buffer[self->position] = sample;
+
+    self->position++;
+    if (self->position == self->delay) {
+      self->position = 0U;
+    }
+  }
+
+  return true;
+}
+
+void signal_delay_get_history(const SignalDelay *self, const uint32_t age,
+                              const uint32_t number_of_samples,
+                              float *history) {
+  uint32_t start = self->position + self->delay - age;
+  if (start >= self->delay) {
+    start -= self->delay;
+  }
+
+  const uint32_t until_wrap = self->delay - start;
+  const uint32_t first =
+      number_of_samples < until_wrap ? number_of_samples : until_wrap;
+  memcpy(history, &self->buffer[start], first * sizeof(float));
+  memcpy(&history[first], self->buffer,
+         (number_of_samples - first) * sizeof(float));
+}
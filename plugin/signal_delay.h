@@ -0,0 +1,24 @@
+// Copyright 2025 Sam Windell
+// SPDX-License-Identifier: LGPL-3.0
+
+#ifndef SIGNAL_DELAY_H
+#define SIGNAL_DELAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct SignalDelay SignalDelay;
+
+SignalDelay *signal_delay_initialize(uint32_t delay);
+void signal_delay_free(SignalDelay *self);
+void signal_delay_reset(SignalDelay *self);
+uint32_t signal_delay_get_delay(const SignalDelay *self);
+// Input and output can be the same buffer
+bool signal_delay_run(SignalDelay *self, uint32_t number_of_samples,
+                      const float *input, float *output);
+// Copies number_of_samples of the samples currently held in the line, oldest
+// first, starting with the one that went in age samples ago. Age can't be
+// more than the delay
+void signal_delay_get_history(const SignalDelay *self, uint32_t age,
+                              uint32_t number_of_samples, float *history);
+#endif
@@ -1,4 +1,5 @@
 #include "debug.h"
+#include "specbleach_denoiser.h"
 #include "utest.h"
 #include <clap/clap.h>
 #include <math.h>
@@ -7,13 +8,55 @@ UTEST_MAIN()
 
 extern const clap_plugin_factory_t s_plugin_factory;
 
+// Runs the tasks on the calling thread, last one first, which is enough to
+// check that the plugin splits its work correctly.
+static const clap_plugin_t *thread_pool_plugin = NULL;
+static uint32_t thread_pool_tasks_run = 0;
+
+static bool host_thread_pool_request_exec(const clap_host_t *host,
+                                          uint32_t num_tasks) {
+  const clap_plugin_thread_pool_t *pool =
+      thread_pool_plugin->get_extension(thread_pool_plugin,
+                                        CLAP_EXT_THREAD_POOL);
+  for (uint32_t task = num_tasks; task-- > 0;) {
+    pool->exec(thread_pool_plugin, task);
+    ++thread_pool_tasks_run;
+  }
+  return true;
+}
+
+static const clap_host_thread_pool_t host_thread_pool = {
+    .request_exec = host_thread_pool_request_exec,
+};
+
+static uint32_t host_latency_changes = 0;
+static void host_latency_changed(const clap_host_t *host) {
+  ++host_latency_changes;
+}
+
+static const clap_host_latency_t host_latency = {
+    .changed = host_latency_changed,
+};
+
 const void *host_get_extension(const struct clap_host *host,
                                const char *extension_id) {
+  if (!strcmp(extension_id, CLAP_EXT_LATENCY)) {
+    return &host_latency;
+  }
+  if (thread_pool_plugin && !strcmp(extension_id, CLAP_EXT_THREAD_POOL)) {
+    return &host_thread_pool;
+  }
   return NULL;
 }
-void host_request_restart(const struct clap_host *host) {}
+static uint32_t host_restart_requests = 0;
+void host_request_restart(const struct clap_host *host) {
+  ++host_restart_requests;
+}
 void request_process(const struct clap_host *host) {}
-void request_callback(const struct clap_host *host) {}
+static uint32_t host_callback_requests = 0;
+void request_callback(const struct clap_host *host) {
+  ++host_callback_requests;
+}
 
 clap_host_t const test_host = {
     .clap_version = CLAP_VERSION,
@@ -89,7 +132,8 @@ UTEST_F(plugin_test_fixture, correct_latency) {
 
   ASSERT_TRUE(p->init(p));
 
-  const double test_sample_rates[] = {44100.0, 48000.0, 96000.0, 192000.0};
+  const double test_sample_rates[] = {44100.0, 48000.0, 96000.0, 192000.0,
+                                       384000.0};
   const size_t num_sample_rates =
       sizeof(test_sample_rates) / sizeof(test_sample_rates[0]);
 
@@ -199,3 +243,1663 @@ UTEST_F(plugin_test_fixture, correct_latency) {
     p->deactivate(p);
   }
 }
+
+static float test_noise(uint32_t *seed) {
+  *seed = *seed * 1664525u + 1013904223u;
+  return ((float)(*seed >> 8) / (float)(1u << 24)) * 2.0f - 1.0f;
+}
+
+#define TEST_MAX_EVENTS 64
+
+struct test_event_list {
+  clap_event_param_value_t events[TEST_MAX_EVENTS];
+  uint32_t count;
+};
+
+static uint32_t test_event_list_size(const clap_input_events_t *list) {
+  const struct test_event_list *events = list->ctx;
+  return events->count;
+}
+
+static const clap_event_header_t *
+test_event_list_get(const clap_input_events_t *list, uint32_t index) {
+  const struct test_event_list *events = list->ctx;
+  return &events->events[index].header;
+}
+
+static void test_event_list_push(struct test_event_list *events, uint32_t time,
+                                 clap_id param_id, double value) {
+  clap_event_param_value_t *ev = &events->events[events->count++];
+  *ev = (clap_event_param_value_t){};
+  ev->header.size = sizeof(*ev);
+  ev->header.time = time;
+  ev->header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+  ev->header.type = CLAP_EVENT_PARAM_VALUE;
+  ev->param_id = param_id;
+  ev->value = value;
+}
+
+UTEST_F(plugin_test_fixture, params_flush_then_get_value) {
+  const clap_plugin_t *p = utest_fixture->plugin;
+  ASSERT_TRUE(p->init(p));
+
+  const clap_plugin_params_t *params = p->get_extension(p, CLAP_EXT_PARAMS);
+  ASSERT_TRUE(params != NULL);
+
+  struct test_event_list events = {};
+  const uint32_t count = params->count(p);
+  ASSERT_LE(count, TEST_MAX_EVENTS);
+  for (uint32_t i = 0; i < count; ++i) {
+    clap_param_info_t info;
+    ASSERT_TRUE(params->get_info(p, i, &info));
+    test_event_list_push(&events, 0, info.id, info.max_value);
+  }
+
+  const clap_input_events_t in_events = {
+      .ctx = &events,
+      .size = test_event_list_size,
+      .get = test_event_list_get,
+  };
+  const clap_output_events_t out_events = {
+      .ctx = NULL,
+      .try_push = host_process_out_event_try_push,
+  };
+  params->flush(p, &in_events, &out_events);
+
+  for (uint32_t i = 0; i < count; ++i) {
+    clap_param_info_t info;
+    ASSERT_TRUE(params->get_info(p, i, &info));
+    double value = 0.0;
+    ASSERT_TRUE(params->get_value(p, info.id, &value));
+    EXPECT_EQ(value, info.max_value);
+  }
+}
+
+static clap_id find_param_id(const clap_plugin_t *p, const char *name) {
+  const clap_plugin_params_t *params = p->get_extension(p, CLAP_EXT_PARAMS);
+  for (uint32_t i = 0; i < params->count(p); ++i) {
+    clap_param_info_t info;
+    if (params->get_info(p, i, &info) && !strcmp(info.name, name)) {
+      return info.id;
+    }
+  }
+  return CLAP_INVALID_ID;
+}
+
+#define TEST_STATE_CAPACITY (1 << 20)
+
+struct test_state_stream {
+  uint8_t data[TEST_STATE_CAPACITY];
+  uint64_t size;
+  uint64_t read_position;
+};
+
+static int64_t test_state_stream_read(const clap_istream_t *stream,
+                                      void *buffer, uint64_t size) {
+  struct test_state_stream *state = stream->ctx;
+  const uint64_t available = state->size - state->read_position;
+  if (size > available) {
+    size = available;
+  }
+  memcpy(buffer, &state->data[state->read_position], size);
+  state->read_position += size;
+  return (int64_t)size;
+}
+
+static int64_t test_state_stream_write(const clap_ostream_t *stream,
+                                       const void *buffer, uint64_t size) {
+  struct test_state_stream *state = stream->ctx;
+  if (state->size + size > TEST_STATE_CAPACITY) {
+    return -1;
+  }
+  memcpy(&state->data[state->size], buffer, size);
+  state->size += size;
+  return (int64_t)size;
+}
+
+// The noise profile is only copied out of the audio thread every so often
+// while learning and once learning stops, and the host is asked for a main
+// thread callback to pick it up. Saving never waits for the audio thread, and
+// the saved state must contain the profile.
+UTEST_F(plugin_test_fixture, noise_profile_saved_after_learning) {
+  const clap_plugin_t *p = utest_fixture->plugin;
+  ASSERT_TRUE(p->init(p));
+  ASSERT_TRUE(p->activate(p, 44100.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  ASSERT_TRUE(p->start_processing(p));
+
+  const clap_id learn_noise = find_param_id(p, "Learn Noise Profile");
+  ASSERT_NE(learn_noise, CLAP_INVALID_ID);
+
+  float inputs[2][TEST_PROCESS_BLOCK_SIZE];
+  float outputs[2][TEST_PROCESS_BLOCK_SIZE];
+  float *input_channels[2] = {inputs[0], inputs[1]};
+  float *output_channels[2] = {outputs[0], outputs[1]};
+  clap_audio_buffer_t input_buffer = {.data32 = input_channels,
+                                      .channel_count = 2};
+  clap_audio_buffer_t output_buffer = {.data32 = output_channels,
+                                       .channel_count = 2};
+
+  struct test_event_list events = {};
+  const clap_input_events_t in_events = {
+      .ctx = &events,
+      .size = test_event_list_size,
+      .get = test_event_list_get,
+  };
+  const clap_output_events_t out_events = {
+      .ctx = NULL,
+      .try_push = host_process_out_event_try_push,
+  };
+
+  clap_process_t process = {};
+  process.frames_count = TEST_PROCESS_BLOCK_SIZE;
+  process.steady_time = -1;
+  process.audio_inputs = &input_buffer;
+  process.audio_inputs_count = 1;
+  process.audio_outputs = &output_buffer;
+  process.audio_outputs_count = 1;
+  process.in_events = &in_events;
+  process.out_events = &out_events;
+
+  const clap_plugin_state_t *state = p->get_extension(p, CLAP_EXT_STATE);
+  ASSERT_TRUE(state != NULL);
+  static struct test_state_stream saved;
+  const clap_ostream_t stream = {
+      .ctx = &saved,
+      .write = test_state_stream_write,
+  };
+
+  // version, parameter count, then an id and a value per parameter
+  const clap_plugin_params_t *params = p->get_extension(p, CLAP_EXT_PARAMS);
+  const uint64_t profile_offset =
+      2 * sizeof(uint32_t) +
+      params->count(p) * (sizeof(uint32_t) + sizeof(double));
+
+  enum { learn_blocks = 400 };
+  const uint32_t callback_requests = host_callback_requests;
+  uint32_t seed = 3;
+  for (uint32_t block = 0; block <= learn_blocks; ++block) {
+    // Halfway through learning there is already a published profile
+    if (block == learn_blocks / 2) {
+      EXPECT_GT(host_callback_requests, callback_requests);
+      p->on_main_thread(p);
+      saved.size = 0;
+      ASSERT_TRUE(state->save(p, &stream));
+      uint32_t learning_profile_size;
+      ASSERT_GE(saved.size, profile_offset + 2 * sizeof(uint32_t));
+      memcpy(&learning_profile_size,
+             &saved.data[profile_offset + sizeof(uint32_t)], sizeof(uint32_t));
+      EXPECT_GT(learning_profile_size, 0u);
+    }
+
+    events.count = 0;
+    if (block == 0) {
+      test_event_list_push(&events, 0, learn_noise, 1.0);
+    } else if (block == learn_blocks) {
+      test_event_list_push(&events, 0, learn_noise, 0.0);
+    }
+    for (uint32_t frame = 0; frame < TEST_PROCESS_BLOCK_SIZE; ++frame) {
+      inputs[0][frame] = 0.1f * test_noise(&seed);
+      inputs[1][frame] = 0.1f * test_noise(&seed);
+    }
+    ASSERT_EQ(p->process(p, &process), CLAP_PROCESS_CONTINUE);
+  }
+
+  p->on_main_thread(p);
+  saved.size = 0;
+  ASSERT_TRUE(state->save(p, &stream));
+  ASSERT_GE(saved.size, profile_offset + 2 * sizeof(uint32_t));
+  uint32_t blocks_averaged;
+  uint32_t profile_size;
+  memcpy(&blocks_averaged, &saved.data[profile_offset], sizeof(uint32_t));
+  memcpy(&profile_size, &saved.data[profile_offset + sizeof(uint32_t)],
+         sizeof(uint32_t));
+  EXPECT_GT(blocks_averaged, 0u);
+  EXPECT_GT(profile_size, 0u);
+  EXPECT_EQ(saved.size, profile_offset + 2 * sizeof(uint32_t) +
+                            2 * profile_size * sizeof(float));
+
+  p->stop_processing(p);
+  p->deactivate(p);
+
+  // Loading it while running at another sample rate resamples it without
+  // needing a restart. Until the audio thread publishes its own, the same
+  // profile is saved.
+  ASSERT_TRUE(p->activate(p, 96000.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  const uint32_t restart_requests = host_restart_requests;
+  saved.read_position = 0;
+  const clap_istream_t load_stream = {
+      .ctx = &saved,
+      .read = test_state_stream_read,
+  };
+  ASSERT_TRUE(state->load(p, &load_stream));
+  EXPECT_EQ(host_restart_requests, restart_requests);
+
+  static struct test_state_stream resaved;
+  resaved.size = 0;
+  const clap_ostream_t restream = {
+      .ctx = &resaved,
+      .write = test_state_stream_write,
+  };
+  ASSERT_TRUE(state->save(p, &restream));
+  ASSERT_EQ(resaved.size, saved.size);
+  EXPECT_EQ(memcmp(&resaved.data[profile_offset], &saved.data[profile_offset],
+                   saved.size - profile_offset),
+            0);
+
+  // Once it's been through the instances it has their size
+  ASSERT_TRUE(p->start_processing(p));
+  events.count = 0;
+  ASSERT_EQ(p->process(p, &process), CLAP_PROCESS_CONTINUE);
+  p->stop_processing(p);
+
+  resaved.size = 0;
+  ASSERT_TRUE(state->save(p, &restream));
+  uint32_t resampled_size;
+  memcpy(&resampled_size, &resaved.data[profile_offset + sizeof(uint32_t)],
+         sizeof(uint32_t));
+  EXPECT_GT(resampled_size, profile_size);
+  p->deactivate(p);
+}
+
+// Events only write the audio thread's copy of the parameters, and the main
+// thread is asked to merge them into the one it reads. The reset trigger the
+// audio thread clears goes the same way.
+UTEST_F(plugin_test_fixture, audio_thread_writes_reach_main_thread) {
+  const clap_plugin_t *p = utest_fixture->plugin;
+  ASSERT_TRUE(p->init(p));
+  ASSERT_TRUE(p->activate(p, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  ASSERT_TRUE(p->start_processing(p));
+
+  const clap_plugin_params_t *params = p->get_extension(p, CLAP_EXT_PARAMS);
+  const clap_id amount = find_param_id(p, "Reduction Amount");
+  const clap_id reset_profile = find_param_id(p, "Reset Noise Profile");
+
+  float inputs[2][TEST_PROCESS_BLOCK_SIZE] = {};
+  float outputs[2][TEST_PROCESS_BLOCK_SIZE];
+  float *input_channels[2] = {inputs[0], inputs[1]};
+  float *output_channels[2] = {outputs[0], outputs[1]};
+  clap_audio_buffer_t input_buffer = {.data32 = input_channels,
+                                      .channel_count = 2};
+  clap_audio_buffer_t output_buffer = {.data32 = output_channels,
+                                       .channel_count = 2};
+  struct test_event_list events = {};
+  const clap_input_events_t in_events = {
+      .ctx = &events,
+      .size = test_event_list_size,
+      .get = test_event_list_get,
+  };
+  const clap_output_events_t out_events = {
+      .ctx = NULL,
+      .try_push = host_process_out_event_try_push,
+  };
+  clap_process_t process = {};
+  process.frames_count = TEST_PROCESS_BLOCK_SIZE;
+  process.steady_time = -1;
+  process.audio_inputs = &input_buffer;
+  process.audio_inputs_count = 1;
+  process.audio_outputs = &output_buffer;
+  process.audio_outputs_count = 1;
+  process.in_events = &in_events;
+  process.out_events = &out_events;
+
+  const uint32_t callback_requests = host_callback_requests;
+  test_event_list_push(&events, 100, amount, 30.0);
+  test_event_list_push(&events, 200, reset_profile, 1.0);
+  ASSERT_EQ(p->process(p, &process), CLAP_PROCESS_CONTINUE);
+  EXPECT_GT(host_callback_requests, callback_requests);
+
+  p->on_main_thread(p);
+  double value = 0.0;
+  ASSERT_TRUE(params->get_value(p, amount, &value));
+  EXPECT_EQ(value, 30.0);
+  ASSERT_TRUE(params->get_value(p, reset_profile, &value));
+  EXPECT_EQ(value, 0.0);
+
+  // Flushed while active, they take the same way
+  events.count = 0;
+  test_event_list_push(&events, 0, amount, 5.0);
+  params->flush(p, &in_events, &out_events);
+  ASSERT_TRUE(params->get_value(p, amount, &value));
+  EXPECT_EQ(value, 5.0);
+
+  events.count = 0;
+  ASSERT_EQ(p->process(p, &process), CLAP_PROCESS_CONTINUE);
+  ASSERT_TRUE(params->get_value(p, amount, &value));
+  EXPECT_EQ(value, 5.0);
+
+  p->stop_processing(p);
+  p->deactivate(p);
+}
+
+// Profiles saved by version 1 of the state were learned with the window
+// spanning the whole fft buffer. Loading them scales them to the levels the
+// frame spanning window learns, by the ratio of the window energies for the
+// sample rate that gave their size, and saving writes the new version.
+UTEST_F(plugin_test_fixture, legacy_noise_profile_rescaled) {
+  const clap_plugin_t *p = utest_fixture->plugin;
+  ASSERT_TRUE(p->init(p));
+  const clap_plugin_state_t *state = p->get_extension(p, CLAP_EXT_STATE);
+
+  // 48 kHz gives a 2208 sample frame in a 4096 fft, 44.1 kHz a 2028 sample
+  // frame in a 2048 fft
+  const uint32_t sizes[] = {2049, 1025};
+  const float expected_db[] = {-2.449f, -0.043f};
+  for (uint32_t s = 0; s < 2; ++s) {
+    static struct test_state_stream legacy;
+    legacy.size = 0;
+    legacy.read_position = 0;
+    const clap_ostream_t legacy_writer = {
+        .ctx = &legacy,
+        .write = test_state_stream_write,
+    };
+    // No parameters, so they all keep their values
+    const uint32_t header[] = {1, 0, 10, sizes[s]};
+    ASSERT_EQ(legacy_writer.write(&legacy_writer, header, sizeof(header)),
+              (int64_t)sizeof(header));
+    const float bin = 1e-3f;
+    for (uint32_t k = 0; k < 2 * sizes[s]; ++k) {
+      ASSERT_EQ(legacy_writer.write(&legacy_writer, &bin, sizeof(bin)),
+                (int64_t)sizeof(bin));
+    }
+
+    const clap_istream_t load_stream = {
+        .ctx = &legacy,
+        .read = test_state_stream_read,
+    };
+    ASSERT_TRUE(state->load(p, &load_stream));
+
+    static struct test_state_stream saved;
+    saved.size = 0;
+    const clap_ostream_t stream = {
+        .ctx = &saved,
+        .write = test_state_stream_write,
+    };
+    ASSERT_TRUE(state->save(p, &stream));
+
+    const clap_plugin_params_t *params = p->get_extension(p, CLAP_EXT_PARAMS);
+    const uint64_t profile_offset =
+        2 * sizeof(uint32_t) +
+        params->count(p) * (sizeof(uint32_t) + sizeof(double));
+    uint32_t version;
+    uint32_t profile_size;
+    memcpy(&version, saved.data, sizeof(version));
+    memcpy(&profile_size, &saved.data[profile_offset + sizeof(uint32_t)],
+           sizeof(profile_size));
+    EXPECT_EQ(version, 2u);
+    ASSERT_EQ(profile_size, sizes[s]);
+    for (uint32_t channel = 0; channel < 2; ++channel) {
+      float rescaled;
+      memcpy(&rescaled,
+             &saved.data[profile_offset + 2 * sizeof(uint32_t) +
+                         (channel * sizes[s] + sizes[s] / 2) * sizeof(float)],
+             sizeof(rescaled));
+      EXPECT_NEAR(10.f * log10f(rescaled / bin), expected_db[s], 0.005f);
+    }
+
+    // Saved again, it's loaded as it is
+    saved.read_position = 0;
+    const clap_istream_t reload_stream = {
+        .ctx = &saved,
+        .read = test_state_stream_read,
+    };
+    ASSERT_TRUE(state->load(p, &reload_stream));
+    static struct test_state_stream resaved;
+    resaved.size = 0;
+    const clap_ostream_t restream = {
+        .ctx = &resaved,
+        .write = test_state_stream_write,
+    };
+    ASSERT_TRUE(state->save(p, &restream));
+    ASSERT_EQ(resaved.size, saved.size);
+    EXPECT_EQ(memcmp(resaved.data, saved.data, saved.size), 0);
+  }
+}
+
+// While bypassed the plugin only delays the input by its latency. Coming
+// back from it the instances are primed with the delayed input, so the
+// output carries on from the dry signal instead of fading in from silence.
+UTEST_F(plugin_test_fixture, bypass_is_latency_compensated) {
+  const clap_plugin_t *p = utest_fixture->plugin;
+  ASSERT_TRUE(p->init(p));
+  ASSERT_TRUE(p->activate(p, 44100.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  ASSERT_TRUE(p->start_processing(p));
+
+  const clap_id enable = find_param_id(p, "Enable");
+  ASSERT_NE(enable, CLAP_INVALID_ID);
+  const clap_plugin_latency_t *latency_extension =
+      p->get_extension(p, CLAP_EXT_LATENCY);
+  const uint32_t latency = latency_extension->get(p);
+
+  float inputs[2][TEST_PROCESS_BLOCK_SIZE];
+  float outputs[2][TEST_PROCESS_BLOCK_SIZE];
+  float *input_channels[2] = {inputs[0], inputs[1]};
+  float *output_channels[2] = {outputs[0], outputs[1]};
+  clap_audio_buffer_t input_buffer = {.data32 = input_channels,
+                                      .channel_count = 2};
+  clap_audio_buffer_t output_buffer = {.data32 = output_channels,
+                                       .channel_count = 2};
+
+  struct test_event_list events = {};
+  const clap_input_events_t in_events = {
+      .ctx = &events,
+      .size = test_event_list_size,
+      .get = test_event_list_get,
+  };
+  const clap_output_events_t out_events = {
+      .ctx = NULL,
+      .try_push = host_process_out_event_try_push,
+  };
+
+  clap_process_t process = {};
+  process.frames_count = TEST_PROCESS_BLOCK_SIZE;
+  process.steady_time = -1;
+  process.audio_inputs = &input_buffer;
+  process.audio_inputs_count = 1;
+  process.audio_outputs = &output_buffer;
+  process.audio_outputs_count = 1;
+  process.in_events = &in_events;
+  process.out_events = &out_events;
+
+  enum {
+    disable_block = 100,
+    enable_block = 200,
+    block_count = 300,
+    length = block_count * TEST_PROCESS_BLOCK_SIZE
+  };
+  static float signal[length];
+  for (uint32_t i = 0; i < length; ++i) {
+    signal[i] = 0.5f * sinf((float)i * 0.01f);
+  }
+
+  float max_bypass_error = 0.0f;
+  float max_resume_error = 0.0f;
+  for (uint32_t block = 0; block < block_count; ++block) {
+    events.count = 0;
+    if (block == disable_block) {
+      test_event_list_push(&events, 0, enable, 0.0);
+    } else if (block == enable_block) {
+      test_event_list_push(&events, 0, enable, 1.0);
+    }
+
+    const uint32_t offset = block * TEST_PROCESS_BLOCK_SIZE;
+    memcpy(inputs[0], &signal[offset], sizeof(inputs[0]));
+    memcpy(inputs[1], &signal[offset], sizeof(inputs[1]));
+    ASSERT_EQ(p->process(p, &process), CLAP_PROCESS_CONTINUE);
+
+    for (uint32_t frame = 0; frame < TEST_PROCESS_BLOCK_SIZE; ++frame) {
+      const uint32_t i = offset + frame;
+      const float expected = i >= latency ? signal[i - latency] : 0.0f;
+      for (uint32_t channel = 0; channel < 2; ++channel) {
+        const float error = fabsf(outputs[channel][frame] - expected);
+        // Give the fade out time to settle
+        if (block >= disable_block + 30 && block < enable_block) {
+          max_bypass_error = fmaxf(max_bypass_error, error);
+        } else if (block >= enable_block) {
+          max_resume_error = fmaxf(max_resume_error, error);
+        }
+      }
+    }
+  }
+
+  EXPECT_EQ(max_bypass_error, 0.0f);
+  EXPECT_LT(max_resume_error, 0.05f);
+
+  p->stop_processing(p);
+  p->deactivate(p);
+}
+
+static void process_sine(const clap_plugin_t *p, uint32_t block_count,
+                         float *output) {
+  float inputs[2][TEST_PROCESS_BLOCK_SIZE];
+  float outputs[2][TEST_PROCESS_BLOCK_SIZE];
+  float *input_channels[2] = {inputs[0], inputs[1]};
+  float *output_channels[2] = {outputs[0], outputs[1]};
+  clap_audio_buffer_t input_buffer = {.data32 = input_channels,
+                                      .channel_count = 2};
+  clap_audio_buffer_t output_buffer = {.data32 = output_channels,
+                                       .channel_count = 2};
+  const clap_input_events_t in_events = {
+      .ctx = NULL,
+      .size = host_process_in_event_size,
+      .get = host_process_in_event_get,
+  };
+  const clap_output_events_t out_events = {
+      .ctx = NULL,
+      .try_push = host_process_out_event_try_push,
+  };
+
+  clap_process_t process = {};
+  process.frames_count = TEST_PROCESS_BLOCK_SIZE;
+  process.steady_time = -1;
+  process.audio_inputs = &input_buffer;
+  process.audio_inputs_count = 1;
+  process.audio_outputs = &output_buffer;
+  process.audio_outputs_count = 1;
+  process.in_events = &in_events;
+  process.out_events = &out_events;
+
+  for (uint32_t block = 0; block < block_count; ++block) {
+    for (uint32_t frame = 0; frame < TEST_PROCESS_BLOCK_SIZE; ++frame) {
+      const float i = (float)(block * TEST_PROCESS_BLOCK_SIZE + frame);
+      inputs[0][frame] = 0.5f * sinf(i * 0.01f);
+      inputs[1][frame] = 0.5f * sinf(i * 0.023f);
+    }
+    p->process(p, &process);
+    for (uint32_t channel = 0; channel < 2; ++channel) {
+      memcpy(&output[(block * 2 + channel) * TEST_PROCESS_BLOCK_SIZE],
+             outputs[channel], sizeof(outputs[channel]));
+    }
+  }
+}
+
+// Handing the channels to the host thread pool must give the same output as
+// processing them in turn
+UTEST_F(plugin_test_fixture, thread_pool_matches_serial_processing) {
+  const clap_plugin_t *serial = utest_fixture->plugin;
+  ASSERT_TRUE(serial->init(serial));
+
+  const clap_plugin_factory_t *f = &s_plugin_factory;
+  const clap_plugin_descriptor_t *desc = f->get_plugin_descriptor(f, 0);
+  const clap_plugin_t *pooled = f->create_plugin(f, &test_host, desc->id);
+  ASSERT_TRUE(pooled != NULL);
+  thread_pool_plugin = pooled;
+  thread_pool_tasks_run = 0;
+  ASSERT_TRUE(pooled->init(pooled));
+
+  ASSERT_TRUE(serial->activate(serial, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                               TEST_PROCESS_BLOCK_SIZE));
+  ASSERT_TRUE(pooled->activate(pooled, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                               TEST_PROCESS_BLOCK_SIZE));
+  ASSERT_TRUE(serial->start_processing(serial));
+  ASSERT_TRUE(pooled->start_processing(pooled));
+
+  enum { block_count = 200 };
+  static float serial_output[block_count * 2 * TEST_PROCESS_BLOCK_SIZE];
+  static float pooled_output[block_count * 2 * TEST_PROCESS_BLOCK_SIZE];
+  process_sine(serial, block_count, serial_output);
+  process_sine(pooled, block_count, pooled_output);
+
+  EXPECT_EQ(thread_pool_tasks_run, 2u * block_count);
+  EXPECT_EQ(memcmp(serial_output, pooled_output, sizeof(serial_output)), 0);
+
+  serial->stop_processing(serial);
+  pooled->stop_processing(pooled);
+  serial->deactivate(serial);
+  pooled->deactivate(pooled);
+  pooled->destroy(pooled);
+  thread_pool_plugin = NULL;
+}
+
+// Processes the sine of process_sine in blocks of block_size frames,
+// switching the plugin off at the given frame
+static void process_sine_disabled_at(const clap_plugin_t *p,
+                                     uint32_t block_size, uint32_t frame_count,
+                                     uint32_t disable_frame, float *output) {
+  float inputs[2][TEST_PROCESS_BLOCK_SIZE];
+  float outputs[2][TEST_PROCESS_BLOCK_SIZE];
+  float *input_channels[2] = {inputs[0], inputs[1]};
+  float *output_channels[2] = {outputs[0], outputs[1]};
+  clap_audio_buffer_t input_buffer = {.data32 = input_channels,
+                                      .channel_count = 2};
+  clap_audio_buffer_t output_buffer = {.data32 = output_channels,
+                                       .channel_count = 2};
+
+  struct test_event_list events = {};
+  const clap_input_events_t in_events = {
+      .ctx = &events,
+      .size = test_event_list_size,
+      .get = test_event_list_get,
+  };
+  const clap_output_events_t out_events = {
+      .ctx = NULL,
+      .try_push = host_process_out_event_try_push,
+  };
+
+  clap_process_t process = {};
+  process.frames_count = block_size;
+  process.steady_time = -1;
+  process.audio_inputs = &input_buffer;
+  process.audio_inputs_count = 1;
+  process.audio_outputs = &output_buffer;
+  process.audio_outputs_count = 1;
+  process.in_events = &in_events;
+  process.out_events = &out_events;
+
+  const clap_id enable = find_param_id(p, "Enable");
+  for (uint32_t offset = 0; offset < frame_count; offset += block_size) {
+    events.count = 0;
+    if (disable_frame >= offset && disable_frame < offset + block_size) {
+      test_event_list_push(&events, disable_frame - offset, enable, 0.0);
+    }
+    for (uint32_t frame = 0; frame < block_size; ++frame) {
+      const float i = (float)(offset + frame);
+      inputs[0][frame] = 0.5f * sinf(i * 0.01f);
+      inputs[1][frame] = 0.5f * sinf(i * 0.023f);
+    }
+    p->process(p, &process);
+    for (uint32_t channel = 0; channel < 2; ++channel) {
+      memcpy(&output[channel * frame_count + offset], outputs[channel],
+             block_size * sizeof(float));
+    }
+  }
+}
+
+// Switching the plugin off in the middle of a block starts the fade out at
+// the event, the same as if the block had ended there
+UTEST_F(plugin_test_fixture, enable_splits_the_block) {
+  const clap_plugin_t *whole = utest_fixture->plugin;
+  ASSERT_TRUE(whole->init(whole));
+
+  const clap_plugin_factory_t *f = &s_plugin_factory;
+  const clap_plugin_descriptor_t *desc = f->get_plugin_descriptor(f, 0);
+  const clap_plugin_t *halves = f->create_plugin(f, &test_host, desc->id);
+  ASSERT_TRUE(halves != NULL);
+  ASSERT_TRUE(halves->init(halves));
+
+  ASSERT_TRUE(whole->activate(whole, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                              TEST_PROCESS_BLOCK_SIZE));
+  ASSERT_TRUE(halves->activate(halves, 48000.0, TEST_PROCESS_BLOCK_SIZE / 2,
+                               TEST_PROCESS_BLOCK_SIZE));
+  ASSERT_TRUE(whole->start_processing(whole));
+  ASSERT_TRUE(halves->start_processing(halves));
+
+  enum {
+    frame_count = 300 * TEST_PROCESS_BLOCK_SIZE,
+    disable_frame = 100 * TEST_PROCESS_BLOCK_SIZE + TEST_PROCESS_BLOCK_SIZE / 2
+  };
+  static float whole_output[2 * frame_count];
+  static float halves_output[2 * frame_count];
+  process_sine_disabled_at(whole, TEST_PROCESS_BLOCK_SIZE, frame_count,
+                           disable_frame, whole_output);
+  process_sine_disabled_at(halves, TEST_PROCESS_BLOCK_SIZE / 2, frame_count,
+                           disable_frame, halves_output);
+
+  EXPECT_EQ(memcmp(whole_output, halves_output, sizeof(whole_output)), 0);
+
+  whole->stop_processing(whole);
+  halves->stop_processing(halves);
+  whole->deactivate(whole);
+  halves->deactivate(halves);
+  halves->destroy(halves);
+}
+
+// Offline renders use a higher overlap, which needs a restart but keeps the
+// latency the host compensates for
+UTEST_F(plugin_test_fixture, offline_render_keeps_latency) {
+  const clap_plugin_t *p = utest_fixture->plugin;
+  ASSERT_TRUE(p->init(p));
+
+  const clap_plugin_render_t *render = p->get_extension(p, CLAP_EXT_RENDER);
+  ASSERT_TRUE(render != NULL);
+  EXPECT_FALSE(render->has_hard_realtime_requirement(p));
+  const clap_plugin_latency_t *latency = p->get_extension(p, CLAP_EXT_LATENCY);
+
+  ASSERT_TRUE(p->activate(p, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  const uint32_t realtime_latency = latency->get(p);
+
+  const uint32_t restarts = host_restart_requests;
+  ASSERT_TRUE(render->set(p, CLAP_RENDER_REALTIME));
+  EXPECT_EQ(host_restart_requests, restarts);
+  ASSERT_TRUE(render->set(p, CLAP_RENDER_OFFLINE));
+  EXPECT_EQ(host_restart_requests, restarts + 1);
+
+  p->deactivate(p);
+  ASSERT_TRUE(p->activate(p, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  EXPECT_EQ(latency->get(p), realtime_latency);
+  ASSERT_TRUE(p->start_processing(p));
+  static float output[10 * 2 * TEST_PROCESS_BLOCK_SIZE];
+  process_sine(p, 10, output);
+  p->stop_processing(p);
+
+  ASSERT_TRUE(render->set(p, CLAP_RENDER_OFFLINE));
+  EXPECT_EQ(host_restart_requests, restarts + 1);
+  p->deactivate(p);
+
+  // Nothing to restart while inactive
+  ASSERT_TRUE(render->set(p, CLAP_RENDER_REALTIME));
+  EXPECT_EQ(host_restart_requests, restarts + 1);
+}
+
+// Switching to low latency or steady CPU needs a restart, after which the host
+// is told about the new latency
+UTEST_F(plugin_test_fixture, latency_mode_changes_latency) {
+  const clap_plugin_t *p = utest_fixture->plugin;
+  ASSERT_TRUE(p->init(p));
+
+  const clap_plugin_params_t *params = p->get_extension(p, CLAP_EXT_PARAMS);
+  const clap_plugin_latency_t *latency = p->get_extension(p, CLAP_EXT_LATENCY);
+  const clap_id latency_mode = find_param_id(p, "Latency Mode");
+  ASSERT_NE(latency_mode, CLAP_INVALID_ID);
+
+  const uint32_t changes = host_latency_changes;
+  ASSERT_TRUE(p->activate(p, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  const uint32_t standard_latency = latency->get(p);
+  EXPECT_EQ(host_latency_changes, changes + 1);
+
+  struct test_event_list events = {};
+  test_event_list_push(&events, 0, latency_mode, 1.0);
+  const clap_input_events_t in_events = {
+      .ctx = &events,
+      .size = test_event_list_size,
+      .get = test_event_list_get,
+  };
+  const clap_output_events_t out_events = {
+      .ctx = NULL,
+      .try_push = host_process_out_event_try_push,
+  };
+  const uint32_t restarts = host_restart_requests;
+  params->flush(p, &in_events, &out_events);
+  EXPECT_EQ(host_restart_requests, restarts + 1);
+
+  p->deactivate(p);
+  ASSERT_TRUE(p->activate(p, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  EXPECT_EQ(host_latency_changes, changes + 2);
+  EXPECT_EQ(latency->get(p), 480u);
+  EXPECT_LT(latency->get(p), standard_latency);
+
+  ASSERT_TRUE(p->start_processing(p));
+  static float output[10 * 2 * TEST_PROCESS_BLOCK_SIZE];
+  process_sine(p, 10, output);
+  p->stop_processing(p);
+
+  // Same configuration, nothing to report
+  p->deactivate(p);
+  ASSERT_TRUE(p->activate(p, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  EXPECT_EQ(host_latency_changes, changes + 2);
+
+  // The quality also rebuilds the instances, but keeps the latency
+  events.count = 0;
+  test_event_list_push(&events, 0, find_param_id(p, "Quality"), 2.0);
+  params->flush(p, &in_events, &out_events);
+  EXPECT_EQ(host_restart_requests, restarts + 2);
+  p->deactivate(p);
+  ASSERT_TRUE(p->activate(p, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  EXPECT_EQ(host_latency_changes, changes + 2);
+  EXPECT_EQ(latency->get(p), 480u);
+
+  // Steady CPU has the frames of the standard mode plus one of their hops,
+  // which are an eighth of them in HQ
+  events.count = 0;
+  test_event_list_push(&events, 0, latency_mode, 2.0);
+  params->flush(p, &in_events, &out_events);
+  EXPECT_EQ(host_restart_requests, restarts + 3);
+  p->deactivate(p);
+  ASSERT_TRUE(p->activate(p, 48000.0, TEST_PROCESS_BLOCK_SIZE,
+                          TEST_PROCESS_BLOCK_SIZE));
+  EXPECT_EQ(host_latency_changes, changes + 3);
+  EXPECT_EQ(latency->get(p), standard_latency + standard_latency / 8u);
+
+  ASSERT_TRUE(p->start_processing(p));
+  process_sine(p, 10, output);
+  p->stop_processing(p);
+  p->deactivate(p);
+}
+
+UTEST(library, resample_noise_profile) {
+  enum { input_size = 5, output_size = 9 };
+  const float input[input_size] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f};
+  float output[output_size];
+
+  ASSERT_TRUE(specbleach_resample_noise_profile(input, input_size, output,
+                                                output_size));
+  for (uint32_t k = 0; k < output_size; ++k) {
+    EXPECT_NEAR(output[k], 0.5f * (float)k, 1e-6f);
+  }
+
+  float same[input_size];
+  ASSERT_TRUE(
+      specbleach_resample_noise_profile(input, input_size, same, input_size));
+  EXPECT_EQ(memcmp(same, input, sizeof(input)), 0);
+
+  EXPECT_FALSE(
+      specbleach_resample_noise_profile(input, 0, output, output_size));
+}
+
+// The library flushes denormals while processing, but that must not leak out
+// into the caller's thread.
+UTEST(library, process_restores_denormals_state) {
+  SpectralBleachHandle instance = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(instance != NULL);
+
+  float buffer[512] = {0};
+  buffer[0] = 1e-40f;
+  ASSERT_TRUE(specbleach_process(instance, 512, buffer, buffer));
+
+  volatile float small = 1e-30f;
+  volatile float scale = 1e-10f;
+  const float denormal = small * scale;
+  EXPECT_EQ(fpclassify(denormal), FP_SUBNORMAL);
+
+  specbleach_free(instance);
+}
+
+// Changing parameters one at a time must end up with exactly the same
+// processing as loading the whole set.
+UTEST(library, set_parameter_matches_load_parameters) {
+  SpectralBleachHandle loaded = specbleach_initialize(44100, 46);
+  SpectralBleachHandle set = specbleach_initialize(44100, 46);
+  ASSERT_TRUE(loaded != NULL);
+  ASSERT_TRUE(set != NULL);
+
+  SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 10.0f,
+      .smoothing_factor = 0.0f,
+      .noise_rescale = 2.0f,
+  };
+  ASSERT_TRUE(specbleach_load_parameters(loaded, parameters));
+  ASSERT_TRUE(specbleach_load_parameters(set, parameters));
+
+  enum { block_size = 256, block_count = 600, learn_blocks = 200 };
+  float input[block_size];
+  float output_loaded[block_size];
+  float output_set[block_size];
+  uint32_t seed = 1;
+
+  for (int block = 0; block < block_count; ++block) {
+    if (block == learn_blocks) {
+      parameters.learn_noise = 0;
+      parameters.reduction_amount = 20.0f;
+      parameters.smoothing_factor = 50.0f;
+      parameters.whitening_factor = 30.0f;
+      parameters.post_filter_threshold = -3.0f;
+      ASSERT_TRUE(specbleach_load_parameters(loaded, parameters));
+
+      ASSERT_TRUE(specbleach_set_parameter(
+          set, SPECBLEACH_PARAMETER_LEARN_NOISE, 0.0f));
+      ASSERT_TRUE(specbleach_set_parameter(
+          set, SPECBLEACH_PARAMETER_REDUCTION_AMOUNT, 20.0f));
+      ASSERT_TRUE(specbleach_set_parameter(
+          set, SPECBLEACH_PARAMETER_SMOOTHING_FACTOR, 50.0f));
+      ASSERT_TRUE(specbleach_set_parameter(
+          set, SPECBLEACH_PARAMETER_WHITENING_FACTOR, 30.0f));
+      ASSERT_TRUE(specbleach_set_parameter(
+          set, SPECBLEACH_PARAMETER_POST_FILTER_THRESHOLD, -3.0f));
+    }
+
+    for (int k = 0; k < block_size; ++k) {
+      input[k] = 0.1f * test_noise(&seed);
+      if (block >= learn_blocks) {
+        input[k] += 0.3f * sinf((float)(block * block_size + k) * 0.05f);
+      }
+    }
+
+    ASSERT_TRUE(specbleach_process(loaded, block_size, input, output_loaded));
+    ASSERT_TRUE(specbleach_process(set, block_size, input, output_set));
+    for (int k = 0; k < block_size; ++k) {
+      ASSERT_EQ(output_loaded[k], output_set[k]);
+    }
+  }
+
+  EXPECT_FALSE(
+      specbleach_set_parameter(set, SPECBLEACH_PARAMETER_COUNT, 1.0f));
+
+  specbleach_free(loaded);
+  specbleach_free(set);
+}
+
+// Queuing a change must give the same output as splitting the buffer at the
+// change and setting it directly, including changes due in a later call
+UTEST(library, queued_parameter_matches_split_processing) {
+  SpectralBleachHandle split = specbleach_initialize(44100, 46);
+  SpectralBleachHandle queued = specbleach_initialize(44100, 46);
+  ASSERT_TRUE(split != NULL);
+  ASSERT_TRUE(queued != NULL);
+
+  const SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 10.0f,
+      .noise_rescale = 2.0f,
+  };
+  ASSERT_TRUE(specbleach_load_parameters(split, parameters));
+  ASSERT_TRUE(specbleach_load_parameters(queued, parameters));
+
+  enum { block_size = 4096, block_count = 40, change_block = 20 };
+  // Offsets within the block. 213 is the last sample of a frame (the hop is
+  // 507 samples), 214 the first of the next one and the last change lands in
+  // the following block.
+  const uint32_t offsets[] = {37, 213, 214, block_size + 300};
+  const SpectralBleachParameterId ids[] = {
+      SPECBLEACH_PARAMETER_LEARN_NOISE,
+      SPECBLEACH_PARAMETER_REDUCTION_AMOUNT,
+      SPECBLEACH_PARAMETER_SMOOTHING_FACTOR,
+      SPECBLEACH_PARAMETER_REDUCTION_AMOUNT,
+  };
+  const float values[] = {0.0f, 20.0f, 40.0f, 30.0f};
+  enum { change_count = sizeof(offsets) / sizeof(offsets[0]) };
+
+  float input[block_size];
+  float output_split[block_size];
+  float output_queued[block_size];
+  uint32_t seed = 7;
+
+  for (uint32_t block = 0; block < block_count; ++block) {
+    for (uint32_t k = 0; k < block_size; ++k) {
+      input[k] = 0.1f * test_noise(&seed) +
+                 0.2f * sinf((float)(block * block_size + k) * 0.03f);
+    }
+
+    uint32_t position = 0;
+    for (uint32_t i = 0; i < change_count; ++i) {
+      const uint32_t due = change_block * block_size + offsets[i];
+      if (due < block * block_size || due >= (block + 1) * block_size) {
+        continue;
+      }
+      const uint32_t offset = due - block * block_size;
+      if (offset > position) {
+        ASSERT_TRUE(specbleach_process(split, offset - position,
+                                       &input[position],
+                                       &output_split[position]));
+        position = offset;
+      }
+      ASSERT_TRUE(specbleach_set_parameter(split, ids[i], values[i]));
+    }
+    ASSERT_TRUE(specbleach_process(split, block_size - position,
+                                   &input[position], &output_split[position]));
+
+    if (block == change_block) {
+      for (uint32_t i = 0; i < change_count; ++i) {
+        ASSERT_TRUE(specbleach_queue_parameter(queued, ids[i], values[i],
+                                               offsets[i]));
+      }
+    }
+    ASSERT_TRUE(specbleach_process(queued, block_size, input, output_queued));
+
+    for (uint32_t k = 0; k < block_size; ++k) {
+      ASSERT_EQ(output_split[k], output_queued[k]);
+    }
+  }
+
+  EXPECT_FALSE(specbleach_queue_parameter(queued, SPECBLEACH_PARAMETER_COUNT,
+                                          1.0f, 0));
+
+  specbleach_free(split);
+  specbleach_free(queued);
+}
+
+static void process_noise(SpectralBleachHandle instance, uint32_t *seed,
+                          uint32_t number_of_samples, float *output);
+static bool outputs_match(SpectralBleachHandle a, SpectralBleachHandle b,
+                          uint32_t seed);
+
+// Parameters loaded after changes were queued replace them, instead of being
+// overwritten once the changes come due
+UTEST(library, load_parameters_drops_queued_changes) {
+  SpectralBleachHandle queued = specbleach_initialize(44100, 46);
+  SpectralBleachHandle loaded = specbleach_initialize(44100, 46);
+  ASSERT_TRUE(queued != NULL);
+  ASSERT_TRUE(loaded != NULL);
+
+  SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 10.0f,
+      .noise_rescale = 2.0f,
+  };
+  ASSERT_TRUE(specbleach_load_parameters(queued, parameters));
+  ASSERT_TRUE(specbleach_load_parameters(loaded, parameters));
+  enum { length = 512 * 64 };
+  static float scratch[length];
+  uint32_t seed_queued = 3;
+  uint32_t seed_loaded = 3;
+  process_noise(queued, &seed_queued, length, scratch);
+  process_noise(loaded, &seed_loaded, length, scratch);
+
+  ASSERT_TRUE(specbleach_queue_parameter(
+      queued, SPECBLEACH_PARAMETER_REDUCTION_AMOUNT, 0.0f, 100));
+  ASSERT_TRUE(specbleach_queue_parameter(
+      queued, SPECBLEACH_PARAMETER_LEARN_NOISE, 1.0f, 3000));
+  parameters.learn_noise = 0;
+  parameters.reduction_amount = 30.0f;
+  ASSERT_TRUE(specbleach_load_parameters(queued, parameters));
+  ASSERT_TRUE(specbleach_load_parameters(loaded, parameters));
+  EXPECT_TRUE(outputs_match(queued, loaded, 9));
+
+  specbleach_free(queued);
+  specbleach_free(loaded);
+}
+
+// Queuing never builds modules, so changes that need one are only accepted
+// once it was built
+UTEST(library, queued_changes_need_built_modules) {
+  SpectralBleachHandle instance = specbleach_initialize(44100, 46);
+  ASSERT_TRUE(instance != NULL);
+  SpectralBleachParameters parameters = {.reduction_amount = 10.0f};
+  ASSERT_TRUE(specbleach_load_parameters(instance, parameters));
+
+  EXPECT_FALSE(specbleach_queue_parameter(
+      instance, SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE, 2.0f, 0));
+  EXPECT_TRUE(specbleach_queue_parameter(
+      instance, SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE, 1.0f, 0));
+  EXPECT_TRUE(specbleach_queue_parameter(
+      instance, SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION, 0.0f, 0));
+
+  // Once selected they stay built
+  ASSERT_TRUE(specbleach_set_parameter(
+      instance, SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE, 2.0f));
+  ASSERT_TRUE(specbleach_set_parameter(
+      instance, SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION, 1.0f));
+  ASSERT_TRUE(specbleach_load_parameters(instance, parameters));
+  EXPECT_TRUE(specbleach_queue_parameter(
+      instance, SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE, 2.0f, 0));
+  EXPECT_TRUE(specbleach_queue_parameter(
+      instance, SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION, 1.0f, 0));
+  specbleach_free(instance);
+
+  // Prewarmed instances have all of them
+  instance = specbleach_initialize(44100, 46);
+  ASSERT_TRUE(instance != NULL);
+  ASSERT_TRUE(specbleach_prewarm(instance));
+  ASSERT_TRUE(specbleach_load_parameters(instance, parameters));
+  EXPECT_TRUE(specbleach_queue_parameter(
+      instance, SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE, 2.0f, 0));
+  EXPECT_TRUE(specbleach_queue_parameter(
+      instance, SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION, 1.0f, 0));
+  specbleach_free(instance);
+}
+
+// Presets change the cost of the processing but not its latency
+UTEST(library, presets) {
+  SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 20.0f,
+      .noise_scaling_type = 2,
+      .noise_rescale = 2.0f,
+  };
+  enum { length = 512 * 64 };
+  static float scratch[length];
+
+  const uint32_t expected_profile_sizes[SPECBLEACH_PRESET_COUNT] = {
+      2304 / 2 + 1, 4096 / 2 + 1, 4608 / 2 + 1};
+  SpectralBleachHandle standard = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(standard != NULL);
+
+  for (int preset = 0; preset < SPECBLEACH_PRESET_COUNT; ++preset) {
+    SpectralBleachHandle a =
+        specbleach_initialize_with_preset(48000, 46, preset);
+    SpectralBleachHandle b =
+        specbleach_initialize_with_preset(48000, 46, preset);
+    ASSERT_TRUE(a != NULL);
+    ASSERT_TRUE(b != NULL);
+    EXPECT_EQ(specbleach_get_latency(a), specbleach_get_latency(standard));
+    EXPECT_EQ(specbleach_get_noise_profile_size(a),
+              expected_profile_sizes[preset]);
+
+    parameters.learn_noise = 1;
+    parameters.noise_scaling_type = 2;
+    ASSERT_TRUE(specbleach_load_parameters(a, parameters));
+    ASSERT_TRUE(specbleach_load_parameters(b, parameters));
+    uint32_t seed_a = 3;
+    uint32_t seed_b = 3;
+    process_noise(a, &seed_a, length, scratch);
+    process_noise(b, &seed_b, length, scratch);
+
+    // Eco only has the a-posteriori snr scaling
+    parameters.learn_noise = 0;
+    ASSERT_TRUE(specbleach_load_parameters(a, parameters));
+    parameters.noise_scaling_type = 0;
+    ASSERT_TRUE(specbleach_load_parameters(b, parameters));
+    EXPECT_EQ(outputs_match(a, b, 4), preset == SPECBLEACH_PRESET_ECO);
+
+    specbleach_free(a);
+    specbleach_free(b);
+  }
+
+  // Reconfiguring to a preset is the same as starting with it
+  ASSERT_TRUE(specbleach_load_parameters(standard, parameters));
+  ASSERT_TRUE(specbleach_reconfigure_with_preset(standard, 48000, 46,
+                                                 SPECBLEACH_PRESET_HQ));
+  SpectralBleachHandle hq =
+      specbleach_initialize_with_preset(48000, 46, SPECBLEACH_PRESET_HQ);
+  ASSERT_TRUE(hq != NULL);
+  ASSERT_TRUE(specbleach_load_parameters(hq, parameters));
+  EXPECT_EQ(specbleach_get_noise_profile_size(standard),
+            specbleach_get_noise_profile_size(hq));
+  EXPECT_TRUE(outputs_match(standard, hq, 5));
+
+  EXPECT_TRUE(specbleach_initialize_with_preset(
+                  48000, 46, SPECBLEACH_PRESET_COUNT) == NULL);
+  EXPECT_FALSE(specbleach_reconfigure_with_preset(standard, 48000, 46,
+                                                  SPECBLEACH_PRESET_COUNT));
+
+  specbleach_free(hq);
+  specbleach_free(standard);
+}
+
+UTEST(library, runtime_config) {
+  SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 20.0f,
+      .noise_scaling_type = 2,
+      .noise_rescale = 2.0f,
+  };
+  enum { length = 512 * 64 };
+  static float scratch[length];
+
+  // The default config is what specbleach_initialize uses
+  SpectralBleachConfig config = specbleach_get_default_config(48000, 46);
+  EXPECT_EQ(config.version, (uint32_t)SPECBLEACH_CONFIG_VERSION);
+  SpectralBleachHandle a = specbleach_initialize_with_config(&config);
+  SpectralBleachHandle b = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(a != NULL);
+  ASSERT_TRUE(b != NULL);
+  ASSERT_TRUE(specbleach_load_parameters(a, parameters));
+  ASSERT_TRUE(specbleach_load_parameters(b, parameters));
+  uint32_t seed_a = 5;
+  uint32_t seed_b = 5;
+  process_noise(a, &seed_a, length, scratch);
+  process_noise(b, &seed_b, length, scratch);
+  parameters.learn_noise = 0;
+  ASSERT_TRUE(specbleach_load_parameters(a, parameters));
+  ASSERT_TRUE(specbleach_load_parameters(b, parameters));
+  EXPECT_TRUE(outputs_match(a, b, 6));
+
+  // Choices the presets don't touch can be changed too
+  config.critical_bands_type = 0;
+  config.median_spectrum_count = 7;
+  ASSERT_TRUE(specbleach_reconfigure_with_config(a, &config));
+  SpectralBleachConfig running = {.version = SPECBLEACH_CONFIG_VERSION};
+  ASSERT_TRUE(specbleach_get_config(a, &running));
+  EXPECT_EQ(running.critical_bands_type, 0);
+  EXPECT_EQ(running.median_spectrum_count, 7u);
+  process_noise(a, &seed_a, length, scratch);
+
+  // Plain reconfigure keeps them
+  ASSERT_TRUE(specbleach_reconfigure(a, 44100, 46));
+  ASSERT_TRUE(specbleach_get_config(a, &running));
+  EXPECT_EQ(running.sample_rate, 44100u);
+  EXPECT_EQ(running.median_spectrum_count, 7u);
+
+  // Windows chosen by the caller outlive a change of overlap
+  SpectralBleachConfig windowed = running;
+  windowed.input_window_type = 3;
+  windowed.output_window_type = 3;
+  ASSERT_TRUE(specbleach_reconfigure_with_config(a, &windowed));
+  ASSERT_TRUE(specbleach_reconfigure_with_overlap(a, 44100, 46, 8));
+  ASSERT_TRUE(specbleach_get_config(a, &running));
+  EXPECT_EQ(running.overlap_factor, 8u);
+  EXPECT_EQ(running.input_window_type, 3);
+  EXPECT_EQ(running.output_window_type, 3);
+
+  // Unknown versions and out of range choices are rejected
+  SpectralBleachConfig invalid = config;
+  invalid.version = SPECBLEACH_CONFIG_VERSION + 1;
+  EXPECT_TRUE(specbleach_initialize_with_config(&invalid) == NULL);
+  EXPECT_FALSE(specbleach_reconfigure_with_config(a, &invalid));
+  invalid = config;
+  invalid.gain_estimation_type = 3;
+  EXPECT_TRUE(specbleach_initialize_with_config(&invalid) == NULL);
+  invalid = config;
+  invalid.median_spectrum_count = 0;
+  EXPECT_TRUE(specbleach_initialize_with_config(&invalid) == NULL);
+  EXPECT_TRUE(specbleach_initialize_with_config(NULL) == NULL);
+
+  // Callers built against older headers have shorter configs, which are
+  // neither read nor written past their end
+  const size_t version_1_size = offsetof(SpectralBleachConfig, kernel_isa);
+  SpectralBleachConfig copied = config;
+  copied.version = 1U;
+  SpectralBleachConfig *version_1 =
+      (SpectralBleachConfig *)malloc(version_1_size);
+  ASSERT_TRUE(version_1 != NULL);
+  memcpy(version_1, &copied, version_1_size);
+  ASSERT_TRUE(specbleach_reconfigure_with_config(a, version_1));
+  SpectralBleachHandle c = specbleach_initialize_with_config(version_1);
+  ASSERT_TRUE(c != NULL);
+  memset(&copied, 0, sizeof(copied));
+  ASSERT_TRUE(specbleach_get_config(c, version_1));
+  memcpy(&copied, version_1, version_1_size);
+  EXPECT_EQ(copied.version, 1u);
+  EXPECT_EQ(copied.median_spectrum_count, 7u);
+  free(version_1);
+
+  SpectralBleachConfig version_2;
+  memset(&version_2, 0xff, sizeof(version_2));
+  version_2.version = 2U;
+  ASSERT_TRUE(specbleach_get_config(c, &version_2));
+  EXPECT_EQ(version_2.kernel_isa, (int)SPECBLEACH_KERNEL_ISA_AUTO);
+  uint8_t spread_frames_byte;
+  memcpy(&spread_frames_byte, &version_2.spread_frames, 1U);
+  EXPECT_EQ(spread_frames_byte, 0xffu);
+  version_2.version = 0U;
+  EXPECT_FALSE(specbleach_get_config(c, &version_2));
+
+  specbleach_free(a);
+  specbleach_free(b);
+  specbleach_free(c);
+}
+
+static void process_noise(SpectralBleachHandle instance, uint32_t *seed,
+                          uint32_t number_of_samples, float *output) {
+  enum { block_size = 512 };
+  float input[block_size];
+  for (uint32_t done = 0; done < number_of_samples; done += block_size) {
+    for (uint32_t k = 0; k < block_size; ++k) {
+      input[k] = 0.1f * test_noise(seed) + 0.2f * sinf((float)k * 0.07f);
+    }
+    specbleach_process(instance, block_size, input, &output[done]);
+  }
+}
+
+static bool outputs_match(SpectralBleachHandle a, SpectralBleachHandle b,
+                          uint32_t seed) {
+  enum { length = 512 * 64 };
+  static float output_a[length];
+  static float output_b[length];
+  uint32_t seed_a = seed;
+  uint32_t seed_b = seed;
+  process_noise(a, &seed_a, length, output_a);
+  process_noise(b, &seed_b, length, output_b);
+  return memcmp(output_a, output_b, sizeof(output_a)) == 0;
+}
+
+UTEST(library, instance_in_caller_memory) {
+  SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 20.0f,
+      .noise_scaling_type = 2,
+      .noise_rescale = 2.0f,
+  };
+  enum { length = 512 * 64 };
+  static float scratch[length];
+
+  const SpectralBleachConfig config = specbleach_get_default_config(48000, 46);
+  const size_t required = specbleach_get_memory_requirements(48000, 46);
+  ASSERT_GT(required, (size_t)0);
+  EXPECT_EQ(specbleach_get_memory_requirements_with_config(&config), required);
+
+  // Any alignment works
+  char *memory = (char *)malloc(required + 1);
+  ASSERT_TRUE(memory != NULL);
+  EXPECT_TRUE(specbleach_initialize_in_memory(&config, memory + 1,
+                                              required - 1) == NULL);
+  SpectralBleachHandle a =
+      specbleach_initialize_in_memory(&config, memory + 1, required);
+  SpectralBleachHandle b = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(a != NULL);
+  ASSERT_TRUE(b != NULL);
+
+  ASSERT_TRUE(specbleach_load_parameters(a, parameters));
+  ASSERT_TRUE(specbleach_load_parameters(b, parameters));
+  uint32_t seed_a = 9;
+  uint32_t seed_b = 9;
+  process_noise(a, &seed_a, length, scratch);
+  process_noise(b, &seed_b, length, scratch);
+  parameters.learn_noise = 0;
+  ASSERT_TRUE(specbleach_load_parameters(a, parameters));
+  ASSERT_TRUE(specbleach_load_parameters(b, parameters));
+  EXPECT_TRUE(outputs_match(a, b, 10));
+
+  // Only the same configuration fits in the memory it was created in
+  EXPECT_TRUE(specbleach_reconfigure(a, 48000, 46));
+  EXPECT_FALSE(specbleach_reconfigure(a, 44100, 46));
+  EXPECT_EQ(specbleach_get_latency(a), specbleach_get_latency(b));
+
+  specbleach_free(a);
+  specbleach_free(b);
+  free(memory);
+
+  SpectralBleachConfig invalid = config;
+  invalid.overlap_factor = 1;
+  EXPECT_EQ(specbleach_get_memory_requirements_with_config(&invalid),
+            (size_t)0);
+}
+
+static void learn_noise(SpectralBleachHandle instance,
+                        SpectralBleachParameters parameters) {
+  enum { length = 512 * 64 };
+  static float scratch[length];
+  uint32_t seed = 11;
+  parameters.learn_noise = 1;
+  specbleach_load_parameters(instance, parameters);
+  process_noise(instance, &seed, length, scratch);
+  parameters.learn_noise = 0;
+  specbleach_load_parameters(instance, parameters);
+}
+
+UTEST(library, optional_modules_built_when_needed) {
+  SpectralBleachParameters parameters = {
+      .reduction_amount = 20.0f,
+      .smoothing_factor = 50.0f,
+      .transient_protection = true,
+      .noise_scaling_type = 2,
+      .noise_rescale = 2.0f,
+  };
+
+  // Loading parameters that need them builds them as prewarming does
+  SpectralBleachHandle a = specbleach_initialize(48000, 46);
+  SpectralBleachHandle b = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(a != NULL);
+  ASSERT_TRUE(b != NULL);
+  ASSERT_TRUE(specbleach_prewarm(b));
+  learn_noise(a, parameters);
+  learn_noise(b, parameters);
+  EXPECT_TRUE(outputs_match(a, b, 12));
+
+  // And reconfiguring keeps them
+  ASSERT_TRUE(specbleach_reconfigure(a, 44100, 46));
+  ASSERT_TRUE(specbleach_reconfigure(b, 44100, 46));
+  EXPECT_TRUE(outputs_match(a, b, 13));
+  specbleach_free(a);
+  specbleach_free(b);
+
+  // Queued changes don't build them, so the changes that need them are
+  // rejected and the instance carries on with what was loaded
+  SpectralBleachHandle queued = specbleach_initialize(48000, 46);
+  SpectralBleachHandle loaded = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(queued != NULL);
+  ASSERT_TRUE(loaded != NULL);
+  parameters.transient_protection = false;
+  parameters.noise_scaling_type = 0;
+  learn_noise(queued, parameters);
+  learn_noise(loaded, parameters);
+  EXPECT_FALSE(specbleach_queue_parameter(
+      queued, SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE, 2.0f, 0));
+  EXPECT_FALSE(specbleach_queue_parameter(
+      queued, SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION, 1.0f, 0));
+  EXPECT_TRUE(outputs_match(queued, loaded, 14));
+
+  specbleach_free(queued);
+  specbleach_free(loaded);
+}
+
+UTEST(library, clone_matches_new_instance) {
+  SpectralBleachParameters parameters = {
+      .reduction_amount = 20.0f,
+      .smoothing_factor = 50.0f,
+      .transient_protection = true,
+      .noise_scaling_type = 2,
+      .noise_rescale = 2.0f,
+  };
+
+  SpectralBleachHandle source = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(source != NULL);
+  learn_noise(source, parameters);
+
+  // The noise profile isn't cloned, only what the source was built with
+  SpectralBleachHandle clone = specbleach_clone(source);
+  SpectralBleachHandle fresh = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(clone != NULL);
+  ASSERT_TRUE(fresh != NULL);
+  EXPECT_FALSE(specbleach_noise_profile_available(clone));
+  EXPECT_EQ(specbleach_get_latency(clone), specbleach_get_latency(source));
+  learn_noise(clone, parameters);
+  learn_noise(fresh, parameters);
+  EXPECT_TRUE(outputs_match(clone, fresh, 15));
+
+  // The tables outlive the source while a clone still reads them
+  specbleach_free(source);
+  EXPECT_TRUE(outputs_match(clone, fresh, 16));
+  ASSERT_TRUE(specbleach_reconfigure(clone, 44100, 46));
+  ASSERT_TRUE(specbleach_reconfigure(fresh, 44100, 46));
+  EXPECT_TRUE(outputs_match(clone, fresh, 17));
+
+  specbleach_free(clone);
+  specbleach_free(fresh);
+}
+
+// Optional modules built when parameters select them go in tables of the
+// instance's own, as parameters can be loaded from the thread each clone
+// processes on. So one clone going away never takes the tables of another
+UTEST(library, clones_build_optional_modules_apart) {
+  SpectralBleachParameters parameters = {
+      .reduction_amount = 20.0f,
+      .noise_rescale = 2.0f,
+  };
+
+  SpectralBleachHandle source = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(source != NULL);
+  specbleach_load_parameters(source, parameters);
+  SpectralBleachHandle clone = specbleach_clone(source);
+  SpectralBleachHandle fresh = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(clone != NULL);
+  ASSERT_TRUE(fresh != NULL);
+
+  parameters.noise_scaling_type = 2;
+  parameters.transient_protection = true;
+  learn_noise(clone, parameters);
+  specbleach_free(clone);
+
+  learn_noise(source, parameters);
+  learn_noise(fresh, parameters);
+  EXPECT_TRUE(outputs_match(source, fresh, 18));
+
+  specbleach_free(source);
+  specbleach_free(fresh);
+}
+
+// Spreading the frames over the hop after them only delays the output by that
+// hop, whatever size the buffers are
+UTEST(library, spread_frames_delay_output_by_a_hop) {
+  SpectralBleachParameters parameters = {
+      .reduction_amount = 20.0f,
+      .smoothing_factor = 50.0f,
+      .transient_protection = true,
+      .whitening_factor = 50.0f,
+      .noise_scaling_type = 2,
+      .noise_rescale = 2.0f,
+  };
+  enum { length = 48000 };
+  static float input[length];
+  static float output[length];
+  static float spread_output[length];
+
+  SpectralBleachConfig config = specbleach_get_default_config(48000, 46);
+  SpectralBleachHandle instance = specbleach_initialize_with_config(&config);
+  config.spread_frames = true;
+  SpectralBleachHandle spread = specbleach_initialize_with_config(&config);
+  ASSERT_TRUE(instance != NULL);
+  ASSERT_TRUE(spread != NULL);
+  SpectralBleachConfig running = {.version = SPECBLEACH_CONFIG_VERSION};
+  ASSERT_TRUE(specbleach_get_config(spread, &running));
+  EXPECT_TRUE(running.spread_frames);
+
+  const uint32_t hop = specbleach_get_latency(instance) / config.overlap_factor;
+  EXPECT_EQ(specbleach_get_latency(spread),
+            specbleach_get_latency(instance) + hop);
+
+  learn_noise(instance, parameters);
+  specbleach_reset(instance);
+  ASSERT_TRUE(specbleach_load_parameters(spread, parameters));
+  ASSERT_TRUE(specbleach_load_noise_profile(
+      spread, specbleach_get_noise_profile(instance),
+      specbleach_get_noise_profile_size(instance),
+      specbleach_get_noise_profile_blocks_averaged(instance)));
+
+  uint32_t seed = 3;
+  for (uint32_t i = 0; i < length; i++) {
+    input[i] = 0.1f * test_noise(&seed) + 0.2f * sinf((float)i * 0.07f);
+  }
+
+  // Buffers from a single sample to more than a hop at a time
+  const uint32_t block_sizes[] = {1, 7, 64, 256, 1000};
+  uint32_t block = 0;
+  for (uint32_t i = 0; i < length; i += block) {
+    block = block_sizes[(i / 997) % 5];
+    block = length - i < block ? length - i : block;
+    ASSERT_TRUE(specbleach_process(instance, block, &input[i], &output[i]));
+    ASSERT_TRUE(
+        specbleach_process(spread, block, &input[i], &spread_output[i]));
+  }
+
+  for (uint32_t i = 0; i < hop; i++) {
+    EXPECT_EQ(spread_output[i], 0.f);
+  }
+  EXPECT_EQ(memcmp(&spread_output[hop], output,
+                   (length - hop) * sizeof(float)),
+            0);
+
+  specbleach_free(instance);
+  specbleach_free(spread);
+}
+
+// Without a noise profile the spectrum is left as it is, so the output has to
+// be the input delayed by the latency for any overlap. 44100hz gives frames
+// that aren't a multiple of most of the overlaps
+UTEST(library, kernel_isas_match_scalar) {
+  SpectralBleachParameters parameters = {
+      .reduction_amount = 20.0f,
+      .smoothing_factor = 50.0f,
+      .whitening_factor = 50.0f,
+      .noise_scaling_type = 2,
+      .noise_rescale = 2.0f,
+  };
+
+  SpectralBleachConfig config = specbleach_get_default_config(48000, 46);
+  config.kernel_isa = SPECBLEACH_KERNEL_ISA_AVX512 + 1;
+  EXPECT_TRUE(specbleach_initialize_with_config(&config) == NULL);
+
+  // Sets the machine doesn't have fall back to one it does, and every set
+  // gives the same output as the plain C loops
+  for (int isa = SPECBLEACH_KERNEL_ISA_SSE2;
+       isa <= SPECBLEACH_KERNEL_ISA_AVX512; ++isa) {
+    // Gates and Wiener gains, the generalized subtraction is scalar only
+    config.gain_estimation_type = isa % 2;
+    config.kernel_isa = SPECBLEACH_KERNEL_ISA_SCALAR;
+    SpectralBleachHandle scalar = specbleach_initialize_with_config(&config);
+    config.kernel_isa = isa;
+    SpectralBleachHandle vector = specbleach_initialize_with_config(&config);
+    ASSERT_TRUE(scalar != NULL);
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(specbleach_get_kernel_isa(scalar), SPECBLEACH_KERNEL_ISA_SCALAR);
+    EXPECT_LE((int)specbleach_get_kernel_isa(vector), isa);
+
+    learn_noise(scalar, parameters);
+    learn_noise(vector, parameters);
+    EXPECT_TRUE(outputs_match(scalar, vector, 19));
+
+    specbleach_free(scalar);
+    specbleach_free(vector);
+  }
+}
+
+UTEST(library, overlap_add_reconstructs_input) {
+  SpectralBleachParameters parameters = {0};
+  enum { length = 44100 };
+  static float input[length];
+  static float output[length];
+  const uint32_t overlaps[] = {2, 4, 6, 8, 16};
+  const uint32_t sample_rates[] = {44100, 48000};
+
+  uint32_t seed = 7;
+  for (uint32_t i = 0; i < length; i++) {
+    input[i] = test_noise(&seed);
+  }
+
+  for (uint32_t r = 0; r < 2; r++) {
+    for (uint32_t o = 0; o < sizeof(overlaps) / sizeof(overlaps[0]); o++) {
+      SpectralBleachHandle instance = specbleach_initialize_with_overlap(
+          sample_rates[r], 46, overlaps[o]);
+      ASSERT_TRUE(instance != NULL);
+      ASSERT_TRUE(specbleach_load_parameters(instance, parameters));
+
+      // The frame, rounded down to a multiple of 8, whatever the overlap
+      const uint32_t latency = specbleach_get_latency(instance);
+      const uint32_t frame = (uint32_t)(0.046f * (float)sample_rates[r]);
+      EXPECT_EQ(latency, frame - frame % 8u);
+      for (uint32_t i = 0; i < length; i += 512) {
+        const uint32_t block = length - i < 512 ? length - i : 512;
+        ASSERT_TRUE(
+            specbleach_process(instance, block, &input[i], &output[i]));
+      }
+
+      float max_error = 0.f;
+      for (uint32_t i = 2 * latency; i < length; i++) {
+        const float error = fabsf(output[i] - input[i - latency]);
+        max_error = error > max_error ? error : max_error;
+      }
+      EXPECT_LT(max_error, 1e-4f);
+
+      specbleach_free(instance);
+    }
+  }
+}
+
+// A reset or reconfigured instance must behave exactly like a new one that
+// was given the same parameters and noise profile
+UTEST(library, reset_and_reconfigure_match_new_instance) {
+  SpectralBleachParameters parameters = {
+      .learn_noise = 1,
+      .reduction_amount = 20.0f,
+      .smoothing_factor = 50.0f,
+      .transient_protection = true,
+      .whitening_factor = 50.0f,
+      .noise_rescale = 2.0f,
+  };
+
+  SpectralBleachHandle reused = specbleach_initialize(44100, 46);
+  ASSERT_TRUE(reused != NULL);
+  ASSERT_TRUE(specbleach_load_parameters(reused, parameters));
+
+  enum { length = 512 * 64 };
+  static float scratch[length];
+  uint32_t seed = 11;
+  process_noise(reused, &seed, length, scratch);
+
+  parameters.learn_noise = 0;
+  ASSERT_TRUE(specbleach_load_parameters(reused, parameters));
+  process_noise(reused, &seed, length, scratch);
+
+  const uint32_t profile_size = specbleach_get_noise_profile_size(reused);
+  const uint32_t blocks_averaged =
+      specbleach_get_noise_profile_blocks_averaged(reused);
+  static float profile[8192];
+  ASSERT_LE(profile_size, 8192u);
+  memcpy(profile, specbleach_get_noise_profile(reused),
+         profile_size * sizeof(float));
+
+  specbleach_reset(reused);
+  SpectralBleachHandle fresh = specbleach_initialize(44100, 46);
+  ASSERT_TRUE(fresh != NULL);
+  ASSERT_TRUE(specbleach_load_parameters(fresh, parameters));
+  ASSERT_TRUE(specbleach_load_noise_profile(fresh, profile, profile_size,
+                                            blocks_averaged));
+  EXPECT_TRUE(outputs_match(reused, fresh, 5));
+
+  // Same configuration, so this is only a reset
+  ASSERT_TRUE(specbleach_reconfigure(reused, 44100, 46));
+  specbleach_reset(fresh);
+  EXPECT_TRUE(outputs_match(reused, fresh, 6));
+  specbleach_free(fresh);
+
+  ASSERT_TRUE(specbleach_reconfigure(reused, 48000, 46));
+  fresh = specbleach_initialize(48000, 46);
+  ASSERT_TRUE(fresh != NULL);
+  ASSERT_TRUE(specbleach_load_parameters(fresh, parameters));
+  ASSERT_TRUE(specbleach_load_noise_profile(fresh, profile, profile_size,
+                                            blocks_averaged));
+  EXPECT_EQ(specbleach_get_latency(reused), specbleach_get_latency(fresh));
+  EXPECT_TRUE(outputs_match(reused, fresh, 7));
+
+  specbleach_free(fresh);
+
+  // Only the overlap changes, so the latency stays the same
+  ASSERT_TRUE(specbleach_reconfigure_with_overlap(reused, 48000, 46, 8));
+  fresh = specbleach_initialize_with_overlap(48000, 46, 8);
+  ASSERT_TRUE(fresh != NULL);
+  ASSERT_TRUE(specbleach_load_parameters(fresh, parameters));
+  ASSERT_TRUE(specbleach_load_noise_profile(fresh, profile, profile_size,
+                                            blocks_averaged));
+  EXPECT_EQ(specbleach_get_latency(reused), specbleach_get_latency(fresh));
+  EXPECT_TRUE(outputs_match(reused, fresh, 8));
+
+  // The overlap is kept when it isn't given
+  ASSERT_TRUE(specbleach_reconfigure(reused, 48000, 46));
+  specbleach_reset(fresh);
+  EXPECT_TRUE(outputs_match(reused, fresh, 9));
+
+  EXPECT_TRUE(specbleach_initialize_with_overlap(48000, 46, 1) == NULL);
+  EXPECT_FALSE(specbleach_reconfigure_with_overlap(reused, 48000, 46, 1));
+
+  specbleach_free(fresh);
+  specbleach_free(reused);
+}
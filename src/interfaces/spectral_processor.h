@@ -22,6 +22,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define SPECTRAL_PROCESSOR_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 // Generic Spectral Processing function over an FFT spectrum. Receives any
 // spectral processing module handle (void *) and the FFT of a audio block.
@@ -29,8 +30,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 // STFT transform at runtime
 typedef void *SpectralProcessorHandle;
 
+// Processing functions split their work in this many steps, which are called
+// in order over the same spectrum. When frames are spread over time each step
+// runs in a different call, so whatever a step leaves for the next one has to
+// live in the processor and not in shared scratch buffers. Processors that
+// don't split their work do all of it in the first step
+#define SPECTRAL_PROCESSING_STEP_COUNT 2U
+
 // Processing function which deals with the fft spectrum by mutating the array
 // with any DSP that operates with the FFT spectrum (1d FFTW spectrum)
 typedef bool (*spectral_processing)(SpectralProcessorHandle spectral_processor,
-                                    float *fft_spectrum);
+                                    float *fft_spectrum, uint32_t step);
 #endif
\ No newline at end of file
@@ -27,6 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "../../shared/pre_estimation/noise_scaling_criterias.h"
 #include "../../shared/pre_estimation/spectral_smoother.h"
 #include "../../shared/utils/denoise_mixer.h"
+#include "../../shared/utils/scratch_pool.h"
 #include "../../shared/utils/spectral_features.h"
 #include "../../shared/utils/spectral_utils.h"
 #include <float.h>
@@ -47,8 +48,6 @@ typedef struct SpectralAdaptiveDenoiser {
   float *alpha;
   float *beta;
   float *gain_spectrum;
-  float *residual_spectrum;
-  float *denoised_spectrum;
   float *noise_profile;
 
   SpectrumType spectrum_type;
@@ -56,6 +55,8 @@ typedef struct SpectralAdaptiveDenoiser {
   GainEstimationType gain_estimation_type;
   TimeSmoothingType time_smoothing_type;
 
+  const SpectralKernels *kernels;
+  ScratchPool *scratch;
   DenoiseMixer *mixer;
   NoiseScalingCriterias *noise_scaling_criteria;
   SpectralSmoother *spectrum_smoothing;
@@ -65,12 +66,14 @@ typedef struct SpectralAdaptiveDenoiser {
 } SpectralAdaptiveDenoiser;
 
 SpectralProcessorHandle
-spectral_adaptive_denoiser_initialize(const uint32_t sample_rate,
+spectral_adaptive_denoiser_initialize(Arena *arena, DspTables *tables,
+                                      const SpectralKernels *kernels,
+                                      const uint32_t sample_rate,
                                       const uint32_t fft_size,
                                       const uint32_t overlap_factor) {
 
-  SpectralAdaptiveDenoiser *self =
-      (SpectralAdaptiveDenoiser *)calloc(1U, sizeof(SpectralAdaptiveDenoiser));
+  SpectralAdaptiveDenoiser *self = (SpectralAdaptiveDenoiser *)arena_calloc(
+      arena, 1U, sizeof(SpectralAdaptiveDenoiser));
 
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
@@ -82,58 +85,47 @@ spectral_adaptive_denoiser_initialize(const uint32_t sample_rate,
   self->band_type = CRITICAL_BANDS_TYPE_SPEECH;
   self->gain_estimation_type = GAIN_ESTIMATION_TYPE_SPEECH;
   self->time_smoothing_type = TIME_SMOOTHING_TYPE_SPEECH;
+  self->kernels = kernels;
 
-  self->gain_spectrum = (float *)calloc(self->fft_size, sizeof(float));
+  self->gain_spectrum =
+      (float *)arena_calloc(arena, self->fft_size, sizeof(float));
   initialize_spectrum_with_value(self->gain_spectrum, self->fft_size, 1.F);
-  self->alpha = (float *)calloc(self->real_spectrum_size, sizeof(float));
+  self->alpha =
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
   initialize_spectrum_with_value(self->alpha, self->real_spectrum_size, 1.F);
-  self->beta = (float *)calloc(self->real_spectrum_size, sizeof(float));
+  self->beta =
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
   self->noise_profile =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
 
   self->adaptive_estimator = louizou_estimator_initialize(
-      self->real_spectrum_size, sample_rate, fft_size);
+      arena, self->real_spectrum_size, sample_rate, fft_size);
 
-  self->residual_spectrum = (float *)calloc((self->fft_size), sizeof(float));
-  self->denoised_spectrum = (float *)calloc((self->fft_size), sizeof(float));
+  self->scratch = scratch_pool_initialize(arena, self->fft_size);
 
-  self->postfiltering = postfilter_initialize(self->fft_size);
+  self->postfiltering =
+      postfilter_initialize(arena, tables, self->scratch, self->kernels,
+                            self->fft_size, POSTFILTER_SCALE);
 
-  self->spectrum_smoothing =
-      spectral_smoothing_initialize(self->fft_size, self->time_smoothing_type);
+  self->spectrum_smoothing = spectral_smoothing_initialize(
+      arena, self->scratch, self->fft_size, self->time_smoothing_type);
 
   self->noise_scaling_criteria = noise_scaling_criterias_initialize(
-      self->fft_size, self->band_type, self->sample_rate, self->spectrum_type);
+      arena, tables, self->scratch, self->fft_size, self->band_type,
+      self->sample_rate, self->spectrum_type);
+  noise_scaling_criterias_prepare_masking(self->noise_scaling_criteria, arena,
+                                          tables);
 
   self->spectral_features =
-      spectral_features_initialize(self->real_spectrum_size);
+      spectral_features_initialize(arena, self->real_spectrum_size);
 
   self->mixer =
-      denoise_mixer_initialize(self->fft_size, self->sample_rate, self->hop);
+      denoise_mixer_initialize(arena, self->scratch, self->kernels,
+                               self->fft_size, self->sample_rate, self->hop);
 
   return self;
 }
 
-void spectral_adaptive_denoiser_free(SpectralProcessorHandle instance) {
-  SpectralAdaptiveDenoiser *self = (SpectralAdaptiveDenoiser *)instance;
-
-  louizou_estimator_free(self->adaptive_estimator);
-  spectral_features_free(self->spectral_features);
-  noise_scaling_criterias_free(self->noise_scaling_criteria);
-  spectral_smoothing_free(self->spectrum_smoothing);
-  postfilter_free(self->postfiltering);
-  denoise_mixer_free(self->mixer);
-
-  free(self->residual_spectrum);
-  free(self->denoised_spectrum);
-  free(self->noise_profile);
-  free(self->gain_spectrum);
-  free(self->alpha);
-  free(self->beta);
-
-  free(self);
-}
-
 bool load_adaptive_reduction_parameters(SpectralProcessorHandle instance,
                                         AdaptiveDenoiserParameters parameters) {
   if (!instance) {
@@ -147,11 +139,16 @@ bool load_adaptive_reduction_parameters(SpectralProcessorHandle instance,
 }
 
 bool spectral_adaptive_denoiser_run(SpectralProcessorHandle instance,
-                                    float *fft_spectrum) {
+                                    float *fft_spectrum,
+                                    const uint32_t step) {
   if (!fft_spectrum || !instance) {
     return false;
   }
 
+  if (step != 0U) {
+    return true;
+  }
+
   SpectralAdaptiveDenoiser *self = (SpectralAdaptiveDenoiser *)instance;
 
   float *reference_spectrum =
@@ -181,9 +178,9 @@ bool spectral_adaptive_denoiser_run(SpectralProcessorHandle instance,
                          spectral_smoothing_parameters, reference_spectrum);
 
   // Get reduction gain weights
-  estimate_gains(self->real_spectrum_size, self->fft_size, reference_spectrum,
-                 self->noise_profile, self->gain_spectrum, self->alpha,
-                 self->beta, self->gain_estimation_type);
+  estimate_gains(self->kernels, self->real_spectrum_size, self->fft_size,
+                 reference_spectrum, self->noise_profile, self->gain_spectrum,
+                 self->alpha, self->beta, self->gain_estimation_type);
 
   // Apply post filtering to reduce residual noise on low SNR frames
   PostFiltersParameters post_filter_parameters = (PostFiltersParameters){
@@ -22,6 +22,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define SPECTRAL_ADAPTIVE_DENOISER_H
 
 #include "../../interfaces/spectral_processor.h"
+#include "../../shared/utils/arena.h"
+#include "../../shared/utils/dsp_tables.h"
+#include "../../shared/utils/spectral_kernels.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -36,12 +39,15 @@ typedef struct AdaptiveDenoiserParameters {
 } AdaptiveDenoiserParameters;
 
 SpectralProcessorHandle
-spectral_adaptive_denoiser_initialize(uint32_t sample_rate, uint32_t fft_size,
+spectral_adaptive_denoiser_initialize(Arena *arena, DspTables *tables,
+                                      const SpectralKernels *kernels,
+                                      uint32_t sample_rate,
+                                      uint32_t fft_size,
                                       uint32_t overlap_factor);
-void spectral_adaptive_denoiser_free(SpectralProcessorHandle instance);
 bool load_adaptive_reduction_parameters(SpectralProcessorHandle instance,
                                         AdaptiveDenoiserParameters parameters);
+// Does all of its work in the first step
 bool spectral_adaptive_denoiser_run(SpectralProcessorHandle instance,
-                                    float *fft_spectrum);
+                                    float *fft_spectrum, uint32_t step);
 
 #endif
\ No newline at end of file
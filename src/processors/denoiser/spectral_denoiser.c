@@ -27,6 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "../../shared/pre_estimation/noise_scaling_criterias.h"
 #include "../../shared/pre_estimation/spectral_smoother.h"
 #include "../../shared/utils/denoise_mixer.h"
+#include "../../shared/utils/scratch_pool.h"
 #include "../../shared/utils/spectral_features.h"
 #include "../../shared/utils/spectral_utils.h"
 #include <float.h>
@@ -46,6 +47,7 @@ typedef struct SbSpectralDenoiser {
   float *alpha;
   float *beta;
   float *noise_spectrum;
+  bool gains_pending;
 
   SpectrumType spectrum_type;
   CriticalBandType band_type;
@@ -54,6 +56,8 @@ typedef struct SbSpectralDenoiser {
   TimeSmoothingType time_smoothing_type;
   NoiseEstimatorType noise_estimator_type;
 
+  const SpectralKernels *kernels;
+  ScratchPool *scratch;
   NoiseEstimator *noise_estimator;
   PostFilter *postfiltering;
   NoiseProfile *noise_profile;
@@ -64,71 +68,113 @@ typedef struct SbSpectralDenoiser {
 } SbSpectralDenoiser;
 
 SpectralProcessorHandle spectral_denoiser_initialize(
+    Arena *arena, DspTables *tables, ScratchPool *scratch,
     const uint32_t sample_rate, const uint32_t fft_size,
-    const uint32_t overlap_factor, NoiseProfile *noise_profile) {
+    const uint32_t overlap_factor, NoiseProfile *noise_profile,
+    const DenoiserConfiguration configuration) {
 
   SbSpectralDenoiser *self =
-      (SbSpectralDenoiser *)calloc(1U, sizeof(SbSpectralDenoiser));
+      (SbSpectralDenoiser *)arena_calloc(arena, 1U, sizeof(SbSpectralDenoiser));
 
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
   self->hop = self->fft_size / overlap_factor;
   self->sample_rate = sample_rate;
   self->spectrum_type = SPECTRAL_TYPE_GENERAL;
-  self->band_type = CRITICAL_BANDS_TYPE;
+  self->band_type = configuration.band_type;
   self->default_oversubtraction = DEFAULT_OVERSUBTRACTION;
   self->default_undersubtraction = DEFAULT_UNDERSUBTRACTION;
-  self->gain_estimation_type = GAIN_ESTIMATION_TYPE;
-  self->time_smoothing_type = TIME_SMOOTHING_TYPE;
+  self->gain_estimation_type = configuration.gain_estimation_type;
+  self->time_smoothing_type = configuration.time_smoothing_type;
+  self->kernels = configuration.kernels;
 
-  self->gain_spectrum = (float *)calloc(self->fft_size, sizeof(float));
+  self->gain_spectrum =
+      (float *)arena_calloc(arena, self->fft_size, sizeof(float));
   initialize_spectrum_with_value(self->gain_spectrum, self->fft_size, 1.F);
-  self->alpha = (float *)calloc(self->real_spectrum_size, sizeof(float));
+  self->alpha =
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
   initialize_spectrum_with_value(self->alpha, self->real_spectrum_size, 1.F);
-  self->beta = (float *)calloc(self->real_spectrum_size, sizeof(float));
+  self->beta =
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
 
   self->noise_profile = noise_profile;
   self->noise_spectrum =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
 
-  self->noise_estimator =
-      noise_estimation_initialize(self->fft_size, noise_profile);
+  self->noise_estimator = noise_estimation_initialize(
+      arena, self->kernels, self->fft_size,
+      configuration.median_spectrum_count, noise_profile);
 
   self->spectral_features =
-      spectral_features_initialize(self->real_spectrum_size);
+      spectral_features_initialize(arena, self->real_spectrum_size);
 
-  self->postfiltering = postfilter_initialize(self->fft_size);
+  // The stages below run one after the other on each frame, so the buffers
+  // they only need while running are shared between them
+  self->scratch = scratch;
 
-  self->spectrum_smoothing =
-      spectral_smoothing_initialize(self->fft_size, self->time_smoothing_type);
+  self->postfiltering = postfilter_initialize(
+      arena, tables, self->scratch, self->kernels, self->fft_size,
+      configuration.postfilter_scale);
+
+  self->spectrum_smoothing = spectral_smoothing_initialize(
+      arena, self->scratch, self->fft_size, self->time_smoothing_type);
 
   self->noise_scaling_criteria = noise_scaling_criterias_initialize(
-      self->fft_size, self->band_type, self->sample_rate, self->spectrum_type);
+      arena, tables, self->scratch, self->fft_size, self->band_type,
+      self->sample_rate, self->spectrum_type);
 
   self->mixer =
-      denoise_mixer_initialize(self->fft_size, self->sample_rate, self->hop);
+      denoise_mixer_initialize(arena, self->scratch, self->kernels,
+                               self->fft_size, self->sample_rate, self->hop);
 
   return self;
 }
 
-void spectral_denoiser_free(SpectralProcessorHandle instance) {
+bool spectral_denoiser_prepare(SpectralProcessorHandle instance, Arena *arena,
+                               DspTables *tables,
+                               const bool masking_thresholds,
+                               const bool transient_protection) {
   SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
 
-  // Don't free noise profile used as reference here
+  if (masking_thresholds && !noise_scaling_criterias_prepare_masking(
+                                self->noise_scaling_criteria, arena,
+                                tables)) {
+    return false;
+  }
+
+  if (transient_protection &&
+      !spectral_smoothing_prepare_transient_detection(self->spectrum_smoothing,
+                                                      arena)) {
+    return false;
+  }
+
+  return true;
+}
+
+bool spectral_denoiser_is_prepared(SpectralProcessorHandle instance,
+                                   const bool masking_thresholds,
+                                   const bool transient_protection) {
+  const SbSpectralDenoiser *self = (const SbSpectralDenoiser *)instance;
 
-  noise_estimation_free(self->noise_estimator);
-  spectral_features_free(self->spectral_features);
-  spectral_smoothing_free(self->spectrum_smoothing);
-  noise_scaling_criterias_free(self->noise_scaling_criteria);
-  postfilter_free(self->postfiltering);
-  denoise_mixer_free(self->mixer);
+  return (!masking_thresholds ||
+          noise_scaling_criterias_has_masking(self->noise_scaling_criteria)) &&
+         (!transient_protection || spectral_smoothing_has_transient_detection(
+                                       self->spectrum_smoothing));
+}
 
-  free(self->gain_spectrum);
-  free(self->alpha);
-  free(self->beta);
-  free(self->noise_spectrum);
+void spectral_denoiser_reset(SpectralProcessorHandle instance) {
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
 
-  free(self);
+  noise_estimation_reset(self->noise_estimator);
+  spectral_smoothing_reset(self->spectrum_smoothing);
+  denoise_mixer_reset(self->mixer);
+
+  initialize_spectrum_with_value(self->gain_spectrum, self->fft_size, 1.F);
+  initialize_spectrum_with_value(self->alpha, self->real_spectrum_size, 1.F);
+  initialize_spectrum_with_value(self->beta, self->real_spectrum_size, 0.F);
+  initialize_spectrum_with_value(self->noise_spectrum,
+                                 self->real_spectrum_size, 0.F);
+  self->gains_pending = false;
 }
 
 bool load_reduction_parameters(SpectralProcessorHandle instance,
@@ -143,14 +189,8 @@ bool load_reduction_parameters(SpectralProcessorHandle instance,
   return true;
 }
 
-bool spectral_denoiser_run(SpectralProcessorHandle instance,
-                           float *fft_spectrum) {
-  if (!fft_spectrum || !instance) {
-    return false;
-  }
-
-  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
-
+static void estimate_frame_gains(SbSpectralDenoiser *self,
+                                 const float *fft_spectrum) {
   float *reference_spectrum =
       get_spectral_feature(self->spectral_features, fft_spectrum,
                            self->fft_size, self->spectrum_type);
@@ -185,25 +225,49 @@ bool spectral_denoiser_run(SpectralProcessorHandle instance,
                            spectral_smoothing_parameters, reference_spectrum);
 
     // Get reduction gain weights
-    estimate_gains(self->real_spectrum_size, self->fft_size, reference_spectrum,
-                   self->noise_spectrum, self->gain_spectrum, self->alpha,
-                   self->beta, self->gain_estimation_type);
+    estimate_gains(self->kernels, self->real_spectrum_size, self->fft_size,
+                   reference_spectrum, self->noise_spectrum,
+                   self->gain_spectrum, self->alpha, self->beta,
+                   self->gain_estimation_type);
 
-    // Apply post filtering to reduce residual noise on low SNR frames
+    // Design the post filter that reduces residual noise on low SNR frames
     PostFiltersParameters post_filter_parameters = (PostFiltersParameters){
         .snr_threshold = self->denoise_parameters.post_filter_threshold,
     };
-    postfilter_apply(self->postfiltering, fft_spectrum, self->gain_spectrum,
-                     post_filter_parameters);
+    postfilter_design(self->postfiltering, fft_spectrum, self->gain_spectrum,
+                      post_filter_parameters);
 
-    DenoiseMixerParameters mixer_parameters = (DenoiseMixerParameters){
-        .noise_level = self->denoise_parameters.reduction_amount,
-        .residual_listen = self->denoise_parameters.residual_listen,
-        .whitening_amount = self->denoise_parameters.whitening_factor,
-    };
+    self->gains_pending = true;
+  }
+}
+
+static void apply_frame_gains(SbSpectralDenoiser *self, float *fft_spectrum) {
+  postfilter_filter_gains(self->postfiltering, self->gain_spectrum);
+
+  DenoiseMixerParameters mixer_parameters = (DenoiseMixerParameters){
+      .noise_level = self->denoise_parameters.reduction_amount,
+      .residual_listen = self->denoise_parameters.residual_listen,
+      .whitening_amount = self->denoise_parameters.whitening_factor,
+  };
+
+  denoise_mixer_run(self->mixer, fft_spectrum, self->gain_spectrum,
+                    mixer_parameters);
+}
+
+bool spectral_denoiser_run(SpectralProcessorHandle instance,
+                           float *fft_spectrum, const uint32_t step) {
+  if (!fft_spectrum || !instance) {
+    return false;
+  }
+
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
 
-    denoise_mixer_run(self->mixer, fft_spectrum, self->gain_spectrum,
-                      mixer_parameters);
+  // Each step carries one of the two transform pairs of the post filter
+  if (step == 0U) {
+    estimate_frame_gains(self, fft_spectrum);
+  } else if (self->gains_pending) {
+    apply_frame_gains(self, fft_spectrum);
+    self->gains_pending = false;
   }
 
   return true;
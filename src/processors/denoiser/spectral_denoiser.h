@@ -22,7 +22,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define SPECTRAL_DENOISER_H
 
 #include "../../interfaces/spectral_processor.h"
+#include "../../shared/gain_estimation/gain_estimators.h"
 #include "../../shared/noise_estimation/noise_profile.h"
+#include "../../shared/pre_estimation/critical_bands.h"
+#include "../../shared/pre_estimation/spectral_smoother.h"
+#include "../../shared/utils/scratch_pool.h"
+#include "../../shared/utils/spectral_kernels.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -38,14 +43,40 @@ typedef struct DenoiserParameters {
   float post_filter_threshold;
 } DenoiserParameters;
 
+// Choices that are fixed for the lifetime of the denoiser
+typedef struct DenoiserConfiguration {
+  CriticalBandType band_type;
+  GainEstimationType gain_estimation_type;
+  TimeSmoothingType time_smoothing_type;
+  uint32_t median_spectrum_count;
+  float postfilter_scale;
+  const SpectralKernels *kernels;
+} DenoiserConfiguration;
+
 SpectralProcessorHandle
-spectral_denoiser_initialize(uint32_t sample_rate, uint32_t fft_size,
-                             uint32_t overlap_factor,
-                             NoiseProfile *noise_profile);
-void spectral_denoiser_free(SpectralProcessorHandle instance);
+spectral_denoiser_initialize(Arena *arena, DspTables *tables,
+                             ScratchPool *scratch, uint32_t sample_rate,
+                             uint32_t fft_size, uint32_t overlap_factor,
+                             NoiseProfile *noise_profile,
+                             DenoiserConfiguration configuration);
+// Builds the modules that only masking thresholds scaling and transient
+// protection use, out of the given arena, if they aren't built yet. Without
+// them those fall back to critical bands scaling and no protection
+bool spectral_denoiser_prepare(SpectralProcessorHandle instance, Arena *arena,
+                               DspTables *tables, bool masking_thresholds,
+                               bool transient_protection);
+// Whether the modules the given features use are built already
+bool spectral_denoiser_is_prepared(SpectralProcessorHandle instance,
+                                   bool masking_thresholds,
+                                   bool transient_protection);
+// Clears everything that depends on previously processed audio. Parameters
+// and the noise profile are kept
+void spectral_denoiser_reset(SpectralProcessorHandle instance);
 bool load_reduction_parameters(SpectralProcessorHandle instance,
                                DenoiserParameters parameters);
+// The first step estimates the gains and designs the post filter, the second
+// one filters the gains and applies them
 bool spectral_denoiser_run(SpectralProcessorHandle instance,
-                           float *fft_spectrum);
+                           float *fft_spectrum, uint32_t step);
 
 #endif
\ No newline at end of file
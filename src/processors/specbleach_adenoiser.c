@@ -22,12 +22,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "../shared/configurations.h"
 #include "../shared/stft/stft_processor.h"
 #include "../shared/utils/general_utils.h"
+#include "../shared/utils/spectral_kernels.h"
 #include "adaptivedenoiser/adaptive_denoiser.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
 typedef struct SbAdaptiveDenoiser {
+  Arena arena;
   uint32_t sample_rate;
   AdaptiveDenoiserParameters denoise_parameters;
 
@@ -41,11 +43,13 @@ SpectralBleachHandle specbleach_adaptive_initialize(const uint32_t sample_rate,
       (SbAdaptiveDenoiser *)calloc(1U, sizeof(SbAdaptiveDenoiser));
 
   self->sample_rate = sample_rate;
+  arena_initialize(&self->arena);
+  DspTables *tables = dsp_tables_initialize(&self->arena);
 
   self->stft_processor = stft_processor_initialize(
-      sample_rate, frame_size, OVERLAP_FACTOR_SPEECH,
+      &self->arena, tables, sample_rate, frame_size, OVERLAP_FACTOR_SPEECH,
       PADDING_CONFIGURATION_SPEECH, ZEROPADDING_AMOUNT_SPEECH,
-      INPUT_WINDOW_TYPE_SPEECH, OUTPUT_WINDOW_TYPE_SPEECH);
+      INPUT_WINDOW_TYPE_SPEECH, OUTPUT_WINDOW_TYPE_SPEECH, false);
 
   if (!self->stft_processor) {
     specbleach_adaptive_free(self);
@@ -55,6 +59,7 @@ SpectralBleachHandle specbleach_adaptive_initialize(const uint32_t sample_rate,
   const uint32_t fft_size = get_stft_fft_size(self->stft_processor);
 
   self->adaptive_spectral_denoiser = spectral_adaptive_denoiser_initialize(
+      &self->arena, tables, get_spectral_kernels(KERNEL_ISA_AUTO),
       self->sample_rate, fft_size, OVERLAP_FACTOR_SPEECH);
 
   if (!self->adaptive_spectral_denoiser) {
@@ -68,8 +73,7 @@ SpectralBleachHandle specbleach_adaptive_initialize(const uint32_t sample_rate,
 void specbleach_adaptive_free(SpectralBleachHandle instance) {
   SbAdaptiveDenoiser *self = (SbAdaptiveDenoiser *)instance;
 
-  spectral_adaptive_denoiser_free(self->adaptive_spectral_denoiser);
-  stft_processor_free(self->stft_processor);
+  arena_release(&self->arena);
 
   free(self);
 }
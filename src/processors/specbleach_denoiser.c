@@ -22,68 +22,714 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "../shared/configurations.h"
 #include "../shared/noise_estimation/noise_profile.h"
 #include "../shared/stft/stft_processor.h"
+#include "../shared/utils/arena.h"
+#include "../shared/utils/denormals.h"
+#include "../shared/utils/dsp_tables.h"
 #include "../shared/utils/general_utils.h"
+#include "../shared/utils/scratch_pool.h"
+#include "../shared/utils/spectral_kernels.h"
 #include "denoiser/spectral_denoiser.h"
 #include <math.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
+typedef struct QueuedParameter {
+  SpectralBleachParameterId parameter_id;
+  float value;
+  uint32_t sample_offset;
+} QueuedParameter;
+
+typedef struct ProcessingModules {
+  const SpectralKernels *kernels;
+  NoiseProfile *noise_profile;
+  ScratchPool *scratch;
+  SpectralProcessorHandle spectral_denoiser;
+  StftProcessor *stft_processor;
+} ProcessingModules;
+
+// All the processing modules live in a single arena. Its memory is allocated
+// by the instance, or is the caller's when arena_memory is NULL, in which case
+// the instance itself is at the start of it too. Instances with memory of
+// their own build the optional modules out of a second arena when parameters
+// first need them, while the ones in the caller's memory have all of them
+// from the start. The read-only tables the modules use are shared with the
+// instance's clones, or are in the arena for the ones in the caller's memory.
+// Optional modules can be built from any thread that loads parameters, so
+// the tables they add go to ones of their own that only read the shared ones.
 typedef struct SbSpectralDenoiser {
-  uint32_t sample_rate;
+  SpectralBleachConfig config;
+  Arena arena;
+  void *arena_memory;
+  size_t arena_memory_size;
+  Arena optional_arena;
+  DspTables *tables;
+  DspTables *optional_tables;
+  const SpectralKernels *kernels;
+  bool prewarmed;
+  bool parameters_loaded;
+  SpectralBleachParameters parameters;
   DenoiserParameters denoise_parameters;
 
+  QueuedParameter queued_parameters[MAX_QUEUED_PARAMETER_CHANGES];
+  uint32_t queued_parameters_count;
+
   NoiseProfile *noise_profile;
   SpectralProcessorHandle spectral_denoiser;
   StftProcessor *stft_processor;
 } SbSpectralDenoiser;
 
-SpectralBleachHandle specbleach_initialize(const uint32_t sample_rate,
-                                           float frame_size) {
+SpectralBleachConfig specbleach_get_default_config(const uint32_t sample_rate,
+                                                   const float frame_size) {
+  return (SpectralBleachConfig){
+      .version = SPECBLEACH_CONFIG_VERSION,
+      .sample_rate = sample_rate,
+      .frame_size = frame_size,
+      .overlap_factor = OVERLAP_FACTOR_GENERAL,
+      .input_window_type = INPUT_WINDOW_TYPE_GENERAL,
+      .output_window_type = OUTPUT_WINDOW_TYPE_GENERAL,
+      .padding_type = PADDING_CONFIGURATION_GENERAL,
+      .zeropadding_amount = ZEROPADDING_AMOUNT_GENERAL,
+      .critical_bands_type = CRITICAL_BANDS_TYPE,
+      .gain_estimation_type = GAIN_ESTIMATION_TYPE,
+      .time_smoothing_type = TIME_SMOOTHING_TYPE,
+      .median_spectrum_count = NUMBER_OF_MEDIAN_SPECTRUM,
+      .postfilter_scale = POSTFILTER_SCALE,
+      .a_posteriori_snr_only = false,
+      .kernel_isa = SPECBLEACH_KERNEL_ISA_AUTO,
+      .spread_frames = false,
+  };
+}
+
+// Hann windows only add up to a constant from an overlap of 3, so lower
+// overlaps use the power complementary Vorbis window instead
+static int get_default_input_window(const uint32_t overlap_factor) {
+  return overlap_factor <= 2U ? VORBIS_WINDOW : INPUT_WINDOW_TYPE_GENERAL;
+}
+
+static int get_default_output_window(const uint32_t overlap_factor) {
+  return overlap_factor <= 2U ? VORBIS_WINDOW : OUTPUT_WINDOW_TYPE_GENERAL;
+}
+
+// Windows chosen by the caller are kept, only the defaults follow the overlap
+static void set_overlap_factor(SpectralBleachConfig *config,
+                               const uint32_t overlap_factor) {
+  const uint32_t previous = config->overlap_factor;
+  config->overlap_factor = overlap_factor;
+
+  if (config->input_window_type == get_default_input_window(previous) &&
+      config->output_window_type == get_default_output_window(previous)) {
+    config->input_window_type = get_default_input_window(overlap_factor);
+    config->output_window_type = get_default_output_window(overlap_factor);
+  }
+}
+
+SpectralBleachConfig specbleach_get_preset_config(
+    const SpectralBleachPreset preset, const uint32_t sample_rate,
+    const float frame_size) {
+  SpectralBleachConfig config =
+      specbleach_get_default_config(sample_rate, frame_size);
+
+  switch (preset) {
+  case SPECBLEACH_PRESET_ECO:
+    set_overlap_factor(&config, OVERLAP_FACTOR_ECO);
+    config.padding_type = PADDING_CONFIGURATION_ECO;
+    config.a_posteriori_snr_only = true;
+    break;
+  case SPECBLEACH_PRESET_STANDARD:
+    break;
+  case SPECBLEACH_PRESET_HQ:
+    set_overlap_factor(&config, OVERLAP_FACTOR_HQ);
+    config.padding_type = PADDING_CONFIGURATION_HQ;
+    config.zeropadding_amount = ZEROPADDING_AMOUNT_HQ;
+    break;
+  default:
+    config.version = 0U; // Rejected when initializing
+    break;
+  }
+
+  return config;
+}
+
+// Configs older than version 2 end before the instruction set
+static int get_config_kernel_isa(const SpectralBleachConfig *config) {
+  return config->version >= 2U ? config->kernel_isa
+                               : SPECBLEACH_KERNEL_ISA_AUTO;
+}
+
+// Configs older than version 3 end before spreading the frames
+static bool get_config_spread_frames(const SpectralBleachConfig *config) {
+  return config->version >= 3U && config->spread_frames;
+}
+
+// Size of the config of each version. Callers built against older headers
+// have structs that end there
+static size_t get_config_size(const uint32_t version) {
+  if (version >= 3U) {
+    return sizeof(SpectralBleachConfig);
+  }
+  if (version == 2U) {
+    return offsetof(SpectralBleachConfig, spread_frames);
+  }
+  return offsetof(SpectralBleachConfig, kernel_isa);
+}
+
+// Copies the fields of a valid config of any version into one of the current
+// version, with the fields it doesn't have at their defaults
+static SpectralBleachConfig upgrade_config(const SpectralBleachConfig *config) {
+  SpectralBleachConfig upgraded = {0};
+  memcpy(&upgraded, config, get_config_size(config->version));
+  upgraded.version = SPECBLEACH_CONFIG_VERSION;
+  upgraded.kernel_isa = get_config_kernel_isa(config);
+  upgraded.spread_frames = get_config_spread_frames(config);
+
+  return upgraded;
+}
+
+static bool is_config_valid(const SpectralBleachConfig *config) {
+  return config->version >= 1U &&
+         config->version <= SPECBLEACH_CONFIG_VERSION &&
+         config->sample_rate > 0U && config->frame_size > 0.F &&
+         config->overlap_factor >= 2U && config->input_window_type >= 0 &&
+         config->input_window_type <= VORBIS_WINDOW &&
+         config->output_window_type >= 0 &&
+         config->output_window_type <= VORBIS_WINDOW &&
+         config->padding_type >= 0 && config->padding_type <= NO_PADDING &&
+         config->critical_bands_type >= 0 &&
+         config->critical_bands_type <= OCTAVE_SCALE &&
+         config->gain_estimation_type >= 0 &&
+         config->gain_estimation_type <= GENERALIZED_SPECTRALSUBTRACION &&
+         config->time_smoothing_type >= FIXED &&
+         config->time_smoothing_type <= TRANSIENT_AWARE &&
+         config->median_spectrum_count > 0U &&
+         config->postfilter_scale >= 0.F &&
+         get_config_kernel_isa(config) >= SPECBLEACH_KERNEL_ISA_AUTO &&
+         get_config_kernel_isa(config) <= SPECBLEACH_KERNEL_ISA_AVX512;
+}
+
+static bool configs_equal(const SpectralBleachConfig *a,
+                          const SpectralBleachConfig *b) {
+  return a->sample_rate == b->sample_rate && a->frame_size == b->frame_size &&
+         a->overlap_factor == b->overlap_factor &&
+         a->input_window_type == b->input_window_type &&
+         a->output_window_type == b->output_window_type &&
+         a->padding_type == b->padding_type &&
+         a->zeropadding_amount == b->zeropadding_amount &&
+         a->critical_bands_type == b->critical_bands_type &&
+         a->gain_estimation_type == b->gain_estimation_type &&
+         a->time_smoothing_type == b->time_smoothing_type &&
+         a->median_spectrum_count == b->median_spectrum_count &&
+         a->postfilter_scale == b->postfilter_scale &&
+         a->a_posteriori_snr_only == b->a_posteriori_snr_only &&
+         get_config_kernel_isa(a) == get_config_kernel_isa(b) &&
+         get_config_spread_frames(a) == get_config_spread_frames(b);
+}
+
+// Configurations that can't afford the scalings that need critical bands or
+// masking thresholds always use the a-posteriori snr one
+static int get_noise_scaling_type(const SpectralBleachConfig *config,
+                                  const int noise_scaling_type) {
+  return config->a_posteriori_snr_only ? A_POSTERIORI_SNR : noise_scaling_type;
+}
+
+// Creates the processing modules of the configuration out of the arena,
+// including the optional ones asked for. The tables they read are looked up
+// in the given ones first
+static bool create_modules(Arena *arena, DspTables *tables,
+                           const SpectralBleachConfig *config,
+                           const bool masking_thresholds,
+                           const bool transient_protection,
+                           ProcessingModules *modules) {
+  if (!tables) {
+    return false;
+  }
+
+  modules->stft_processor = stft_processor_initialize(
+      arena, tables, config->sample_rate, config->frame_size,
+      config->overlap_factor, (ZeroPaddingType)config->padding_type,
+      config->zeropadding_amount, (WindowTypes)config->input_window_type,
+      (WindowTypes)config->output_window_type,
+      get_config_spread_frames(config));
+
+  if (!modules->stft_processor) {
+    return false;
+  }
+
+  const uint32_t fft_size = get_stft_fft_size(modules->stft_processor);
+  const uint32_t real_spectrum_size =
+      get_stft_real_spectrum_size(modules->stft_processor);
+
+  modules->kernels =
+      get_spectral_kernels((KernelIsa)get_config_kernel_isa(config));
+  modules->noise_profile = noise_profile_initialize(arena, real_spectrum_size);
+  modules->scratch = scratch_pool_initialize(arena, fft_size);
+
+  const DenoiserConfiguration denoiser_configuration = {
+      .band_type = (CriticalBandType)config->critical_bands_type,
+      .gain_estimation_type = (GainEstimationType)config->gain_estimation_type,
+      .time_smoothing_type = (TimeSmoothingType)config->time_smoothing_type,
+      .median_spectrum_count = config->median_spectrum_count,
+      .postfilter_scale = config->postfilter_scale,
+      .kernels = modules->kernels,
+  };
+  modules->spectral_denoiser = spectral_denoiser_initialize(
+      arena, tables, modules->scratch, config->sample_rate, fft_size,
+      config->overlap_factor, modules->noise_profile, denoiser_configuration);
+
+  if (!modules->noise_profile || !modules->scratch ||
+      !modules->spectral_denoiser) {
+    return false;
+  }
+
+  return spectral_denoiser_prepare(modules->spectral_denoiser, arena, tables,
+                                   masking_thresholds, transient_protection);
+}
+
+// The optional modules are the ones the loaded parameters use, or every one
+// the configuration can use once the instance was prewarmed
+static bool uses_masking_thresholds(const SbSpectralDenoiser *self,
+                                    const SpectralBleachConfig *config) {
+  return !config->a_posteriori_snr_only &&
+         (self->parameters.noise_scaling_type == MASKING_THRESHOLDS ||
+          self->prewarmed);
+}
+
+static bool uses_transient_protection(const SbSpectralDenoiser *self) {
+  return self->parameters.transient_protection || self->prewarmed;
+}
+
+// Builds the optional modules the instance uses now out of the optional
+// arena and tables. Those already built are kept as they are
+static bool prepare_optional_modules(SbSpectralDenoiser *self) {
+  const bool masking_thresholds = uses_masking_thresholds(self, &self->config);
+  if (masking_thresholds && !self->optional_tables) {
+    self->optional_tables =
+        dsp_tables_initialize_over(&self->optional_arena, self->tables);
+    if (!self->optional_tables) {
+      return false;
+    }
+  }
+
+  return spectral_denoiser_prepare(
+      self->spectral_denoiser, &self->optional_arena, self->optional_tables,
+      masking_thresholds, uses_transient_protection(self));
+}
+
+// Bytes the arena hands out for the configuration, measured with a dry run
+// that builds the modules from the heap. Allocation only depends on the
+// configuration, so that is exact. Without shared tables it includes the
+// instance itself, its tables and every optional module, as instances in the
+// caller's memory have. With shared tables the ones the dry run builds are
+// kept, so the real build finds them instead of computing them again. Zero if
+// it can't be built.
+static size_t measure_arena(const SpectralBleachConfig *config,
+                            DspTables *shared_tables,
+                            const bool masking_thresholds,
+                            const bool transient_protection) {
+  if (!is_config_valid(config)) {
+    return 0U;
+  }
+
+  Arena arena;
+  arena_initialize(&arena);
+
+  DspTables *tables = shared_tables;
+  bool created = true;
+  if (!shared_tables) {
+    created = arena_calloc(&arena, 1U, sizeof(SbSpectralDenoiser)) != NULL;
+    tables = dsp_tables_initialize(&arena);
+  }
+
+  ProcessingModules modules;
+  created = created && create_modules(&arena, tables, config,
+                                      masking_thresholds,
+                                      transient_protection, &modules);
+
+  const size_t used_size = arena_get_used_size(&arena);
+  arena_release(&arena);
+
+  return created ? used_size : 0U;
+}
+
+// Creates the processing modules for the given configuration in a new arena,
+// reading the given tables, and only replaces the current ones if all of them
+// could be created. The block of the current ones is reused when the new ones
+// fit in it. A noise profile that is already available is carried over,
+// resampled if needed, and so are the parameters and the optional modules the
+// instance is using. The instance takes over the tables on success, and the
+// caller keeps them otherwise.
+static bool build_processing(SbSpectralDenoiser *self,
+                             const SpectralBleachConfig *config,
+                             DspTables *tables) {
+  if (!tables || !is_config_valid(config)) {
+    return false;
+  }
+
+  // The modules, including the optional ones in use, go in a single block of
+  // the size a dry run measures
+  const bool masking_thresholds = uses_masking_thresholds(self, config);
+  const bool transient_protection = uses_transient_protection(self);
+  const size_t used_size = measure_arena(config, tables, masking_thresholds,
+                                         transient_protection);
+  if (used_size == 0U) {
+    return false;
+  }
+
+  // The noise profile is copied out first, as the block it is in can be
+  // reused
+  float *noise_profile = NULL;
+  uint32_t noise_profile_size = 0U;
+  uint32_t blocks_averaged = 0U;
+  if (self->noise_profile &&
+      is_noise_estimation_available(self->noise_profile)) {
+    noise_profile_size = get_noise_profile_size(self->noise_profile);
+    blocks_averaged = get_noise_profile_blocks_averaged(self->noise_profile);
+    noise_profile = (float *)malloc(noise_profile_size * sizeof(float));
+    if (!noise_profile) {
+      return false;
+    }
+    memcpy(noise_profile, get_noise_profile(self->noise_profile),
+           noise_profile_size * sizeof(float));
+  }
+
+  const size_t needed_size = arena_get_memory_size(used_size);
+  const bool reuse_memory =
+      self->arena_memory && needed_size <= self->arena_memory_size;
+  const size_t memory_size =
+      reuse_memory ? self->arena_memory_size : needed_size;
+  void *memory = reuse_memory ? self->arena_memory : malloc(memory_size);
+  if (!memory) {
+    free(noise_profile);
+    return false;
+  }
+
+  // After the dry run the build only makes the allocations that measured,
+  // out of memory that is already there, and finds every table it reads. So
+  // the current modules can go before it when their block is reused
+  if (reuse_memory) {
+    arena_release(&self->optional_arena);
+    arena_release(&self->arena);
+  }
+
+  Arena arena;
+  ProcessingModules modules;
+  if (!arena_initialize_with_memory(&arena, memory, memory_size) ||
+      !create_modules(&arena, tables, config, masking_thresholds,
+                      transient_protection, &modules)) {
+    arena_release(&arena);
+    if (!reuse_memory) {
+      free(memory);
+    }
+    free(noise_profile);
+    return false;
+  }
+
+  if (noise_profile) {
+    set_noise_profile(modules.noise_profile, noise_profile,
+                      noise_profile_size, blocks_averaged);
+    free(noise_profile);
+  }
+
+  if (self->parameters_loaded) {
+    self->denoise_parameters.noise_scaling_type =
+        get_noise_scaling_type(config, self->parameters.noise_scaling_type);
+    load_reduction_parameters(modules.spectral_denoiser,
+                              self->denoise_parameters);
+  }
+
+  if (self->arena_memory && !reuse_memory) {
+    arena_release(&self->optional_arena);
+    arena_release(&self->arena);
+    free(self->arena_memory);
+  }
+  if (self->tables != tables) {
+    dsp_tables_release(self->tables);
+  }
+
+  self->config = upgrade_config(config);
+  self->arena = arena;
+  self->arena_memory = memory;
+  self->arena_memory_size = memory_size;
+  arena_initialize(&self->optional_arena);
+  self->tables = tables;
+  // Masking thresholds are the only optional module that reads tables. Built
+  // with the rest, nothing gets added through these
+  self->optional_tables = masking_thresholds ? tables : NULL;
+  self->kernels = modules.kernels;
+  self->stft_processor = modules.stft_processor;
+  self->noise_profile = modules.noise_profile;
+  self->spectral_denoiser = modules.spectral_denoiser;
+
+  return true;
+}
+
+size_t specbleach_get_memory_requirements_with_config(
+    const SpectralBleachConfig *config) {
+  if (!config) {
+    return 0U;
+  }
+
+  const size_t used_size = measure_arena(config, NULL, !config->a_posteriori_snr_only, true);
+
+  return used_size == 0U ? 0U : arena_get_memory_size(used_size);
+}
+
+size_t specbleach_get_memory_requirements(const uint32_t sample_rate,
+                                          const float frame_size) {
+  const SpectralBleachConfig config =
+      specbleach_get_default_config(sample_rate, frame_size);
+
+  return specbleach_get_memory_requirements_with_config(&config);
+}
+
+SpectralBleachHandle
+specbleach_initialize_in_memory(const SpectralBleachConfig *config,
+                                void *memory, const size_t memory_size) {
+  if (!config || !memory || !is_config_valid(config)) {
+    return NULL;
+  }
+
+  Arena arena;
+  if (!arena_initialize_with_memory(&arena, memory, memory_size)) {
+    return NULL;
+  }
+
+  // Built straight into the memory. The requirements only depend on what
+  // the arena handed out, so they are checked afterwards instead of being
+  // measured with a build of their own
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)arena_calloc(
+      &arena, 1U, sizeof(SbSpectralDenoiser));
+  DspTables *tables = dsp_tables_initialize(&arena);
+  ProcessingModules modules;
+  if (!self ||
+      !create_modules(&arena, tables, config, !config->a_posteriori_snr_only,
+                      true, &modules) ||
+      memory_size < arena_get_memory_size(arena_get_used_size(&arena))) {
+    arena_release(&arena);
+    return NULL;
+  }
+
+  self->config = upgrade_config(config);
+  self->arena = arena;
+  self->arena_memory = NULL;
+  self->tables = tables;
+  self->optional_tables = tables;
+  self->kernels = modules.kernels;
+  self->stft_processor = modules.stft_processor;
+  self->noise_profile = modules.noise_profile;
+  self->spectral_denoiser = modules.spectral_denoiser;
+
+  return self;
+}
+
+SpectralBleachHandle
+specbleach_initialize_with_config(const SpectralBleachConfig *config) {
+  if (!config) {
+    return NULL;
+  }
+
   SbSpectralDenoiser *self =
       (SbSpectralDenoiser *)calloc(1U, sizeof(SbSpectralDenoiser));
+  if (!self) {
+    return NULL;
+  }
 
-  self->sample_rate = sample_rate;
+  DspTables *tables = dsp_tables_create();
+  if (!build_processing(self, config, tables)) {
+    dsp_tables_release(tables);
+    free(self);
+    return NULL;
+  }
 
-  self->stft_processor = stft_processor_initialize(
-      sample_rate, frame_size, OVERLAP_FACTOR_GENERAL,
-      PADDING_CONFIGURATION_GENERAL, ZEROPADDING_AMOUNT_GENERAL,
-      INPUT_WINDOW_TYPE_GENERAL, OUTPUT_WINDOW_TYPE_GENERAL);
+  return self;
+}
 
-  if (!self->stft_processor) {
-    specbleach_free(self);
+SpectralBleachHandle specbleach_clone(SpectralBleachHandle instance) {
+  if (!instance) {
     return NULL;
   }
 
-  const uint32_t fft_size = get_stft_fft_size(self->stft_processor);
-  const uint32_t real_spectrum_size =
-      get_stft_real_spectrum_size(self->stft_processor);
-
-  self->noise_profile = noise_profile_initialize(real_spectrum_size);
+  const SbSpectralDenoiser *source = (const SbSpectralDenoiser *)instance;
 
-  if (!self->noise_profile) {
-    specbleach_free(self);
+  SbSpectralDenoiser *self =
+      (SbSpectralDenoiser *)calloc(1U, sizeof(SbSpectralDenoiser));
+  if (!self) {
     return NULL;
   }
 
-  self->spectral_denoiser = spectral_denoiser_initialize(
-      self->sample_rate, fft_size, OVERLAP_FACTOR_GENERAL, self->noise_profile);
+  self->prewarmed = source->prewarmed;
+  self->parameters_loaded = source->parameters_loaded;
+  self->parameters = source->parameters;
+  self->denoise_parameters = source->denoise_parameters;
 
-  if (!self->spectral_denoiser) {
-    specbleach_free(self);
+  // Tables in the caller's memory go away with the source, so those clones
+  // get tables of their own
+  DspTables *tables = source->arena_memory ? dsp_tables_retain(source->tables)
+                                           : dsp_tables_create();
+  if (!build_processing(self, &source->config, tables)) {
+    dsp_tables_release(tables);
+    free(self);
     return NULL;
   }
 
   return self;
 }
 
+SpectralBleachHandle specbleach_initialize(const uint32_t sample_rate,
+                                           float frame_size) {
+  const SpectralBleachConfig config =
+      specbleach_get_default_config(sample_rate, frame_size);
+
+  return specbleach_initialize_with_config(&config);
+}
+
+SpectralBleachHandle
+specbleach_initialize_with_overlap(const uint32_t sample_rate,
+                                   const float frame_size,
+                                   const uint32_t overlap_factor) {
+  SpectralBleachConfig config =
+      specbleach_get_default_config(sample_rate, frame_size);
+  set_overlap_factor(&config, overlap_factor);
+
+  return specbleach_initialize_with_config(&config);
+}
+
+SpectralBleachHandle
+specbleach_initialize_with_preset(const uint32_t sample_rate,
+                                  const float frame_size,
+                                  const SpectralBleachPreset preset) {
+  const SpectralBleachConfig config =
+      specbleach_get_preset_config(preset, sample_rate, frame_size);
+
+  return specbleach_initialize_with_config(&config);
+}
+
 void specbleach_free(SpectralBleachHandle instance) {
   SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
 
-  noise_profile_free(self->noise_profile);
-  spectral_denoiser_free(self->spectral_denoiser);
-  stft_processor_free(self->stft_processor);
+  // An instance without memory of its own lives in the caller's memory
+  void *arena_memory = self->arena_memory;
+  DspTables *tables = self->tables;
+  arena_release(&self->optional_arena);
+  arena_release(&self->arena);
+
+  if (arena_memory) {
+    dsp_tables_release(tables);
+    free(arena_memory);
+    free(self);
+  }
+}
+
+static void apply_queued_parameters(SbSpectralDenoiser *self,
+                                    uint32_t sample_offset);
+
+void specbleach_reset(SpectralBleachHandle instance) {
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
+
+  // There is no position to wait for anymore, so pending changes are due now
+  apply_queued_parameters(self, UINT32_MAX);
+
+  stft_processor_reset(self->stft_processor);
+  spectral_denoiser_reset(self->spectral_denoiser);
+}
+
+bool specbleach_reconfigure_with_config(SpectralBleachHandle instance,
+                                        const SpectralBleachConfig *config) {
+  if (!instance || !config) {
+    return false;
+  }
+
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
+
+  if (is_config_valid(config) && configs_equal(config, &self->config)) {
+    specbleach_reset(instance);
+    return true;
+  }
+
+  // There is no room to build a different configuration in the caller's
+  // memory next to the current one
+  if (!self->arena_memory) {
+    return false;
+  }
+
+  apply_queued_parameters(self, UINT32_MAX);
+
+  // Tables shared with clones are kept, as those are likely to be
+  // reconfigured the same way. Otherwise the ones of the old configuration
+  // are dropped
+  DspTables *tables =
+      dsp_tables_is_shared(self->tables) ? self->tables : dsp_tables_create();
+  if (!build_processing(self, config, tables)) {
+    if (tables != self->tables) {
+      dsp_tables_release(tables);
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool specbleach_reconfigure(SpectralBleachHandle instance,
+                            const uint32_t sample_rate,
+                            const float frame_size) {
+  if (!instance) {
+    return false;
+  }
+
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
+
+  SpectralBleachConfig config = self->config;
+  config.sample_rate = sample_rate;
+  config.frame_size = frame_size;
+
+  return specbleach_reconfigure_with_config(instance, &config);
+}
+
+bool specbleach_reconfigure_with_overlap(SpectralBleachHandle instance,
+                                         const uint32_t sample_rate,
+                                         const float frame_size,
+                                         const uint32_t overlap_factor) {
+  if (!instance) {
+    return false;
+  }
+
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
+
+  SpectralBleachConfig config = self->config;
+  config.sample_rate = sample_rate;
+  config.frame_size = frame_size;
+  set_overlap_factor(&config, overlap_factor);
 
-  free(self);
+  return specbleach_reconfigure_with_config(instance, &config);
+}
+
+bool specbleach_reconfigure_with_preset(SpectralBleachHandle instance,
+                                        const uint32_t sample_rate,
+                                        const float frame_size,
+                                        const SpectralBleachPreset preset) {
+  const SpectralBleachConfig config =
+      specbleach_get_preset_config(preset, sample_rate, frame_size);
+
+  return specbleach_reconfigure_with_config(instance, &config);
+}
+
+bool specbleach_get_config(SpectralBleachHandle instance,
+                           SpectralBleachConfig *config) {
+  if (!instance || !config) {
+    return false;
+  }
+
+  // Only the fields of the version the caller has are written
+  const uint32_t version = config->version;
+  if (version < 1U || version > SPECBLEACH_CONFIG_VERSION) {
+    return false;
+  }
+
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
+  memcpy(config, &self->config, get_config_size(version));
+  config->version = version;
+
+  return true;
 }
 
 uint32_t specbleach_get_latency(SpectralBleachHandle instance) {
@@ -92,6 +738,75 @@ uint32_t specbleach_get_latency(SpectralBleachHandle instance) {
   return get_stft_latency(self->stft_processor);
 }
 
+SpectralBleachKernelIsa
+specbleach_get_kernel_isa(SpectralBleachHandle instance) {
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
+
+  return (SpectralBleachKernelIsa)self->kernels->isa;
+}
+
+static bool apply_parameter(SbSpectralDenoiser *self,
+                            SpectralBleachParameterId parameter_id,
+                            float value);
+
+// Applies, in the order they were queued, every change that was due at or
+// before the given sample of the current call
+static void apply_queued_parameters(SbSpectralDenoiser *self,
+                                    const uint32_t sample_offset) {
+  bool changed = false;
+  uint32_t remaining = 0U;
+  for (uint32_t i = 0U; i < self->queued_parameters_count; i++) {
+    const QueuedParameter queued = self->queued_parameters[i];
+    if (queued.sample_offset <= sample_offset) {
+      changed |= apply_parameter(self, queued.parameter_id, queued.value);
+    } else {
+      self->queued_parameters[remaining++] = queued;
+    }
+  }
+  self->queued_parameters_count = remaining;
+
+  if (changed) {
+    load_reduction_parameters(self->spectral_denoiser,
+                              self->denoise_parameters);
+  }
+}
+
+static void process_samples(SbSpectralDenoiser *self,
+                            const uint32_t number_of_samples,
+                            const float *input, float *output) {
+  if (self->queued_parameters_count == 0U) {
+    stft_processor_run(self->stft_processor, number_of_samples, input, output,
+                       &spectral_denoiser_run, self->spectral_denoiser);
+  } else {
+    // Parameters are only read when a frame is processed, so the call is only
+    // split at the samples where that happens
+    uint32_t processed = 0U;
+    while (processed < number_of_samples) {
+      const uint32_t remaining = number_of_samples - processed;
+      uint32_t chunk =
+          get_stft_samples_until_next_frame(self->stft_processor);
+      if (chunk <= remaining) {
+        apply_queued_parameters(self, processed + chunk - 1U);
+      } else {
+        chunk = remaining;
+      }
+
+      stft_processor_run(self->stft_processor, chunk, &input[processed],
+                         &output[processed], &spectral_denoiser_run,
+                         self->spectral_denoiser);
+      processed += chunk;
+    }
+
+    // Whatever is left is due in a later call
+    for (uint32_t i = 0U; i < self->queued_parameters_count; i++) {
+      QueuedParameter *queued = &self->queued_parameters[i];
+      queued->sample_offset = queued->sample_offset > number_of_samples
+                                  ? queued->sample_offset - number_of_samples
+                                  : 0U;
+    }
+  }
+}
+
 bool specbleach_process(SpectralBleachHandle instance,
                         const uint32_t number_of_samples, const float *input,
                         float *output) {
@@ -101,8 +816,14 @@ bool specbleach_process(SpectralBleachHandle instance,
 
   SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
 
-  stft_processor_run(self->stft_processor, number_of_samples, input, output,
-                     &spectral_denoiser_run, self->spectral_denoiser);
+  // Decaying spectra (whitening maximums, smoothing, overlap-add tails) go
+  // denormal on quiet input, so flush them for the duration of the call and
+  // give the caller back its own floating point state afterwards
+  const DenormalsState denormals_state = disable_denormals();
+
+  process_samples(self, number_of_samples, input, output);
+
+  restore_denormals(denormals_state);
 
   return true;
 }
@@ -140,6 +861,14 @@ bool specbleach_load_noise_profile(SpectralBleachHandle instance,
                            averaged_blocks);
 }
 
+bool specbleach_resample_noise_profile(const float *input_profile,
+                                       const uint32_t input_size,
+                                       float *output_profile,
+                                       const uint32_t output_size) {
+  return resample_noise_profile(input_profile, input_size, output_profile,
+                                output_size);
+}
+
 bool specbleach_reset_noise_profile(SpectralBleachHandle instance) {
   if (!instance) {
     return false;
@@ -156,6 +885,92 @@ bool specbleach_noise_profile_available(SpectralBleachHandle instance) {
   return is_noise_estimation_available(self->noise_profile);
 }
 
+static float get_parameter_value(const SpectralBleachParameters *parameters,
+                                 const SpectralBleachParameterId parameter_id) {
+  switch (parameter_id) {
+  case SPECBLEACH_PARAMETER_LEARN_NOISE:
+    return (float)parameters->learn_noise;
+  case SPECBLEACH_PARAMETER_RESIDUAL_LISTEN:
+    return parameters->residual_listen ? 1.F : 0.F;
+  case SPECBLEACH_PARAMETER_REDUCTION_AMOUNT:
+    return parameters->reduction_amount;
+  case SPECBLEACH_PARAMETER_SMOOTHING_FACTOR:
+    return parameters->smoothing_factor;
+  case SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION:
+    return parameters->transient_protection ? 1.F : 0.F;
+  case SPECBLEACH_PARAMETER_WHITENING_FACTOR:
+    return parameters->whitening_factor;
+  case SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE:
+    return (float)parameters->noise_scaling_type;
+  case SPECBLEACH_PARAMETER_NOISE_RESCALE:
+    return parameters->noise_rescale;
+  case SPECBLEACH_PARAMETER_POST_FILTER_THRESHOLD:
+    return parameters->post_filter_threshold;
+  default:
+    return 0.F;
+  }
+}
+
+// Stores the user facing value and converts it to the internal representation
+// used by the denoiser. Only the field being changed is recomputed. Returns
+// false if nothing changed.
+static bool apply_parameter(SbSpectralDenoiser *self,
+                            const SpectralBleachParameterId parameter_id,
+                            const float value) {
+  if (self->parameters_loaded &&
+      value == get_parameter_value(&self->parameters, parameter_id)) {
+    return false;
+  }
+
+  switch (parameter_id) {
+  case SPECBLEACH_PARAMETER_LEARN_NOISE:
+    self->parameters.learn_noise = (int)value;
+    self->denoise_parameters.learn_noise = self->parameters.learn_noise;
+    break;
+  case SPECBLEACH_PARAMETER_RESIDUAL_LISTEN:
+    self->parameters.residual_listen = value != 0.F;
+    self->denoise_parameters.residual_listen = self->parameters.residual_listen;
+    break;
+  case SPECBLEACH_PARAMETER_REDUCTION_AMOUNT:
+    self->parameters.reduction_amount = value;
+    self->denoise_parameters.reduction_amount =
+        from_db_to_coefficient(value * -1.F);
+    break;
+  case SPECBLEACH_PARAMETER_SMOOTHING_FACTOR:
+    self->parameters.smoothing_factor = value;
+    self->denoise_parameters.smoothing_factor =
+        remap_percentage_log_like_unity(value / 100.F);
+    break;
+  case SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION:
+    self->parameters.transient_protection = value != 0.F;
+    self->denoise_parameters.transient_protection =
+        self->parameters.transient_protection;
+    break;
+  case SPECBLEACH_PARAMETER_WHITENING_FACTOR:
+    self->parameters.whitening_factor = value;
+    self->denoise_parameters.whitening_factor = value / 100.F;
+    break;
+  case SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE:
+    self->parameters.noise_scaling_type = (int)value;
+    self->denoise_parameters.noise_scaling_type = get_noise_scaling_type(
+        &self->config, self->parameters.noise_scaling_type);
+    break;
+  case SPECBLEACH_PARAMETER_NOISE_RESCALE:
+    self->parameters.noise_rescale = value;
+    self->denoise_parameters.noise_rescale = from_db_to_coefficient(value);
+    break;
+  case SPECBLEACH_PARAMETER_POST_FILTER_THRESHOLD:
+    self->parameters.post_filter_threshold = value;
+    self->denoise_parameters.post_filter_threshold =
+        from_db_to_coefficient(value);
+    break;
+  default:
+    return false;
+  }
+
+  return true;
+}
+
 bool specbleach_load_parameters(SpectralBleachHandle instance,
                                 SpectralBleachParameters parameters) {
   if (!instance) {
@@ -164,22 +979,114 @@ bool specbleach_load_parameters(SpectralBleachHandle instance,
 
   SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
 
-  // clang-format off
-  self->denoise_parameters = (DenoiserParameters){
-      .learn_noise = parameters.learn_noise,
-      .residual_listen = parameters.residual_listen,
-      .transient_protection = parameters.transient_protection,
-      .noise_scaling_type = parameters.noise_scaling_type,
-      .reduction_amount =
-          from_db_to_coefficient(parameters.reduction_amount * -1.F),
-      .noise_rescale = from_db_to_coefficient(parameters.noise_rescale),
-      .smoothing_factor = remap_percentage_log_like_unity(parameters.smoothing_factor / 100.F),
-      .whitening_factor = parameters.whitening_factor / 100.F,
-      .post_filter_threshold = from_db_to_coefficient(parameters.post_filter_threshold),
-  };
-  // clang-format on
+  // The loaded parameters supersede changes that were queued before them
+  self->queued_parameters_count = 0U;
+
+  bool changed = false;
+  for (int id = 0; id < SPECBLEACH_PARAMETER_COUNT; id++) {
+    changed |= apply_parameter(self, id, get_parameter_value(&parameters, id));
+  }
+  self->parameters_loaded = true;
+
+  if (changed) {
+    load_reduction_parameters(self->spectral_denoiser,
+                              self->denoise_parameters);
+  }
+
+  return prepare_optional_modules(self);
+}
+
+bool specbleach_set_parameter(SpectralBleachHandle instance,
+                              const SpectralBleachParameterId parameter_id,
+                              const float value) {
+  if (!instance) {
+    return false;
+  }
 
-  load_reduction_parameters(self->spectral_denoiser, self->denoise_parameters);
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
+
+  if (parameter_id < 0 || parameter_id >= SPECBLEACH_PARAMETER_COUNT) {
+    return false;
+  }
+
+  if (!apply_parameter(self, parameter_id, value)) {
+    return true;
+  }
+
+  return load_reduction_parameters(self->spectral_denoiser,
+                                   self->denoise_parameters) &&
+         prepare_optional_modules(self);
+}
+
+bool specbleach_prewarm(SpectralBleachHandle instance) {
+  if (!instance) {
+    return false;
+  }
+
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
+  if (self->prewarmed) {
+    return true;
+  }
+
+  // Instances in the caller's memory already have every module
+  self->prewarmed = true;
+  if (!self->arena_memory) {
+    return true;
+  }
+
+  // Rebuilt so the optional modules are in the same block as the rest
+  if (!build_processing(self, &self->config, self->tables)) {
+    self->prewarmed = false;
+    return false;
+  }
+
+  return true;
+}
+
+bool specbleach_queue_parameter(SpectralBleachHandle instance,
+                                const SpectralBleachParameterId parameter_id,
+                                const float value,
+                                const uint32_t sample_offset) {
+  if (!instance || parameter_id < 0 ||
+      parameter_id >= SPECBLEACH_PARAMETER_COUNT) {
+    return false;
+  }
+
+  SbSpectralDenoiser *self = (SbSpectralDenoiser *)instance;
+
+  // Queuing never allocates, so changes to modules that aren't built can't be
+  // applied as asked. Configurations without masking thresholds always use
+  // critical bands in their place
+  const bool masking_thresholds =
+      parameter_id == SPECBLEACH_PARAMETER_NOISE_SCALING_TYPE &&
+      (int)value == MASKING_THRESHOLDS && !self->config.a_posteriori_snr_only;
+  const bool transient_protection =
+      parameter_id == SPECBLEACH_PARAMETER_TRANSIENT_PROTECTION &&
+      value != 0.F;
+  if (!spectral_denoiser_is_prepared(self->spectral_denoiser,
+                                     masking_thresholds,
+                                     transient_protection)) {
+    return false;
+  }
+
+  // When full the oldest change is applied right away. It is the earliest one
+  // so it would have been the first to be applied anyway
+  if (self->queued_parameters_count == MAX_QUEUED_PARAMETER_CHANGES) {
+    const QueuedParameter oldest = self->queued_parameters[0];
+    memmove(self->queued_parameters, &self->queued_parameters[1],
+            sizeof(QueuedParameter) * (MAX_QUEUED_PARAMETER_CHANGES - 1U));
+    self->queued_parameters_count--;
+    if (apply_parameter(self, oldest.parameter_id, oldest.value)) {
+      load_reduction_parameters(self->spectral_denoiser,
+                                self->denoise_parameters);
+    }
+  }
+
+  self->queued_parameters[self->queued_parameters_count++] = (QueuedParameter){
+      .parameter_id = parameter_id,
+      .value = value,
+      .sample_offset = sample_offset,
+  };
 
   return true;
 }
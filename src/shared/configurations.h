@@ -97,12 +97,30 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 // STFT configurations - Frame size in milliseconds
 #define OVERLAP_FACTOR_GENERAL 4
+// Frames are rounded down to a multiple of the overlap of every preset, so
+// all of them analyse the same frame and have the same latency
+#define FRAME_SIZE_MULTIPLE 8U
 #define INPUT_WINDOW_TYPE_GENERAL HANN_WINDOW
 #define OUTPUT_WINDOW_TYPE_GENERAL HANN_WINDOW
 
 // Fft configuration
-#define PADDING_CONFIGURATION_GENERAL NO_PADDING
-#define ZEROPADDING_AMOUNT_GENERAL 50 // Even Number
+#define PADDING_CONFIGURATION_GENERAL NEXT_POWER_OF_TWO
+#define ZEROPADDING_AMOUNT_GENERAL 50 // Percentage of the frame size
+
+// Eco preset. Half the frames of the general configuration, the smallest fft
+// that fits the frame and only the cheapest noise scaling
+#define OVERLAP_FACTOR_ECO 2
+#define PADDING_CONFIGURATION_ECO NO_PADDING
+#define NOISE_SCALING_TYPE_ECO A_POSTERIORI_SNR
+
+// HQ preset. Twice the frames of the general configuration and an fft of at
+// least twice the frame size for a finer frequency resolution
+#define OVERLAP_FACTOR_HQ 8
+#define PADDING_CONFIGURATION_HQ FIXED_AMOUNT
+#define ZEROPADDING_AMOUNT_HQ 100 // Percentage of the frame size
+
+// Parameter changes waiting for their hop boundary
+#define MAX_QUEUED_PARAMETER_CHANGES 64
 
 // Spectral Type
 #define SPECTRAL_TYPE_GENERAL POWER_SPECTRUM
@@ -135,7 +153,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 // Fft configurations
 #define PADDING_CONFIGURATION_SPEECH NO_PADDING
-#define ZEROPADDING_AMOUNT_SPEECH 50 // Even Number
+#define ZEROPADDING_AMOUNT_SPEECH 50 // Percentage of the frame size
 
 // Spectral Type
 #define SPECTRAL_TYPE_SPEECH POWER_SPECTRUM
@@ -24,47 +24,19 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <float.h>
 #include <math.h>
 
-static void wiener_subtraction(const uint32_t real_spectrum_size,
-                               const uint32_t fft_size, const float *spectrum,
-                               const float *noise_spectrum,
-                               float *gain_spectrum) {
+// The gains of the bins above the nyquist one are the same as the ones below
+static void mirror_gains(const uint32_t real_spectrum_size,
+                         const uint32_t fft_size, float *gain_spectrum) {
   for (uint32_t k = 1U; k < real_spectrum_size; k++) {
-    if (noise_spectrum[k] > FLT_MIN) {
-      if (spectrum[k] > noise_spectrum[k]) {
-        gain_spectrum[k] = (spectrum[k] - (noise_spectrum[k])) / spectrum[k];
-      } else {
-        gain_spectrum[k] = 0.F;
-      }
-      gain_spectrum[fft_size - k] = gain_spectrum[k];
-    } else {
-      gain_spectrum[k] = 1.F;
-      gain_spectrum[fft_size - k] = gain_spectrum[k];
-    }
-  }
-}
-
-static void spectral_gating(const uint32_t real_spectrum_size,
-                            const uint32_t fft_size, const float *spectrum,
-                            const float *noise_spectrum, float *gain_spectrum) {
-  for (uint32_t k = 1U; k < real_spectrum_size; k++) {
-    if (noise_spectrum[k] > FLT_MIN) {
-      if (spectrum[k] >= noise_spectrum[k]) {
-        gain_spectrum[k] = 1.F;
-      } else {
-        gain_spectrum[k] = 0.F;
-      }
-      gain_spectrum[fft_size - k] = gain_spectrum[k];
-    } else {
-      gain_spectrum[k] = 1.F;
-      gain_spectrum[fft_size - k] = gain_spectrum[k];
-    }
+    gain_spectrum[fft_size - k] = gain_spectrum[k];
   }
 }
 
+// powf doesn't vectorize, so this one stays scalar
 static void generalized_spectral_subtraction(
-    const uint32_t real_spectrum_size, const uint32_t fft_size,
-    const float *spectrum, const float *noise_spectrum, float *gain_spectrum,
-    const float *alpha, const float *beta) {
+    const uint32_t real_spectrum_size, const float *spectrum,
+    const float *noise_spectrum, float *gain_spectrum, const float *alpha,
+    const float *beta) {
   for (uint32_t k = 1U; k < real_spectrum_size; k++) {
     if (spectrum[k] > FLT_MIN) {
       if (powf((noise_spectrum[k] / spectrum[k]), GSS_EXPONENT) <
@@ -81,43 +53,40 @@ static void generalized_spectral_subtraction(
                        1.F / GSS_EXPONENT),
                   0.F);
       }
-      gain_spectrum[fft_size - k] = gain_spectrum[k];
     } else {
       gain_spectrum[k] = 1.F;
-      gain_spectrum[fft_size - k] = gain_spectrum[k];
     }
   }
 }
 
-static void scale_noise_profile(uint32_t real_spectrum_size,
-                                float *noise_spectrum, const float *alpha) {
-  for (uint32_t k = 1U; k < real_spectrum_size; k++) {
-    noise_spectrum[k] *= alpha[k];
-  }
-}
-
-void estimate_gains(uint32_t real_spectrum_size, uint32_t fft_size,
+void estimate_gains(const SpectralKernels *kernels,
+                    uint32_t real_spectrum_size, uint32_t fft_size,
                     const float *spectrum, float *noise_spectrum,
                     float *gain_spectrum, const float *alpha, const float *beta,
                     GainEstimationType type) {
+  // The DC bin is left as it is
+  const uint32_t bins = real_spectrum_size - 1U;
+
   switch (type) {
   case GATES:
-    scale_noise_profile(real_spectrum_size, noise_spectrum, alpha);
-    spectral_gating(real_spectrum_size, fft_size, spectrum, noise_spectrum,
-                    gain_spectrum);
+    kernels->multiply_spectrum(&noise_spectrum[1], &alpha[1], bins);
+    kernels->gate_gains(&spectrum[1], &noise_spectrum[1], &gain_spectrum[1],
+                        bins);
     break;
   case WIENER:
-    scale_noise_profile(real_spectrum_size, noise_spectrum, alpha);
-    wiener_subtraction(real_spectrum_size, fft_size, spectrum, noise_spectrum,
-                       gain_spectrum);
+    kernels->multiply_spectrum(&noise_spectrum[1], &alpha[1], bins);
+    kernels->wiener_gains(&spectrum[1], &noise_spectrum[1], &gain_spectrum[1],
+                          bins);
     break;
   case GENERALIZED_SPECTRALSUBTRACION:
-    generalized_spectral_subtraction(real_spectrum_size, fft_size, spectrum,
+    generalized_spectral_subtraction(real_spectrum_size, spectrum,
                                      noise_spectrum, gain_spectrum, alpha,
                                      beta);
     break;
 
   default:
-    break;
+    return;
   }
+
+  mirror_gains(real_spectrum_size, fft_size, gain_spectrum);
 }
\ No newline at end of file
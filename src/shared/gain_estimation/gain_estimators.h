@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef GAIN_ESTIMATORS_H
 #define GAIN_ESTIMATORS_H
 
+#include "../utils/spectral_kernels.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -30,7 +31,8 @@ typedef enum GainEstimationType {
   GENERALIZED_SPECTRALSUBTRACION = 2,
 } GainEstimationType;
 
-void estimate_gains(uint32_t real_spectrum_size, uint32_t fft_size,
+void estimate_gains(const SpectralKernels *kernels,
+                    uint32_t real_spectrum_size, uint32_t fft_size,
                     const float *spectrum, float *noise_spectrum,
                     float *gain_spectrum, const float *alpha, const float *beta,
                     GainEstimationType type);
@@ -33,8 +33,8 @@ typedef struct FrameSpectrum {
   float *speech_present_probability_spectrum;
 } FrameSpectrum;
 
-static FrameSpectrum *frame_spectrum_initialize(uint32_t frame_size);
-static void frame_spectrum_free(FrameSpectrum *self);
+static FrameSpectrum *frame_spectrum_initialize(Arena *arena,
+                                                uint32_t frame_size);
 static void compute_auto_thresholds(AdaptiveNoiseEstimator *self,
                                     uint32_t sample_rate,
                                     uint32_t noise_spectrum_size,
@@ -56,44 +56,33 @@ struct AdaptiveNoiseEstimator {
 };
 
 AdaptiveNoiseEstimator *
-louizou_estimator_initialize(const uint32_t noise_spectrum_size,
+louizou_estimator_initialize(Arena *arena, const uint32_t noise_spectrum_size,
                              const uint32_t sample_rate,
                              const uint32_t fft_size) {
-  AdaptiveNoiseEstimator *self =
-      (AdaptiveNoiseEstimator *)calloc(1U, sizeof(AdaptiveNoiseEstimator));
+  AdaptiveNoiseEstimator *self = (AdaptiveNoiseEstimator *)arena_calloc(
+      arena, 1U, sizeof(AdaptiveNoiseEstimator));
 
   self->noise_spectrum_size = noise_spectrum_size;
 
   self->minimum_detection_thresholds =
-      (float *)calloc(self->noise_spectrum_size, sizeof(float));
+      (float *)arena_calloc(arena, self->noise_spectrum_size, sizeof(float));
   self->time_frequency_smoothing_constant =
-      (float *)calloc(self->noise_spectrum_size, sizeof(float));
+      (float *)arena_calloc(arena, self->noise_spectrum_size, sizeof(float));
   self->speech_presence_detection =
-      (uint32_t *)calloc(self->noise_spectrum_size, sizeof(uint32_t));
+      (uint32_t *)arena_calloc(
+          arena, self->noise_spectrum_size, sizeof(uint32_t));
   self->previous_noise_spectrum =
-      (float *)calloc(self->noise_spectrum_size, sizeof(float));
+      (float *)arena_calloc(arena, self->noise_spectrum_size, sizeof(float));
 
   compute_auto_thresholds(self, sample_rate, noise_spectrum_size, fft_size);
-  self->current = frame_spectrum_initialize(noise_spectrum_size);
-  self->previous = frame_spectrum_initialize(noise_spectrum_size);
+  self->current = frame_spectrum_initialize(arena, noise_spectrum_size);
+  self->previous = frame_spectrum_initialize(arena, noise_spectrum_size);
 
   self->noisy_speech_ratio = 0.F;
 
   return self;
 }
 
-void louizou_estimator_free(AdaptiveNoiseEstimator *self) {
-  free(self->minimum_detection_thresholds);
-  free(self->time_frequency_smoothing_constant);
-  free(self->speech_presence_detection);
-  free(self->previous_noise_spectrum);
-
-  frame_spectrum_free(self->current);
-  frame_spectrum_free(self->previous);
-
-  free(self);
-}
-
 bool louizou_estimator_run(AdaptiveNoiseEstimator *self, const float *spectrum,
                            float *noise_spectrum) {
   if (!self || !spectrum || !noise_spectrum) {
@@ -160,13 +149,17 @@ static void update_frame_spectums(AdaptiveNoiseEstimator *self,
          sizeof(float) * self->noise_spectrum_size);
 }
 
-static FrameSpectrum *frame_spectrum_initialize(const uint32_t frame_size) {
-  FrameSpectrum *self = (FrameSpectrum *)calloc(1U, sizeof(FrameSpectrum));
+static FrameSpectrum *frame_spectrum_initialize(Arena *arena,
+                                                const uint32_t frame_size) {
+  FrameSpectrum *self =
+      (FrameSpectrum *)arena_calloc(arena, 1U, sizeof(FrameSpectrum));
 
-  self->smoothed_spectrum = (float *)calloc(frame_size, sizeof(float));
-  self->local_minimum_spectrum = (float *)calloc(frame_size, sizeof(float));
+  self->smoothed_spectrum =
+      (float *)arena_calloc(arena, frame_size, sizeof(float));
+  self->local_minimum_spectrum =
+      (float *)arena_calloc(arena, frame_size, sizeof(float));
   self->speech_present_probability_spectrum =
-      (float *)calloc(frame_size, sizeof(float));
+      (float *)arena_calloc(arena, frame_size, sizeof(float));
 
   initialize_spectrum_with_value(self->local_minimum_spectrum, frame_size,
                                  FLT_MIN);
@@ -174,14 +167,6 @@ static FrameSpectrum *frame_spectrum_initialize(const uint32_t frame_size) {
   return self;
 }
 
-static void frame_spectrum_free(FrameSpectrum *self) {
-  free(self->smoothed_spectrum);
-  free(self->local_minimum_spectrum);
-  free(self->speech_present_probability_spectrum);
-
-  free(self);
-}
-
 static void compute_auto_thresholds(AdaptiveNoiseEstimator *self,
                                     const uint32_t sample_rate,
                                     const uint32_t noise_spectrum_size,
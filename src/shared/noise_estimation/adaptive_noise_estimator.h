@@ -21,15 +21,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ADAPTIVE_NOISE_ESTIMATOR_H
 #define ADAPTIVE_NOISE_ESTIMATOR_H
 
+#include "../utils/arena.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 typedef struct AdaptiveNoiseEstimator AdaptiveNoiseEstimator;
 
 AdaptiveNoiseEstimator *
-louizou_estimator_initialize(uint32_t noise_spectrum_size, uint32_t sample_rate,
-                             uint32_t fft_size);
-void louizou_estimator_free(AdaptiveNoiseEstimator *self);
+louizou_estimator_initialize(Arena *arena, uint32_t noise_spectrum_size,
+                             uint32_t sample_rate, uint32_t fft_size);
 bool louizou_estimator_run(AdaptiveNoiseEstimator *self, const float *spectrum,
                            float *noise_spectrum);
 
@@ -27,6 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <string.h>
 
 struct NoiseEstimator {
+  const SpectralKernels *kernels;
   uint32_t fft_size;
   uint32_t real_spectrum_size;
   SpectralTrailingBuffer *median_buffer;
@@ -34,9 +35,15 @@ struct NoiseEstimator {
   NoiseProfile *noise_profile;
 };
 
-NoiseEstimator *noise_estimation_initialize(const uint32_t fft_size,
-                                            NoiseProfile *noise_profile) {
-  NoiseEstimator *self = (NoiseEstimator *)calloc(1U, sizeof(NoiseEstimator));
+NoiseEstimator *
+noise_estimation_initialize(Arena *arena, const SpectralKernels *kernels,
+                            const uint32_t fft_size,
+                            const uint32_t median_spectrum_count,
+                            NoiseProfile *noise_profile) {
+  NoiseEstimator *self =
+      (NoiseEstimator *)arena_calloc(arena, 1U, sizeof(NoiseEstimator));
+
+  self->kernels = kernels;
 
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
@@ -44,18 +51,14 @@ NoiseEstimator *noise_estimation_initialize(const uint32_t fft_size,
   self->noise_profile = noise_profile;
 
   self->median_buffer = spectral_trailing_buffer_initialize(
-      self->real_spectrum_size, NUMBER_OF_MEDIAN_SPECTRUM);
+      arena, self->real_spectrum_size, median_spectrum_count);
 
   return self;
 }
 
-void noise_estimation_free(NoiseEstimator *self) {
-
-  // Don't free noise profile used as reference here
-
-  spectral_trailing_buffer_free(self->median_buffer);
-
-  free(self);
+void noise_estimation_reset(NoiseEstimator *self) {
+  // The noise profile itself is kept
+  spectral_trailing_buffer_reset(self->median_buffer);
 }
 
 bool noise_estimation_run(NoiseEstimator *self,
@@ -70,7 +73,7 @@ bool noise_estimation_run(NoiseEstimator *self,
   switch (noise_estimator_type) {
   case ROLLING_MEAN:
     get_rolling_mean_spectrum(
-        noise_profile, signal_spectrum,
+        self->kernels, noise_profile, signal_spectrum,
         get_noise_profile_blocks_averaged(self->noise_profile),
         self->real_spectrum_size);
     increment_blocks_averaged(self->noise_profile);
@@ -86,7 +89,8 @@ bool noise_estimation_run(NoiseEstimator *self,
     }
     break;
   case MAX:
-    max_spectrum(noise_profile, signal_spectrum, self->real_spectrum_size);
+    max_spectrum(self->kernels, noise_profile, signal_spectrum,
+                 self->real_spectrum_size);
     set_noise_profile_available(self->noise_profile);
     break;
 
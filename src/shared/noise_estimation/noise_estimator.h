@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef NOISE_ESTIMATOR_H
 #define NOISE_ESTIMATOR_H
 
+#include "../utils/spectral_kernels.h"
 #include "noise_profile.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -34,9 +35,12 @@ typedef enum NoiseEstimatorType {
   MAX = 3,
 } NoiseEstimatorType;
 
-NoiseEstimator *noise_estimation_initialize(uint32_t fft_size,
+NoiseEstimator *noise_estimation_initialize(Arena *arena,
+                                            const SpectralKernels *kernels,
+                                            uint32_t fft_size,
+                                            uint32_t median_spectrum_count,
                                             NoiseProfile *noise_profile);
-void noise_estimation_free(NoiseEstimator *self);
+void noise_estimation_reset(NoiseEstimator *self);
 bool noise_estimation_run(NoiseEstimator *self,
                           NoiseEstimatorType noise_estimator_type,
                           float *signal_spectrum);
@@ -31,23 +31,18 @@ struct NoiseProfile {
   bool noise_spectrum_available;
 };
 
-NoiseProfile *noise_profile_initialize(const uint32_t size) {
-  NoiseProfile *self = (NoiseProfile *)calloc(1U, sizeof(NoiseProfile));
+NoiseProfile *noise_profile_initialize(Arena *arena, const uint32_t size) {
+  NoiseProfile *self =
+      (NoiseProfile *)arena_calloc(arena, 1U, sizeof(NoiseProfile));
   self->noise_profile_size = size;
   self->noise_profile_blocks_averaged = 0U;
   self->noise_spectrum_available = false;
 
-  self->noise_profile = (float *)calloc(size, sizeof(float));
+  self->noise_profile = (float *)arena_calloc(arena, size, sizeof(float));
 
   return self;
 }
 
-void noise_profile_free(NoiseProfile *self) {
-  free(self->noise_profile);
-
-  free(self);
-}
-
 bool is_noise_estimation_available(NoiseProfile *self) {
   return self->noise_spectrum_available;
 }
@@ -65,6 +60,46 @@ void set_noise_profile_available(NoiseProfile *self) {
   self->noise_spectrum_available = true;
 }
 
+bool resample_noise_profile(const float *input, const uint32_t input_size,
+                            float *output, const uint32_t output_size) {
+  if (!input || !output || input_size == 0U || output_size == 0U) {
+    return false;
+  }
+
+  // Check if sizes match - direct copy if they do
+  if (input_size == output_size) {
+    memcpy(output, input, input_size * sizeof(float));
+    return true;
+  }
+
+  // Sizes don't match - need to resize
+
+  // Copy DC component (index 0) directly
+  output[0] = input[0];
+
+  // Linear interpolation for the rest of the spectrum
+  for (uint32_t k = 1; k < output_size; k++) {
+    // Calculate the equivalent position in the source spectrum
+    float src_idx =
+        (float)k * (float)(input_size - 1) / (float)(output_size - 1);
+
+    // Get integer indices for interpolation
+    uint32_t idx_low = (uint32_t)src_idx;
+    uint32_t idx_high = idx_low + 1;
+    if (idx_high >= input_size) {
+      idx_high = input_size - 1;
+    }
+
+    // Calculate interpolation factor
+    float alpha = src_idx - (float)idx_low;
+
+    // Perform linear interpolation for power spectrum values
+    output[k] = (1.0f - alpha) * input[idx_low] + alpha * input[idx_high];
+  }
+
+  return true;
+}
+
 bool set_noise_profile(NoiseProfile *self, const float *noise_profile,
                        const uint32_t noise_profile_size,
                        const uint32_t noise_profile_blocks_averaged) {
@@ -72,36 +107,9 @@ bool set_noise_profile(NoiseProfile *self, const float *noise_profile,
     return false;
   }
 
-  // Check if sizes match - direct copy if they do
-  if (noise_profile_size == self->noise_profile_size) {
-    memcpy(self->noise_profile, noise_profile,
-           noise_profile_size * sizeof(float));
-  } else {
-    // Sizes don't match - need to resize
-
-    // Copy DC component (index 0) directly
-    self->noise_profile[0] = noise_profile[0];
-
-    // Linear interpolation for the rest of the spectrum
-    for (uint32_t k = 1; k < self->noise_profile_size; k++) {
-      // Calculate the equivalent position in the source spectrum
-      float src_idx = (float)k * (float)(noise_profile_size - 1) /
-                      (float)(self->noise_profile_size - 1);
-
-      // Get integer indices for interpolation
-      uint32_t idx_low = (uint32_t)src_idx;
-      uint32_t idx_high = idx_low + 1;
-      if (idx_high >= noise_profile_size) {
-        idx_high = noise_profile_size - 1;
-      }
-
-      // Calculate interpolation factor
-      float alpha = src_idx - (float)idx_low;
-
-      // Perform linear interpolation for power spectrum values
-      self->noise_profile[k] = (1.0f - alpha) * noise_profile[idx_low] +
-                               alpha * noise_profile[idx_high];
-    }
+  if (!resample_noise_profile(noise_profile, noise_profile_size,
+                              self->noise_profile, self->noise_profile_size)) {
+    return false;
   }
 
   // Update metadata
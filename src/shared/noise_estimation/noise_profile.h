@@ -21,17 +21,21 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef NOISE_PROFILE_H
 #define NOISE_PROFILE_H
 
+#include "../utils/arena.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 typedef struct NoiseProfile NoiseProfile;
 
-NoiseProfile *noise_profile_initialize(uint32_t size);
-void noise_profile_free(NoiseProfile *self);
+NoiseProfile *noise_profile_initialize(Arena *arena, uint32_t size);
 float *get_noise_profile(NoiseProfile *self);
 uint32_t get_noise_profile_size(NoiseProfile *self);
 uint32_t get_noise_profile_blocks_averaged(NoiseProfile *self);
 bool increment_blocks_averaged(NoiseProfile *self);
+// Maps a noise profile onto a different number of bins using linear
+// interpolation. It doesn't allocate and can be used with any thread.
+bool resample_noise_profile(const float *input, uint32_t input_size,
+                            float *output, uint32_t output_size);
 bool set_noise_profile(NoiseProfile *self, const float *noise_profile,
                        uint32_t noise_profile_size, uint32_t averaged_blocks);
 void set_noise_profile_available(NoiseProfile *self);
@@ -21,15 +21,17 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "postfilter.h"
 #include "../configurations.h"
 #include "../stft/fft_transform.h"
+#include "../utils/spectral_utils.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
 struct PostFilter {
-  FftTransform *gain_fft_spectrum;
-  FftTransform *postfilter_fft_spectrum;
+  const SpectralKernels *kernels;
+  FftTransform *fft_spectrum;
 
   float *postfilter;
+  float *postfilter_spectrum;
   float *pf_gain_spectrum;
 
   uint32_t fft_size;
@@ -38,33 +40,33 @@ struct PostFilter {
   float default_postfilter_scale;
 };
 
-PostFilter *postfilter_initialize(const uint32_t fft_size) {
-  PostFilter *self = (PostFilter *)calloc(1U, sizeof(PostFilter));
+PostFilter *postfilter_initialize(Arena *arena, DspTables *tables,
+                                  ScratchPool *scratch,
+                                  const SpectralKernels *kernels,
+                                  const uint32_t fft_size,
+                                  const float postfilter_scale) {
+  PostFilter *self = (PostFilter *)arena_calloc(arena, 1U, sizeof(PostFilter));
+
+  self->kernels = kernels;
 
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
   self->preserve_minimun = (bool)PRESERVE_MINIMUN_GAIN;
-  self->default_postfilter_scale = POSTFILTER_SCALE;
+  self->default_postfilter_scale = postfilter_scale;
 
-  self->gain_fft_spectrum = fft_transform_initialize_bins(self->fft_size);
-  self->postfilter_fft_spectrum = fft_transform_initialize_bins(self->fft_size);
-  self->pf_gain_spectrum = (float *)calloc(self->fft_size, sizeof(float));
+  // Both spectra go through the same transform one after the other
+  self->fft_spectrum =
+      fft_transform_initialize_bins(arena, tables, self->fft_size);
 
-  self->postfilter = (float *)calloc(self->fft_size, sizeof(float));
+  self->pf_gain_spectrum = get_scratch_buffer(scratch, SCRATCH_BUFFER_A);
+  self->postfilter = get_scratch_buffer(scratch, SCRATCH_BUFFER_B);
+  // The spectrum of the filter is kept from designing it to using it
+  self->postfilter_spectrum =
+      (float *)arena_calloc(arena, self->fft_size, sizeof(float));
 
   return self;
 }
 
-void postfilter_free(PostFilter *self) {
-  fft_transform_free(self->gain_fft_spectrum);
-  fft_transform_free(self->postfilter_fft_spectrum);
-
-  free(self->postfilter);
-  free(self->pf_gain_spectrum);
-
-  free(self);
-}
-
 static void calculate_postfilter(PostFilter *self, const float *spectrum,
                                  const float snr_threshold,
                                  const float *gain_spectrum) {
@@ -102,6 +104,10 @@ static void calculate_postfilter(PostFilter *self, const float *spectrum,
       self->postfilter[k] = 0.F;
     }
   }
+
+  // The transform reads the whole buffer
+  memset(&self->postfilter[self->real_spectrum_size], 0,
+         (self->fft_size - self->real_spectrum_size) * sizeof(float));
 }
 
 bool postfilter_apply(PostFilter *self, const float *spectrum,
@@ -111,36 +117,47 @@ bool postfilter_apply(PostFilter *self, const float *spectrum,
     return false;
   }
 
-  memcpy(self->pf_gain_spectrum, gain_spectrum, self->fft_size * sizeof(float));
+  postfilter_design(self, spectrum, gain_spectrum, parameters);
+  postfilter_filter_gains(self, gain_spectrum);
 
+  return true;
+}
+
+void postfilter_design(PostFilter *self, const float *spectrum,
+                       const float *gain_spectrum,
+                       const PostFiltersParameters parameters) {
   calculate_postfilter(self, spectrum, parameters.snr_threshold,
-                       self->pf_gain_spectrum);
+                       gain_spectrum);
 
-  fft_load_input_samples(self->gain_fft_spectrum, self->pf_gain_spectrum);
-  fft_load_input_samples(self->postfilter_fft_spectrum, self->postfilter);
+  fft_load_input_samples(self->fft_spectrum, self->postfilter);
+  compute_forward_fft(self->fft_spectrum);
+  memcpy(self->postfilter_spectrum, get_fft_output_buffer(self->fft_spectrum),
+         self->fft_size * sizeof(float));
+}
 
-  compute_forward_fft(self->gain_fft_spectrum);
-  compute_forward_fft(self->postfilter_fft_spectrum);
+void postfilter_filter_gains(PostFilter *self, float *gain_spectrum) {
+  memcpy(self->pf_gain_spectrum, gain_spectrum, self->fft_size * sizeof(float));
+
+  fft_load_input_samples(self->fft_spectrum, self->pf_gain_spectrum);
+  compute_forward_fft(self->fft_spectrum);
 
   for (uint32_t k = 0U; k < self->fft_size; k++) {
-    get_fft_output_buffer(self->gain_fft_spectrum)[k] *=
-        get_fft_output_buffer(self->postfilter_fft_spectrum)[k];
+    get_fft_output_buffer(self->fft_spectrum)[k] *=
+        self->postfilter_spectrum[k];
   }
 
-  compute_backward_fft(self->gain_fft_spectrum);
+  compute_backward_fft(self->fft_spectrum);
 
   for (uint32_t k = 0U; k < self->fft_size; k++) {
     self->pf_gain_spectrum[k] =
-        get_fft_input_buffer(self->gain_fft_spectrum)[k] /
-        (float)self->fft_size;
+        get_fft_input_buffer(self->fft_spectrum)[k] / (float)self->fft_size;
   }
 
   if (self->preserve_minimun) {
-    min_spectrum(gain_spectrum, self->pf_gain_spectrum, self->fft_size);
+    min_spectrum(self->kernels, gain_spectrum, self->pf_gain_spectrum,
+                 self->fft_size);
   } else {
     memcpy(gain_spectrum, self->pf_gain_spectrum,
            self->fft_size * sizeof(float));
   }
-
-  return true;
 }
@@ -21,6 +21,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef POSTFILTER_H
 #define POSTFILTER_H
 
+#include "../utils/arena.h"
+#include "../utils/dsp_tables.h"
+#include "../utils/scratch_pool.h"
+#include "../utils/spectral_kernels.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -30,9 +34,18 @@ typedef struct PostFiltersParameters {
   float snr_threshold;
 } PostFiltersParameters;
 
-PostFilter *postfilter_initialize(uint32_t fft_size);
-void postfilter_free(PostFilter *self);
+PostFilter *postfilter_initialize(Arena *arena, DspTables *tables,
+                                  ScratchPool *scratch,
+                                  const SpectralKernels *kernels,
+                                  uint32_t fft_size, float postfilter_scale);
 bool postfilter_apply(PostFilter *self, const float *spectrum,
                       float *gain_spectrum, PostFiltersParameters parameters);
+// The same as postfilter_apply in two halves of about the same cost, which
+// can run in different calls. The first one designs the filter for the frame
+// and keeps its spectrum, which the second one filters the gains with
+void postfilter_design(PostFilter *self, const float *spectrum,
+                       const float *gain_spectrum,
+                       PostFiltersParameters parameters);
+void postfilter_filter_gains(PostFilter *self, float *gain_spectrum);
 
 #endif
\ No newline at end of file
@@ -20,14 +20,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "spectral_whitening.h"
 #include "../configurations.h"
-#include <float.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
 struct SpectralWhitening {
+  const SpectralKernels *kernels;
   float *residual_max_spectrum;
-  float *whitened_residual_spectrum;
 
   float max_decay_rate;
   uint32_t whitening_window_count;
@@ -36,19 +35,21 @@ struct SpectralWhitening {
   uint32_t hop;
 };
 
-SpectralWhitening *spectral_whitening_initialize(const uint32_t fft_size,
+SpectralWhitening *spectral_whitening_initialize(Arena *arena,
+                                                 const SpectralKernels *kernels,
+                                                 const uint32_t fft_size,
                                                  const uint32_t sample_rate,
                                                  const uint32_t hop) {
   SpectralWhitening *self =
-      (SpectralWhitening *)calloc(1U, sizeof(SpectralWhitening));
+      (SpectralWhitening *)arena_calloc(arena, 1U, sizeof(SpectralWhitening));
 
+  self->kernels = kernels;
   self->fft_size = fft_size;
   self->sample_rate = sample_rate;
   self->hop = hop;
 
-  self->whitened_residual_spectrum =
-      (float *)calloc(self->fft_size, sizeof(float));
-  self->residual_max_spectrum = (float *)calloc(self->fft_size, sizeof(float));
+  self->residual_max_spectrum =
+      (float *)arena_calloc(arena, self->fft_size, sizeof(float));
   self->max_decay_rate =
       expf(-1000.F / (((WHITENING_DECAY_RATE) * (float)self->sample_rate) /
                       (float)self->hop));
@@ -57,11 +58,9 @@ SpectralWhitening *spectral_whitening_initialize(const uint32_t fft_size,
   return self;
 }
 
-void spectral_whitening_free(SpectralWhitening *self) {
-  free(self->whitened_residual_spectrum);
-  free(self->residual_max_spectrum);
-
-  free(self);
+void spectral_whitening_reset(SpectralWhitening *self) {
+  memset(self->residual_max_spectrum, 0, self->fft_size * sizeof(float));
+  self->whitening_window_count = 0U;
 }
 
 bool spectral_whitening_run(SpectralWhitening *self,
@@ -72,25 +71,16 @@ bool spectral_whitening_run(SpectralWhitening *self,
 
   self->whitening_window_count++;
 
-  for (uint32_t k = 1U; k < self->fft_size; k++) {
-    if (self->whitening_window_count > 1U) {
-      self->residual_max_spectrum[k] =
-          fmaxf(fmaxf(fft_spectrum[k], WHITENING_FLOOR),
-                self->residual_max_spectrum[k] * self->max_decay_rate);
-    } else {
-      self->residual_max_spectrum[k] = fmaxf(fft_spectrum[k], WHITENING_FLOOR);
-    }
-  }
+  // The first frame has no peaks to decay, only the floor
+  const float decay_rate =
+      self->whitening_window_count > 1U ? self->max_decay_rate : 0.F;
+  self->kernels->update_peak_spectrum(&self->residual_max_spectrum[1],
+                                      &fft_spectrum[1], WHITENING_FLOOR,
+                                      decay_rate, self->fft_size - 1U);
 
-  for (uint32_t k = 1U; k < self->fft_size; k++) {
-    if (fft_spectrum[k] > FLT_MIN) {
-      self->whitened_residual_spectrum[k] =
-          fft_spectrum[k] / self->residual_max_spectrum[k];
-
-      fft_spectrum[k] = (1.F - whitening_factor) * fft_spectrum[k] +
-                        whitening_factor * self->whitened_residual_spectrum[k];
-    }
-  }
+  self->kernels->whiten_spectrum(&fft_spectrum[1],
+                                 &self->residual_max_spectrum[1],
+                                 whitening_factor, self->fft_size - 1U);
 
   return true;
 }
\ No newline at end of file
@@ -21,15 +21,19 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef SPECTRAL_WHITENER_H
 #define SPECTRAL_WHITENER_H
 
+#include "../utils/arena.h"
+#include "../utils/spectral_kernels.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 typedef struct SpectralWhitening SpectralWhitening;
 
-SpectralWhitening *spectral_whitening_initialize(uint32_t fft_size,
+SpectralWhitening *spectral_whitening_initialize(Arena *arena,
+                                                 const SpectralKernels *kernels,
+                                                 uint32_t fft_size,
                                                  uint32_t sample_rate,
                                                  uint32_t hop);
-void spectral_whitening_free(SpectralWhitening *self);
+void spectral_whitening_reset(SpectralWhitening *self);
 bool spectral_whitening_run(SpectralWhitening *self, float whitening_factor,
                             float *fft_spectrum);
 
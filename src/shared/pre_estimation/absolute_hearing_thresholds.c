@@ -49,11 +49,23 @@ struct AbsoluteHearingThresholds {
 };
 
 AbsoluteHearingThresholds *
-absolute_hearing_thresholds_initialize(const uint32_t sample_rate,
+absolute_hearing_thresholds_initialize(DspTables *tables,
+                                       const uint32_t sample_rate,
                                        const uint32_t fft_size,
                                        SpectrumType spectrum_type) {
-  AbsoluteHearingThresholds *self = (AbsoluteHearingThresholds *)calloc(
-      1U, sizeof(AbsoluteHearingThresholds));
+  const DspTableKey key = {.type = DSP_TABLE_HEARING_THRESHOLDS,
+                           .size = fft_size,
+                           .variant = (uint32_t)spectrum_type,
+                           .sample_rate = sample_rate};
+  AbsoluteHearingThresholds *self =
+      (AbsoluteHearingThresholds *)dsp_tables_find(tables, key);
+  if (self) {
+    return self;
+  }
+
+  Arena *arena = get_dsp_tables_arena(tables);
+  self = (AbsoluteHearingThresholds *)arena_calloc(
+      arena, 1U, sizeof(AbsoluteHearingThresholds));
 
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
@@ -63,38 +75,29 @@ absolute_hearing_thresholds_initialize(const uint32_t sample_rate,
   self->sine_wave_frequency = REFERENCE_SINE_WAVE_FREQ;
   self->reference_level = REFERENCE_LEVEL;
 
-  self->fft_transform = fft_transform_initialize_bins(self->fft_size);
+  self->fft_transform =
+      fft_transform_initialize_bins(arena, tables, self->fft_size);
 
   self->spl_reference_values =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
 
   self->absolute_thresholds =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
 
-  self->sinewave = (float *)calloc(self->fft_size, sizeof(float));
-  self->window = (float *)calloc(self->fft_size, sizeof(float));
+  self->sinewave = (float *)arena_calloc(arena, self->fft_size, sizeof(float));
+  self->window = (float *)arena_calloc(arena, self->fft_size, sizeof(float));
 
   self->spectral_features =
-      spectral_features_initialize(self->real_spectrum_size);
+      spectral_features_initialize(arena, self->real_spectrum_size);
 
   generate_sinewave(self);
   get_fft_window(self->window, self->fft_size, VORBIS_WINDOW);
   compute_spl_reference_spectrum(self);
   compute_absolute_thresholds(self);
 
-  return self;
-}
+  dsp_tables_add(tables, key, self);
 
-void absolute_hearing_thresholds_free(AbsoluteHearingThresholds *self) {
-  fft_transform_free(self->fft_transform);
-  spectral_features_free(self->spectral_features);
-
-  free(self->sinewave);
-  free(self->window);
-  free(self->spl_reference_values);
-  free(self->absolute_thresholds);
-
-  free(self);
+  return self;
 }
 
 static void generate_sinewave(AbsoluteHearingThresholds *self) {
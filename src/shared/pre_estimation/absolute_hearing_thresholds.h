@@ -21,16 +21,19 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ABSOLUTE_HEARING_THRESHOLDS_H
 #define ABSOLUTE_HEARING_THRESHOLDS_H
 
+#include "../utils/dsp_tables.h"
 #include "../utils/spectral_features.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 typedef struct AbsoluteHearingThresholds AbsoluteHearingThresholds;
 
+// The thresholds are only read after they are computed, so they are shared
+// tables
 AbsoluteHearingThresholds *
-absolute_hearing_thresholds_initialize(uint32_t sample_rate, uint32_t fft_size,
+absolute_hearing_thresholds_initialize(DspTables *tables, uint32_t sample_rate,
+                                       uint32_t fft_size,
                                        SpectrumType spectrum_type);
-void absolute_hearing_thresholds_free(AbsoluteHearingThresholds *self);
 bool apply_thresholds_as_floor(AbsoluteHearingThresholds *self,
                                float *spectrum);
 
@@ -56,14 +56,23 @@ struct CriticalBands {
   uint32_t sample_rate;
   uint32_t number_bands;
   CriticalBandType type;
-  CriticalBandIndexes band_indexes;
 };
 
-CriticalBands *critical_bands_initialize(const uint32_t sample_rate,
+CriticalBands *critical_bands_initialize(DspTables *tables,
+                                         const uint32_t sample_rate,
                                          const uint32_t fft_size,
                                          const CriticalBandType type) {
+  const DspTableKey key = {.type = DSP_TABLE_CRITICAL_BANDS,
+                           .size = fft_size,
+                           .variant = (uint32_t)type,
+                           .sample_rate = sample_rate};
+  CriticalBands *self = (CriticalBands *)dsp_tables_find(tables, key);
+  if (self) {
+    return self;
+  }
 
-  CriticalBands *self = (CriticalBands *)calloc(1U, sizeof(CriticalBands));
+  Arena *arena = get_dsp_tables_arena(tables);
+  self = (CriticalBands *)arena_calloc(arena, 1U, sizeof(CriticalBands));
 
   self->fft_size = fft_size;
   self->real_spectrum_size = fft_size / 2U + 1U;
@@ -73,20 +82,15 @@ CriticalBands *critical_bands_initialize(const uint32_t sample_rate,
   compute_mapping_spectrum(self);
 
   self->band_delimiter_bins =
-      (uint32_t *)calloc(self->number_bands, sizeof(uint32_t));
+      (uint32_t *)arena_calloc(arena, self->number_bands, sizeof(uint32_t));
   self->number_bins_per_band =
-      (uint32_t *)calloc(self->number_bands, sizeof(uint32_t));
+      (uint32_t *)arena_calloc(arena, self->number_bands, sizeof(uint32_t));
 
   compute_band_indexes(self);
 
-  return self;
-}
+  dsp_tables_add(tables, key, self);
 
-void critical_bands_free(CriticalBands *self) {
-  free(self->band_delimiter_bins);
-  free(self->number_bins_per_band);
-
-  free(self);
+  return self;
 }
 
 static void compute_band_indexes(CriticalBands *self) {
@@ -168,10 +172,10 @@ bool compute_critical_bands_spectrum(CriticalBands *self, const float *spectrum,
 
   for (uint32_t j = 0U; j < self->number_bands; j++) {
 
-    self->band_indexes = get_band_indexes(self, j);
+    const CriticalBandIndexes band_indexes = get_band_indexes(self, j);
 
-    for (uint32_t k = self->band_indexes.start_position;
-         k < self->band_indexes.end_position; k++) {
+    for (uint32_t k = band_indexes.start_position;
+         k < band_indexes.end_position; k++) {
       critical_bands[j] += spectrum[k];
     }
   }
@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef CRITICAL_BANDS_H
 #define CRITICAL_BANDS_H
 
+#include "../utils/dsp_tables.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -38,10 +39,11 @@ typedef struct CriticalBandIndexes {
   uint32_t end_position;
 } CriticalBandIndexes;
 
-CriticalBands *critical_bands_initialize(uint32_t sample_rate,
+// Band layouts only depend on their arguments, so they are shared tables
+CriticalBands *critical_bands_initialize(DspTables *tables,
+                                         uint32_t sample_rate,
                                          uint32_t fft_size,
                                          CriticalBandType type);
-void critical_bands_free(CriticalBands *self);
 bool compute_critical_bands_spectrum(CriticalBands *self, const float *spectrum,
                                      float *critical_bands);
 CriticalBandIndexes get_band_indexes(CriticalBands *self, uint32_t band_number);
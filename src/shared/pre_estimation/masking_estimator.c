@@ -27,7 +27,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <stdlib.h>
 #include <string.h>
 
-static void compute_spectral_spreading_function(MaskingEstimator *self);
+static void compute_spectral_spreading_function(float *spreading_function,
+                                                uint32_t number_bands);
+static void get_spreading_tables(MaskingEstimator *self, DspTables *tables);
 static float compute_tonality_factor(MaskingEstimator *self,
                                      const float *spectrum, uint32_t band);
 
@@ -42,78 +44,49 @@ struct MaskingEstimator {
   CriticalBands *critical_bands;
   CriticalBandIndexes band_indexes;
 
-  float *spectral_spreading_function;
-  float *unity_gain_critical_bands_spectrum;
-  float *spreaded_unity_gain_critical_bands_spectrum;
+  const float *spectral_spreading_function;
+  const float *spreaded_unity_gain_critical_bands_spectrum;
   float *threshold_j;
   float *masking_offset;
   float *spreaded_spectrum;
   float *critical_bands_reference_spectrum;
 };
 
-MaskingEstimator *masking_estimation_initialize(const uint32_t fft_size,
+MaskingEstimator *masking_estimation_initialize(Arena *arena, DspTables *tables,
+                                                const uint32_t fft_size,
                                                 const uint32_t sample_rate,
+                                                CriticalBandType band_type,
                                                 SpectrumType spectrum_type) {
 
   MaskingEstimator *self =
-      (MaskingEstimator *)calloc(1U, sizeof(MaskingEstimator));
+      (MaskingEstimator *)arena_calloc(arena, 1U, sizeof(MaskingEstimator));
 
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
   self->sample_rate = sample_rate;
 
   self->critical_bands = critical_bands_initialize(
-      self->sample_rate, self->fft_size, CRITICAL_BANDS_TYPE);
+      tables, self->sample_rate, self->fft_size, band_type);
   self->number_critical_bands =
       get_number_of_critical_bands(self->critical_bands);
 
-  self->spectral_spreading_function =
-      (float *)calloc(((size_t)self->number_critical_bands *
-                       (size_t)self->number_critical_bands),
-                      sizeof(float));
-  self->unity_gain_critical_bands_spectrum =
-      (float *)calloc(self->number_critical_bands, sizeof(float));
-  self->spreaded_unity_gain_critical_bands_spectrum =
-      (float *)calloc(self->number_critical_bands, sizeof(float));
   self->threshold_j =
-      (float *)calloc(self->number_critical_bands, sizeof(float));
+      (float *)arena_calloc(arena, self->number_critical_bands, sizeof(float));
   self->masking_offset =
-      (float *)calloc(self->number_critical_bands, sizeof(float));
+      (float *)arena_calloc(arena, self->number_critical_bands, sizeof(float));
   self->spreaded_spectrum =
-      (float *)calloc(self->number_critical_bands, sizeof(float));
+      (float *)arena_calloc(arena, self->number_critical_bands, sizeof(float));
   self->critical_bands_reference_spectrum =
-      (float *)calloc(self->number_critical_bands, sizeof(float));
+      (float *)arena_calloc(arena, self->number_critical_bands, sizeof(float));
 
   self->reference_spectrum = absolute_hearing_thresholds_initialize(
-      self->sample_rate, self->fft_size, spectrum_type);
+      tables, self->sample_rate, self->fft_size, spectrum_type);
 
-  compute_spectral_spreading_function(self);
-  initialize_spectrum_with_value(self->unity_gain_critical_bands_spectrum,
-                                 self->number_critical_bands, 1.F);
-  direct_matrix_to_vector_spectral_convolution(
-      self->spectral_spreading_function,
-      self->unity_gain_critical_bands_spectrum,
-      self->spreaded_unity_gain_critical_bands_spectrum,
-      self->number_critical_bands);
+  get_spreading_tables(self, tables);
 
   return self;
 }
 
-void masking_estimation_free(MaskingEstimator *self) {
-  absolute_hearing_thresholds_free(self->reference_spectrum);
-  critical_bands_free(self->critical_bands);
-
-  free(self->spectral_spreading_function);
-  free(self->unity_gain_critical_bands_spectrum);
-  free(self->spreaded_unity_gain_critical_bands_spectrum);
-  free(self->threshold_j);
-  free(self->masking_offset);
-  free(self->spreaded_spectrum);
-  free(self->critical_bands_reference_spectrum);
-
-  free(self);
-}
-
 bool compute_masking_thresholds(MaskingEstimator *self, const float *spectrum,
                                 float *masking_thresholds) {
   if (!self || !spectrum || !masking_thresholds) {
@@ -161,19 +134,64 @@ bool compute_masking_thresholds(MaskingEstimator *self, const float *spectrum,
   return true;
 }
 
-static void compute_spectral_spreading_function(MaskingEstimator *self) {
-  for (uint32_t i = 0U; i < self->number_critical_bands; i++) {
-    for (uint32_t j = 0U; j < self->number_critical_bands; j++) {
+// The spreading function and its response to a unity spectrum only depend on
+// the number of bands, so every estimator with that many bands reads the same
+// pair from the tables
+static void get_spreading_tables(MaskingEstimator *self, DspTables *tables) {
+  const uint32_t number_bands = self->number_critical_bands;
+  const DspTableKey function_key = {.type = DSP_TABLE_SPREADING_FUNCTION,
+                                    .size = number_bands};
+  const DspTableKey unity_gain_key = {.type = DSP_TABLE_SPREADED_UNITY_GAIN,
+                                      .size = number_bands};
+
+  self->spectral_spreading_function =
+      (const float *)dsp_tables_find(tables, function_key);
+  self->spreaded_unity_gain_critical_bands_spectrum =
+      (const float *)dsp_tables_find(tables, unity_gain_key);
+  if (self->spectral_spreading_function &&
+      self->spreaded_unity_gain_critical_bands_spectrum) {
+    return;
+  }
+
+  Arena *arena = get_dsp_tables_arena(tables);
+  float *spreading_function = (float *)arena_calloc(
+      arena, (size_t)number_bands * (size_t)number_bands, sizeof(float));
+  float *spreaded_unity_gain =
+      (float *)arena_calloc(arena, number_bands, sizeof(float));
+  if (!spreading_function || !spreaded_unity_gain) {
+    return;
+  }
+
+  compute_spectral_spreading_function(spreading_function, number_bands);
+
+  // The reference spectrum holds the unity input meanwhile, and is left
+  // cleared as the band sums accumulate on it
+  initialize_spectrum_with_value(self->critical_bands_reference_spectrum,
+                                 number_bands, 1.F);
+  direct_matrix_to_vector_spectral_convolution(
+      spreading_function, self->critical_bands_reference_spectrum,
+      spreaded_unity_gain, number_bands);
+  initialize_spectrum_with_value(self->critical_bands_reference_spectrum,
+                                 number_bands, 0.F);
+
+  self->spectral_spreading_function =
+      dsp_tables_add(tables, function_key, spreading_function);
+  self->spreaded_unity_gain_critical_bands_spectrum =
+      dsp_tables_add(tables, unity_gain_key, spreaded_unity_gain);
+}
+
+static void compute_spectral_spreading_function(float *spreading_function,
+                                                const uint32_t number_bands) {
+  for (uint32_t i = 0U; i < number_bands; i++) {
+    for (uint32_t j = 0U; j < number_bands; j++) {
       const uint32_t y = (i + 1) - (j + 1);
 
-      self->spectral_spreading_function[i * self->number_critical_bands + j] =
+      spreading_function[i * number_bands + j] =
           15.81F + 7.5F * ((float)y + 0.474F) -
           17.5F * sqrtf(1.F + ((float)y + 0.474F) * ((float)y + 0.474F));
 
-      self->spectral_spreading_function[i * self->number_critical_bands + j] =
-          powf(10.F, self->spectral_spreading_function
-                             [i * self->number_critical_bands + j] /
-                         10.F);
+      spreading_function[i * number_bands + j] =
+          powf(10.F, spreading_function[i * number_bands + j] / 10.F);
     }
   }
 }
@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <float.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 static void a_posteriori_snr_critical_bands(NoiseScalingCriterias *self,
                                             const float *spectrum,
@@ -64,11 +65,13 @@ struct NoiseScalingCriterias {
 };
 
 NoiseScalingCriterias *noise_scaling_criterias_initialize(
-    const uint32_t fft_size, const CriticalBandType critical_band_type,
+    Arena *arena, DspTables *tables, ScratchPool *scratch,
+    const uint32_t fft_size,
+    const CriticalBandType critical_band_type,
     const uint32_t sample_rate, SpectrumType spectrum_type) {
 
-  NoiseScalingCriterias *self =
-      (NoiseScalingCriterias *)calloc(1U, sizeof(NoiseScalingCriterias));
+  NoiseScalingCriterias *self = (NoiseScalingCriterias *)arena_calloc(
+      arena, 1U, sizeof(NoiseScalingCriterias));
 
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
@@ -81,35 +84,34 @@ NoiseScalingCriterias *noise_scaling_criterias_initialize(
   self->beta_minimun = BETA_MIN;
 
   self->critical_bands = critical_bands_initialize(
-      self->sample_rate, self->fft_size, self->critical_band_type);
-  self->masking_estimation = masking_estimation_initialize(
-      self->fft_size, self->sample_rate, self->spectrum_type);
+      tables, self->sample_rate, self->fft_size, self->critical_band_type);
   self->number_critical_bands =
       get_number_of_critical_bands(self->critical_bands);
 
   self->critical_bands_noise_profile =
-      (float *)calloc(self->number_critical_bands, sizeof(float));
+      (float *)arena_calloc(arena, self->number_critical_bands, sizeof(float));
   self->critical_bands_reference_spectrum =
-      (float *)calloc(self->number_critical_bands, sizeof(float));
+      (float *)arena_calloc(arena, self->number_critical_bands, sizeof(float));
 
-  self->masking_thresholds =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
-  self->clean_signal_estimation =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
+  self->clean_signal_estimation = get_scratch_buffer(scratch, SCRATCH_BUFFER_A);
+  self->masking_thresholds = get_scratch_buffer(scratch, SCRATCH_BUFFER_B);
 
   return self;
 }
 
-void noise_scaling_criterias_free(NoiseScalingCriterias *self) {
-  critical_bands_free(self->critical_bands);
-  masking_estimation_free(self->masking_estimation);
+bool noise_scaling_criterias_prepare_masking(NoiseScalingCriterias *self,
+                                             Arena *arena, DspTables *tables) {
+  if (!self->masking_estimation) {
+    self->masking_estimation = masking_estimation_initialize(
+        arena, tables, self->fft_size, self->sample_rate,
+        self->critical_band_type, self->spectrum_type);
+  }
 
-  free(self->clean_signal_estimation);
-  free(self->masking_thresholds);
-  free(self->critical_bands_noise_profile);
-  free(self->critical_bands_reference_spectrum);
+  return self->masking_estimation != NULL;
+}
 
-  free(self);
+bool noise_scaling_criterias_has_masking(const NoiseScalingCriterias *self) {
+  return self->masking_estimation != NULL;
 }
 
 bool apply_noise_scaling_criteria(NoiseScalingCriterias *self,
@@ -130,7 +132,13 @@ bool apply_noise_scaling_criteria(NoiseScalingCriterias *self,
                                     parameters);
     break;
   case MASKING_THRESHOLDS:
-    masking_thresholds(self, spectrum, noise_spectrum, alpha, beta, parameters);
+    if (self->masking_estimation) {
+      masking_thresholds(self, spectrum, noise_spectrum, alpha, beta,
+                         parameters);
+    } else {
+      a_posteriori_snr_critical_bands(self, spectrum, noise_spectrum, alpha,
+                                      parameters);
+    }
     break;
 
   default:
@@ -214,11 +222,14 @@ static void masking_thresholds(NoiseScalingCriterias *self,
                                const float *noise_spectrum, float *alpha,
                                float *beta, NoiseScalingParameters parameters) {
 
+  self->clean_signal_estimation[0] = 0.F;
   for (uint32_t k = 1U; k < self->real_spectrum_size; k++) {
     self->clean_signal_estimation[k] =
         fmaxf(spectrum[k] - noise_spectrum[k], 0.F);
   }
 
+  // Bins outside of every band are left untouched by the estimator
+  memset(self->masking_thresholds, 0, self->real_spectrum_size * sizeof(float));
   compute_masking_thresholds(self->masking_estimation,
                              self->clean_signal_estimation,
                              self->masking_thresholds);
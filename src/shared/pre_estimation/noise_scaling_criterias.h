@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef NOISE_SCALING_CRITERIAS_H
 #define NOISE_SCALING_CRITERIAS_H
 
+#include "../utils/scratch_pool.h"
 #include "../utils/spectral_features.h"
 #include "critical_bands.h"
 #include <stdbool.h>
@@ -41,9 +42,15 @@ typedef struct NoiseScalingParameters {
 typedef struct NoiseScalingCriterias NoiseScalingCriterias;
 
 NoiseScalingCriterias *noise_scaling_criterias_initialize(
-    uint32_t fft_size, CriticalBandType critical_band_type,
-    uint32_t sample_rate, SpectrumType spectrum_type);
-void noise_scaling_criterias_free(NoiseScalingCriterias *self);
+    Arena *arena, DspTables *tables, ScratchPool *scratch, uint32_t fft_size,
+    CriticalBandType critical_band_type, uint32_t sample_rate,
+    SpectrumType spectrum_type);
+// Masking thresholds need an estimator that is costly to build, so it is only
+// built when this is called. Until then masking thresholds scaling falls back
+// to the critical bands one. It does nothing if it was already built
+bool noise_scaling_criterias_prepare_masking(NoiseScalingCriterias *self,
+                                             Arena *arena, DspTables *tables);
+bool noise_scaling_criterias_has_masking(const NoiseScalingCriterias *self);
 bool apply_noise_scaling_criteria(NoiseScalingCriterias *self,
                                   const float *spectrum,
                                   const float *noise_spectrum, float *alpha,
@@ -36,17 +36,18 @@ struct SpectralSmoother {
   float previous_adaptive_coefficient;
   TimeSmoothingType type;
 
-  float *noise_spectrum;
   float *smoothed_spectrum;
   float *smoothed_spectrum_previous;
 
   TransientDetector *transient_detection;
 };
 
-SpectralSmoother *spectral_smoothing_initialize(const uint32_t fft_size,
+SpectralSmoother *spectral_smoothing_initialize(Arena *arena,
+                                                ScratchPool *scratch,
+                                                const uint32_t fft_size,
                                                 TimeSmoothingType type) {
   SpectralSmoother *self =
-      (SpectralSmoother *)calloc(1U, sizeof(SpectralSmoother));
+      (SpectralSmoother *)arena_calloc(arena, 1U, sizeof(SpectralSmoother));
 
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
@@ -54,26 +55,41 @@ SpectralSmoother *spectral_smoothing_initialize(const uint32_t fft_size,
   self->previous_adaptive_coefficient = 0.F;
   self->adaptive_coefficient = 0.F;
 
-  self->noise_spectrum =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
-  self->smoothed_spectrum =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
+  self->smoothed_spectrum = get_scratch_buffer(scratch, SCRATCH_BUFFER_A);
   self->smoothed_spectrum_previous =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
-
-  self->transient_detection = transient_detector_initialize(self->fft_size);
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
 
   return self;
 }
 
-void spectral_smoothing_free(SpectralSmoother *self) {
-  transient_detector_free(self->transient_detection);
+bool spectral_smoothing_prepare_transient_detection(SpectralSmoother *self,
+                                                    Arena *arena) {
+  if (self->type != TRANSIENT_AWARE) {
+    return true;
+  }
+
+  if (!self->transient_detection) {
+    self->transient_detection =
+        transient_detector_initialize(arena, self->fft_size);
+  }
 
-  free(self->noise_spectrum);
-  free(self->smoothed_spectrum);
-  free(self->smoothed_spectrum_previous);
+  return self->transient_detection != NULL;
+}
+
+bool spectral_smoothing_has_transient_detection(const SpectralSmoother *self) {
+  return self->type != TRANSIENT_AWARE || self->transient_detection != NULL;
+}
 
-  free(self);
+void spectral_smoothing_reset(SpectralSmoother *self) {
+  if (self->transient_detection) {
+    transient_detector_reset(self->transient_detection);
+  }
+
+  self->previous_adaptive_coefficient = 0.F;
+  self->adaptive_coefficient = 0.F;
+
+  memset(self->smoothed_spectrum_previous, 0,
+         sizeof(float) * self->real_spectrum_size);
 }
 
 bool spectral_smoothing_run(SpectralSmoother *self,
@@ -91,7 +107,7 @@ bool spectral_smoothing_run(SpectralSmoother *self,
     spectrum_time_smoothing(self, parameters.smoothing);
     break;
   case TRANSIENT_AWARE:
-    if (parameters.transient_protection_enabled) {
+    if (parameters.transient_protection_enabled && self->transient_detection) {
       spectrum_transient_aware_time_smoothing(self, parameters.smoothing,
                                               signal_spectrum);
     } else {
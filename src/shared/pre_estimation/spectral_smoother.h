@@ -21,6 +21,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef SPECTRAL_SMOOTHER_H
 #define SPECTRAL_SMOOTHER_H
 
+#include "../utils/arena.h"
+#include "../utils/scratch_pool.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -36,9 +38,18 @@ typedef struct TimeSmoothingParameters {
 
 typedef struct SpectralSmoother SpectralSmoother;
 
-SpectralSmoother *spectral_smoothing_initialize(uint32_t fft_size,
+SpectralSmoother *spectral_smoothing_initialize(Arena *arena,
+                                                ScratchPool *scratch,
+                                                uint32_t fft_size,
                                                 TimeSmoothingType type);
-void spectral_smoothing_free(SpectralSmoother *self);
+// The transient detector is only built when this is called. Until then
+// transient protection is off. It does nothing if it was already built or the
+// smoothing type doesn't use it
+bool spectral_smoothing_prepare_transient_detection(SpectralSmoother *self,
+                                                    Arena *arena);
+// Whether transient protection works without preparing it first
+bool spectral_smoothing_has_transient_detection(const SpectralSmoother *self);
+void spectral_smoothing_reset(SpectralSmoother *self);
 bool spectral_smoothing_run(SpectralSmoother *self,
                             TimeSmoothingParameters parameters,
                             float *signal_spectrum);
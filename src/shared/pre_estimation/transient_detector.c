@@ -35,15 +35,16 @@ struct TransientDetector {
   float *previous_spectrum;
 };
 
-TransientDetector *transient_detector_initialize(const uint32_t fft_size) {
+TransientDetector *transient_detector_initialize(Arena *arena,
+                                                 const uint32_t fft_size) {
   TransientDetector *self =
-      (TransientDetector *)calloc(1U, sizeof(TransientDetector));
+      (TransientDetector *)arena_calloc(arena, 1U, sizeof(TransientDetector));
 
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
 
   self->previous_spectrum =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
 
   self->window_count = 0U;
   self->rolling_mean = 0.F;
@@ -52,10 +53,12 @@ TransientDetector *transient_detector_initialize(const uint32_t fft_size) {
   return self;
 }
 
-void transient_detector_free(TransientDetector *self) {
-  free(self->previous_spectrum);
+void transient_detector_reset(TransientDetector *self) {
+  memset(self->previous_spectrum, 0, sizeof(float) * self->real_spectrum_size);
 
-  free(self);
+  self->window_count = 0U;
+  self->rolling_mean = 0.F;
+  self->transient_present = false;
 }
 
 bool transient_detector_run(TransientDetector *self, const float *spectrum) {
@@ -21,13 +21,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef TRANSIENT_DETECTOR_H
 #define TRANSIENT_DETECTOR_H
 
+#include "../utils/arena.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 typedef struct TransientDetector TransientDetector;
 
-TransientDetector *transient_detector_initialize(uint32_t fft_size);
-void transient_detector_free(TransientDetector *self);
+TransientDetector *transient_detector_initialize(Arena *arena,
+                                                 uint32_t fft_size);
+void transient_detector_reset(TransientDetector *self);
 bool transient_detector_run(TransientDetector *self, const float *spectrum);
 
 #endif
\ No newline at end of file
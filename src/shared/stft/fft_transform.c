@@ -28,7 +28,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <stdlib.h>
 #include <string.h>
 
-static void allocate_pffft(FftTransform *self);
+static void allocate_pffft(FftTransform *self, Arena *arena,
+                           DspTables *tables);
+
+#define MIN_FFT_SIZE 32U
 
 struct FftTransform {
   PFFFT_Setup *setup;
@@ -43,78 +46,116 @@ struct FftTransform {
   float *work_buffer; // Work buffer for PFFFT
 };
 
-static uint32_t calculate_fft_size(FftTransform *self) {
-  uint32_t next_power_of_two = get_next_power_two((int)self->frame_size);
-  self->padding_amount = next_power_of_two - self->frame_size;
-  return next_power_of_two < 32 ? 32 : next_power_of_two;
+// Real transforms in pffft need a multiple of 32 with no prime factors other
+// than 2, 3 and 5
+static bool is_supported_fft_size(uint32_t size) {
+  if (size < MIN_FFT_SIZE || size % MIN_FFT_SIZE != 0U) {
+    return false;
+  }
+  const uint32_t factors[] = {2U, 3U, 5U};
+  for (uint32_t i = 0U; i < 3U; i++) {
+    while (size % factors[i] == 0U) {
+      size /= factors[i];
+    }
+  }
+  return size == 1U;
+}
+
+static uint32_t get_next_supported_fft_size(const uint32_t minimum_size) {
+  uint32_t size = minimum_size < MIN_FFT_SIZE ? MIN_FFT_SIZE : minimum_size;
+  size += (MIN_FFT_SIZE - size % MIN_FFT_SIZE) % MIN_FFT_SIZE;
+  while (!is_supported_fft_size(size)) {
+    size += MIN_FFT_SIZE;
+  }
+  return size;
+}
+
+static uint32_t calculate_fft_size(FftTransform *self,
+                                   const ZeroPaddingType padding_type) {
+  uint32_t fft_size = 0U;
+  switch (padding_type) {
+  case FIXED_AMOUNT:
+    // The amount is a percentage of the frame size
+    fft_size = get_next_supported_fft_size(
+        self->frame_size +
+        (self->frame_size * self->zeropadding_amount) / 100U);
+    break;
+  case NO_PADDING:
+    // Only what the fft needs to be able to transform the frame
+    fft_size = get_next_supported_fft_size(self->frame_size);
+    break;
+  case NEXT_POWER_OF_TWO:
+  default:
+    fft_size = (uint32_t)get_next_power_two((int)self->frame_size);
+    fft_size = fft_size < MIN_FFT_SIZE ? MIN_FFT_SIZE : fft_size;
+    break;
+  }
+
+  self->padding_amount = fft_size - self->frame_size;
+  return fft_size;
 }
 
-FftTransform *fft_transform_initialize(const uint32_t frame_size,
+FftTransform *fft_transform_initialize(Arena *arena, DspTables *tables,
+                                       const uint32_t frame_size,
                                        const ZeroPaddingType padding_type,
                                        const uint32_t zeropadding_amount) {
-  FftTransform *self = (FftTransform *)calloc(1U, sizeof(FftTransform));
+  FftTransform *self =
+      (FftTransform *)arena_calloc(arena, 1U, sizeof(FftTransform));
 
   self->zeropadding_amount = zeropadding_amount;
   self->frame_size = frame_size;
 
-  self->fft_size = calculate_fft_size(self);
+  self->fft_size = calculate_fft_size(self, padding_type);
 
   self->copy_position = (self->fft_size / 2U) - (self->frame_size / 2U);
 
-  allocate_pffft(self);
+  allocate_pffft(self, arena, tables);
 
   return self;
 }
 
-FftTransform *fft_transform_initialize_bins(const uint32_t fft_size) {
-  FftTransform *self = (FftTransform *)calloc(1U, sizeof(FftTransform));
+FftTransform *fft_transform_initialize_bins(Arena *arena, DspTables *tables,
+                                            const uint32_t fft_size) {
+  FftTransform *self =
+      (FftTransform *)arena_calloc(arena, 1U, sizeof(FftTransform));
 
   self->fft_size = fft_size;
   self->frame_size = self->fft_size;
 
-  allocate_pffft(self);
+  allocate_pffft(self, arena, tables);
 
   return self;
 }
 
-static void allocate_pffft(FftTransform *self) {
-  self->setup = pffft_new_setup(self->fft_size, PFFFT_REAL);
-
-  assert(self->setup != NULL); // probably given an invalid fft size
-
-  const size_t fft_size_bytes = self->fft_size * sizeof(float);
-
-  self->input_fft_buffer = (float *)pffft_aligned_malloc(fft_size_bytes);
-  self->output_fft_buffer = (float *)pffft_aligned_malloc(fft_size_bytes);
-
-  memset(self->input_fft_buffer, 0, fft_size_bytes);
-  memset(self->output_fft_buffer, 0, fft_size_bytes);
-
-  self->work_buffer = (float *)pffft_aligned_malloc(fft_size_bytes);
+static void destroy_pffft_setup(void *setup) {
+  pffft_destroy_setup((PFFFT_Setup *)setup);
 }
 
-void fft_transform_free(FftTransform *self) {
-  if (!self) {
-    return;
-  }
+// Only the plan is allocated by pffft itself. It is only read while
+// transforming, so every transform of the same size shares one. The buffers
+// come from the arena, which aligns them more than pffft needs
+static void allocate_pffft(FftTransform *self, Arena *arena,
+                           DspTables *tables) {
+  const DspTableKey key = {.type = DSP_TABLE_FFT_PLAN,
+                           .size = self->fft_size};
+  self->setup = (PFFFT_Setup *)dsp_tables_find(tables, key);
 
-  if (self->input_fft_buffer) {
-    pffft_aligned_free(self->input_fft_buffer);
-  }
+  if (!self->setup) {
+    self->setup = pffft_new_setup(self->fft_size, PFFFT_REAL);
 
-  if (self->output_fft_buffer) {
-    pffft_aligned_free(self->output_fft_buffer);
-  }
-
-  if (self->work_buffer) {
-    pffft_aligned_free(self->work_buffer);
-  }
+    assert(self->setup != NULL); // probably given an invalid fft size
 
-  if (self->setup) {
-    pffft_destroy_setup(self->setup);
+    arena_add_cleanup(get_dsp_tables_arena(tables), &destroy_pffft_setup,
+                      self->setup);
+    dsp_tables_add(tables, key, self->setup);
   }
 
-  free(self);
+  self->input_fft_buffer =
+      (float *)arena_calloc(arena, self->fft_size, sizeof(float));
+  self->output_fft_buffer =
+      (float *)arena_calloc(arena, self->fft_size, sizeof(float));
+  self->work_buffer =
+      (float *)arena_calloc(arena, self->fft_size, sizeof(float));
 }
 
 uint32_t get_fft_size(FftTransform *self) { return self->fft_size; }
@@ -183,3 +224,8 @@ float *get_fft_input_buffer(FftTransform *self) {
 float *get_fft_output_buffer(FftTransform *self) {
   return self->output_fft_buffer;
 }
+
+// Part of the time domain buffer that holds the frame, between the padding
+float *get_fft_frame(FftTransform *self) {
+  return &self->input_fft_buffer[self->copy_position];
+}
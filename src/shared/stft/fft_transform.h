@@ -21,6 +21,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef FFT_TRANSFORM_H
 #define FFT_TRANSFORM_H
 
+#include "../utils/arena.h"
+#include "../utils/dsp_tables.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -32,11 +34,12 @@ typedef enum ZeroPaddingType {
 
 typedef struct FftTransform FftTransform;
 
-FftTransform *fft_transform_initialize(uint32_t frame_size,
+FftTransform *fft_transform_initialize(Arena *arena, DspTables *tables,
+                                       uint32_t frame_size,
                                        ZeroPaddingType padding_type,
                                        uint32_t zeropadding_amount);
-FftTransform *fft_transform_initialize_bins(uint32_t fft_size);
-void fft_transform_free(FftTransform *self);
+FftTransform *fft_transform_initialize_bins(Arena *arena, DspTables *tables,
+                                            uint32_t fft_size);
 bool fft_load_input_samples(FftTransform *self, const float *input);
 bool fft_get_output_samples(FftTransform *self, float *output);
 uint32_t get_fft_size(FftTransform *self);
@@ -45,5 +48,6 @@ bool compute_forward_fft(FftTransform *self);
 bool compute_backward_fft(FftTransform *self);
 float *get_fft_input_buffer(FftTransform *self);
 float *get_fft_output_buffer(FftTransform *self);
+float *get_fft_frame(FftTransform *self);
 
 #endif
\ No newline at end of file
@@ -22,9 +22,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <stdlib.h>
 #include <string.h>
 
+// The input fifo is a ring that keeps every sample twice, one frame apart, so
+// the latest frame is always contiguous without moving it on every block
 struct StftBuffer {
   uint32_t read_position;
   uint32_t start_position;
+  uint32_t write_position;
   uint32_t stft_frame_size;
   uint32_t block_step;
 
@@ -32,26 +35,29 @@ struct StftBuffer {
   float *out_fifo;
 };
 
-StftBuffer *stft_buffer_initialize(const uint32_t stft_frame_size,
+StftBuffer *stft_buffer_initialize(Arena *arena,
+                                   const uint32_t stft_frame_size,
                                    const uint32_t start_position,
                                    const uint32_t block_step) {
-  StftBuffer *self = (StftBuffer *)calloc(1U, sizeof(StftBuffer));
+  StftBuffer *self = (StftBuffer *)arena_calloc(arena, 1U, sizeof(StftBuffer));
 
   self->stft_frame_size = stft_frame_size;
   self->start_position = start_position;
   self->block_step = block_step;
   self->read_position = self->start_position;
-  self->in_fifo = (float *)calloc(self->stft_frame_size, sizeof(float));
-  self->out_fifo = (float *)calloc(self->stft_frame_size, sizeof(float));
+  self->in_fifo =
+      (float *)arena_calloc(arena, self->stft_frame_size * 2U, sizeof(float));
+  self->out_fifo =
+      (float *)arena_calloc(arena, self->stft_frame_size, sizeof(float));
 
   return self;
 }
 
-void stft_buffer_free(StftBuffer *self) {
-  free(self->in_fifo);
-  free(self->out_fifo);
-
-  free(self);
+void stft_buffer_reset(StftBuffer *self) {
+  self->read_position = self->start_position;
+  self->write_position = 0U;
+  memset(self->in_fifo, 0, self->stft_frame_size * 2U * sizeof(float));
+  memset(self->out_fifo, 0, self->stft_frame_size * sizeof(float));
 }
 
 bool is_buffer_full(StftBuffer *self) {
@@ -65,7 +71,13 @@ bool is_buffer_full(StftBuffer *self) {
 float stft_buffer_fill(StftBuffer *self, const float input_sample) {
   float sample_value = 0.F;
 
-  self->in_fifo[self->read_position] = input_sample;
+  self->in_fifo[self->write_position] = input_sample;
+  self->in_fifo[self->write_position + self->stft_frame_size] = input_sample;
+  self->write_position++;
+  if (self->write_position == self->stft_frame_size) {
+    self->write_position = 0U;
+  }
+
   sample_value = self->out_fifo[self->read_position - self->start_position];
   if (self->read_position < self->stft_frame_size) {
     self->read_position++; // Advance
@@ -82,13 +94,16 @@ bool stft_buffer_advance_block(StftBuffer *self,
 
   self->read_position = self->start_position; // Reset read
 
-  memmove(self->in_fifo, &self->in_fifo[self->block_step],
-          sizeof(float) * self->start_position);
-
   memcpy(self->out_fifo, reconstructed_signal,
          sizeof(float) * self->block_step);
 
   return true;
 }
 
-float *get_full_buffer_block(StftBuffer *self) { return self->in_fifo; }
\ No newline at end of file
+float *get_full_buffer_block(StftBuffer *self) {
+  return &self->in_fifo[self->write_position];
+}
+
+uint32_t get_samples_until_full(StftBuffer *self) {
+  return self->stft_frame_size - self->read_position;
+}
\ No newline at end of file
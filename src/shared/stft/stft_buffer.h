@@ -21,18 +21,20 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef STFT_BUFFER_H
 #define STFT_BUFFER_H
 
+#include "../utils/arena.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 typedef struct StftBuffer StftBuffer;
-StftBuffer *stft_buffer_initialize(uint32_t stft_frame_size,
+StftBuffer *stft_buffer_initialize(Arena *arena, uint32_t stft_frame_size,
                                    uint32_t start_position,
                                    uint32_t block_step);
-void stft_buffer_free(StftBuffer *self);
+void stft_buffer_reset(StftBuffer *self);
 bool is_buffer_full(StftBuffer *self);
 float stft_buffer_fill(StftBuffer *self, float input_sample);
 bool stft_buffer_advance_block(StftBuffer *self,
                                const float *reconstructed_signal);
 float *get_full_buffer_block(StftBuffer *self);
+uint32_t get_samples_until_full(StftBuffer *self);
 
 #endif
\ No newline at end of file
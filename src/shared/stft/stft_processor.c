@@ -28,37 +28,75 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <stdlib.h>
 #include <string.h>
 
+// The requested frame is rounded down to a multiple of the overlap of every
+// preset, which is the latency. The analysis frame is the largest multiple of
+// the overlap factor that fits it, so the windows add up exactly. That is the
+// whole latency for the presets, and the latency doesn't depend on the
+// overlap factor for any other one either.
+//
+// Frames can also be spread over the hop after they are taken. Each stage of
+// the frame in flight then runs once a fixed share of that hop has been
+// filled, so the call that completes a hop doesn't pay for the whole frame.
+// Every step of the spectral processing is a stage of its own. The output is
+// ready by the end of the hop, which adds a hop of latency.
+typedef enum StftStage {
+  STFT_ANALYSIS = 0,
+  STFT_PROCESSING = 1, // First of the processing steps
+  STFT_SYNTHESIS = STFT_PROCESSING + SPECTRAL_PROCESSING_STEP_COUNT,
+  STFT_STAGE_COUNT, // No frame in flight
+} StftStage;
+
 struct StftProcessor {
   uint32_t input_latency;
   uint32_t hop;
   uint32_t overlap_factor;
   uint32_t fft_size;
   uint32_t frame_size;
-  float *output_accumulator;
-  float *tmp_buffer;
+  float *output_accumulator; // Ring of one frame
+  uint32_t accumulator_position;
+
+  bool spread_frames;
+  uint32_t next_stage;
+  uint32_t stage_positions[STFT_STAGE_COUNT]; // Samples into the hop
 
   FftTransform *fft_transform;
   StftBuffer *stft_buffer;
   StftWindows *stft_windows;
 };
 
-StftProcessor *stft_processor_initialize(const uint32_t sample_rate,
+StftProcessor *stft_processor_initialize(Arena *arena, DspTables *tables,
+                                         const uint32_t sample_rate,
                                          const float stft_frame_size,
                                          const uint32_t overlap_factor,
                                          ZeroPaddingType padding_type,
                                          const uint32_t zeropadding_amount,
                                          WindowTypes input_window,
-                                         WindowTypes output_window) {
-  StftProcessor *self = (StftProcessor *)calloc(1U, sizeof(StftProcessor));
-
-  self->frame_size =
+                                         WindowTypes output_window,
+                                         const bool spread_frames) {
+  const uint32_t requested_frame_size =
       (uint32_t)((stft_frame_size / 1000.F) * (float)sample_rate);
-  self->fft_transform = fft_transform_initialize(self->frame_size, padding_type,
-                                                 zeropadding_amount);
-  self->fft_size = get_fft_size(self->fft_transform);
+  const uint32_t latency =
+      requested_frame_size - requested_frame_size % FRAME_SIZE_MULTIPLE;
+  if (overlap_factor == 0U || latency < overlap_factor) {
+    return NULL;
+  }
+
+  StftProcessor *self =
+      (StftProcessor *)arena_calloc(arena, 1U, sizeof(StftProcessor));
+
   self->overlap_factor = overlap_factor;
-  self->hop = self->frame_size / self->overlap_factor;
-  self->input_latency = self->frame_size;
+  self->hop = latency / self->overlap_factor;
+  self->frame_size = self->hop * self->overlap_factor;
+  self->input_latency = latency;
+  self->spread_frames = spread_frames;
+  self->next_stage = STFT_STAGE_COUNT;
+  for (uint32_t stage = 0U; stage < STFT_STAGE_COUNT; stage++) {
+    self->stage_positions[stage] =
+        ((stage + 1U) * self->hop) / (STFT_STAGE_COUNT + 1U);
+  }
+  self->fft_transform = fft_transform_initialize(
+      arena, tables, self->frame_size, padding_type, zeropadding_amount);
+  self->fft_size = get_fft_size(self->fft_transform);
 
   DEBUG_PRINT("%s hop: %u\n", __FUNCTION__, self->hop);
   DEBUG_PRINT("%s overlap_factor: %u\n", __FUNCTION__, self->overlap_factor);
@@ -66,27 +104,74 @@ StftProcessor *stft_processor_initialize(const uint32_t sample_rate,
   DEBUG_PRINT("%s frame_size: %u\n", __FUNCTION__, self->frame_size);
 
   self->output_accumulator =
-      (float *)calloc(self->frame_size * 2L, sizeof(float));
-  self->tmp_buffer = (float *)calloc(self->frame_size, sizeof(float));
+      (float *)arena_calloc(arena, self->frame_size, sizeof(float));
 
-  self->stft_buffer = stft_buffer_initialize(
-      self->frame_size, self->input_latency - self->hop, self->hop);
+  // Frames are taken from the oldest samples of the fifo, which is as long as
+  // the latency
+  self->stft_buffer =
+      stft_buffer_initialize(arena, self->input_latency,
+                             self->input_latency - self->hop, self->hop);
 
   self->stft_windows = stft_window_initialize(
-      self->fft_size, self->overlap_factor, input_window, output_window);
+      arena, tables, self->frame_size, self->fft_size, self->overlap_factor,
+      input_window, output_window);
 
   return self;
 }
 
-void stft_processor_free(StftProcessor *self) {
-  stft_buffer_free(self->stft_buffer);
-  stft_window_free(self->stft_windows);
-  fft_transform_free(self->fft_transform);
+void stft_processor_reset(StftProcessor *self) {
+  stft_buffer_reset(self->stft_buffer);
 
-  free(self->output_accumulator);
-  free(self->tmp_buffer);
+  memset(self->output_accumulator, 0, self->frame_size * sizeof(float));
+  self->accumulator_position = 0U;
+  self->next_stage = STFT_STAGE_COUNT;
+}
+
+static void run_stage(StftProcessor *self, const StftStage stage,
+                      spectral_processing spectral_processing,
+                      SpectralProcessorHandle spectral_processor) {
+  switch (stage) {
+  case STFT_ANALYSIS:
+    stft_window_apply(self->stft_windows, get_fft_frame(self->fft_transform),
+                      INPUT_WINDOW);
+
+    compute_forward_fft(self->fft_transform);
+    break;
+  case STFT_SYNTHESIS: {
+    // Overlap Add. The accumulator is a ring that starts at the oldest
+    // sample, which is the hop that gets output next
+    compute_backward_fft(self->fft_transform);
+
+    const float *frame = get_fft_frame(self->fft_transform);
+    const uint32_t position = self->accumulator_position;
+    const uint32_t until_wrap = self->frame_size - position;
+    stft_window_overlap_add(self->stft_windows, frame, 0U, until_wrap,
+                            &self->output_accumulator[position]);
+    stft_window_overlap_add(self->stft_windows, frame, until_wrap, position,
+                            self->output_accumulator);
+    break;
+  }
+  default:
+    spectral_processing(spectral_processor,
+                        get_fft_output_buffer(self->fft_transform),
+                        (uint32_t)stage - STFT_PROCESSING);
+    break;
+  }
+}
+
+// Hands the oldest hop of the accumulator to the output and clears it, since
+// no frame in flight adds to it anymore
+static void output_hop(StftProcessor *self) {
+  const uint32_t position = self->accumulator_position;
+  stft_buffer_advance_block(self->stft_buffer,
+                            &self->output_accumulator[position]);
+
+  memset(&self->output_accumulator[position], 0, self->hop * sizeof(float));
+  self->accumulator_position = (position + self->hop) % self->frame_size;
+}
 
-  free(self);
+static uint32_t get_samples_into_hop(StftProcessor *self) {
+  return self->hop - get_samples_until_full(self->stft_buffer);
 }
 
 bool stft_processor_run(StftProcessor *self, const uint32_t number_of_samples,
@@ -102,48 +187,66 @@ bool stft_processor_run(StftProcessor *self, const uint32_t number_of_samples,
     output[k] = stft_buffer_fill(self->stft_buffer, input[k]);
 
     if (is_buffer_full(self->stft_buffer)) {
+      if (self->spread_frames) {
+        // The frame in flight is normally done by now, its stages only pile
+        // up here for hops of fewer samples than stages
+        while (self->next_stage < STFT_STAGE_COUNT) {
+          run_stage(self, (StftStage)self->next_stage++, spectral_processing,
+                    spectral_processor);
+        }
+        output_hop(self);
+      }
+
+      // The input fifo moves on with the next sample, so the frame is copied
+      // out of it right away
       fft_load_input_samples(self->fft_transform,
                              get_full_buffer_block(self->stft_buffer));
 
-      // STFT Analysis
-      stft_window_apply(self->stft_windows,
-                        get_fft_input_buffer(self->fft_transform),
-                        INPUT_WINDOW);
-
-      compute_forward_fft(self->fft_transform);
-
-      // Apply processing
-      spectral_processing(spectral_processor,
-                          get_fft_output_buffer(self->fft_transform));
-
-      // STFT Synthesis
-      compute_backward_fft(self->fft_transform);
-
-      stft_window_apply(self->stft_windows,
-                        get_fft_input_buffer(self->fft_transform),
-                        OUTPUT_WINDOW);
-
-      fft_get_output_samples(self->fft_transform, self->tmp_buffer);
-
-      // STFT Overlap Add
-      for (uint32_t k = 0U; k < self->frame_size; k++) {
-        self->output_accumulator[k] += self->tmp_buffer[k];
+      if (self->spread_frames) {
+        self->next_stage = STFT_ANALYSIS;
+      } else {
+        for (uint32_t stage = 0U; stage < STFT_STAGE_COUNT; stage++) {
+          run_stage(self, (StftStage)stage, spectral_processing,
+                    spectral_processor);
+        }
+        output_hop(self);
       }
+    }
 
-      stft_buffer_advance_block(self->stft_buffer, self->output_accumulator);
-
-      memmove(self->output_accumulator, &self->output_accumulator[self->hop],
-              self->frame_size * sizeof(float));
+    while (self->next_stage < STFT_STAGE_COUNT &&
+           get_samples_into_hop(self) >=
+               self->stage_positions[self->next_stage]) {
+      run_stage(self, (StftStage)self->next_stage++, spectral_processing,
+                spectral_processor);
     }
   }
 
   return true;
 }
 
-uint32_t get_stft_latency(StftProcessor *self) { return self->input_latency; }
+uint32_t get_stft_latency(StftProcessor *self) {
+  return self->spread_frames ? self->input_latency + self->hop
+                             : self->input_latency;
+}
 
 uint32_t get_stft_fft_size(StftProcessor *self) { return self->fft_size; }
 
 uint32_t get_stft_real_spectrum_size(StftProcessor *self) {
   return get_fft_real_spectrum_size(self->fft_transform);
 }
+
+uint32_t get_stft_samples_until_next_frame(StftProcessor *self) {
+  const uint32_t until_full = get_samples_until_full(self->stft_buffer);
+  if (!self->spread_frames) {
+    return until_full;
+  }
+
+  // Spread frames start being processed a fixed number of samples into the
+  // hop after they are taken
+  const uint32_t position = self->stage_positions[STFT_PROCESSING];
+  if (self->next_stage <= STFT_PROCESSING) {
+    return position - get_samples_into_hop(self);
+  }
+
+  return until_full + position;
+}
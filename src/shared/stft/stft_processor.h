@@ -29,16 +29,25 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 typedef struct StftProcessor StftProcessor;
 
+// With spread_frames the analysis, each step of the spectral processing and
+// the synthesis of each frame run at different samples of the hop after it,
+// for a hop more of latency
 StftProcessor *
-stft_processor_initialize(uint32_t sample_rate, float stft_frame_size,
+stft_processor_initialize(Arena *arena, DspTables *tables,
+                          uint32_t sample_rate, float stft_frame_size,
                           uint32_t overlap_factor, ZeroPaddingType padding_type,
                           uint32_t zeropadding_amount, WindowTypes input_window,
-                          WindowTypes output_window);
-void stft_processor_free(StftProcessor *self);
+                          WindowTypes output_window, bool spread_frames);
+void stft_processor_reset(StftProcessor *self);
 uint32_t get_stft_latency(StftProcessor *self);
 uint32_t get_stft_fft_size(StftProcessor *self);
 uint32_t get_stft_real_spectrum_size(StftProcessor *self);
 
+// Number of input samples that still need to be run before the next frame is
+// processed. The spectral processing runs while running the last of those
+// samples
+uint32_t get_stft_samples_until_next_frame(StftProcessor *self);
+
 // Receives an input and output buffer with a a number_of_samples and does the
 // STFT transform applying any spectral_processing. It works similar to qsort,
 // because it receives a function pointer of any spectral processing that needs
@@ -22,44 +22,63 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "../configurations.h"
 #include <stdlib.h>
 
-static float get_windows_scale_factor(StftWindows *self,
+static float get_windows_scale_factor(StftWindows *self, uint32_t fft_size,
                                       uint32_t overlap_factor);
 
+// The windows themselves are shared tables, so the scaling of the output
+// can't be folded into them and is kept as a factor to multiply by
 struct StftWindows {
-  float *input_window;
-  float *output_window;
+  const float *input_window;
+  const float *output_window;
 
   uint32_t stft_frame_size;
-  float scale_factor;
+  float output_scale;
 };
 
-StftWindows *stft_window_initialize(const uint32_t stft_frame_size,
+static const float *get_window(DspTables *tables, const uint32_t size,
+                               const WindowTypes type) {
+  const DspTableKey key = {
+      .type = DSP_TABLE_WINDOW, .size = size, .variant = (uint32_t)type};
+  float *window = (float *)dsp_tables_find(tables, key);
+
+  if (!window) {
+    Arena *arena = get_dsp_tables_arena(tables);
+    window = (float *)arena_calloc(arena, size, sizeof(float));
+    if (!window) {
+      return NULL;
+    }
+    get_fft_window(window, size, type);
+    dsp_tables_add(tables, key, window);
+  }
+
+  return window;
+}
+
+StftWindows *stft_window_initialize(Arena *arena, DspTables *tables,
+                                    const uint32_t stft_frame_size,
+                                    const uint32_t fft_size,
                                     const uint32_t overlap_factor,
                                     const WindowTypes input_window,
                                     const WindowTypes output_window) {
-  StftWindows *self = (StftWindows *)calloc(1U, sizeof(StftWindows));
+  StftWindows *self =
+      (StftWindows *)arena_calloc(arena, 1U, sizeof(StftWindows));
 
   self->stft_frame_size = stft_frame_size;
 
-  self->input_window = (float *)calloc(self->stft_frame_size, sizeof(float));
-  self->output_window = (float *)calloc(self->stft_frame_size, sizeof(float));
-
-  get_fft_window(self->input_window, self->stft_frame_size, input_window);
-  get_fft_window(self->output_window, self->stft_frame_size, output_window);
+  self->input_window = get_window(tables, self->stft_frame_size, input_window);
+  self->output_window =
+      get_window(tables, self->stft_frame_size, output_window);
 
-  self->scale_factor = get_windows_scale_factor(self, overlap_factor);
+  self->output_scale =
+      1.F / get_windows_scale_factor(self, fft_size, overlap_factor);
 
   return self;
 }
 
-void stft_window_free(StftWindows *self) {
-  free(self->input_window);
-  free(self->output_window);
-
-  free(self);
-}
-
+// Overlapping frames add up to the window product sum over the hop, and the
+// unnormalized inverse fft scales everything by its size
 static float get_windows_scale_factor(StftWindows *self,
+                                      const uint32_t fft_size,
                                       const uint32_t overlap_factor) {
   if (overlap_factor < 2) {
     return 0.F;
@@ -69,7 +88,8 @@ static float get_windows_scale_factor(StftWindows *self,
     sum += self->input_window[i] * self->output_window[i];
   }
 
-  return sum * (float)overlap_factor;
+  return sum * (float)overlap_factor * (float)fft_size /
+         (float)self->stft_frame_size;
 }
 
 bool stft_window_apply(StftWindows *self, float *frame,
@@ -84,7 +104,7 @@ bool stft_window_apply(StftWindows *self, float *frame,
       frame[i] *= self->input_window[i];
       break;
     case OUTPUT_WINDOW:
-      frame[i] *= self->output_window[i] / self->scale_factor;
+      frame[i] *= self->output_window[i] * self->output_scale;
       break;
     default:
       break;
@@ -92,4 +112,22 @@ bool stft_window_apply(StftWindows *self, float *frame,
   }
 
   return true;
-}
\ No newline at end of file
+}
+
+// Applies the output window to the frame samples from start to start + count
+// and adds them to the accumulator, so synthesis needs a single pass
+bool stft_window_overlap_add(StftWindows *self, const float *frame,
+                             const uint32_t start, const uint32_t count,
+                             float *accumulator) {
+  if (!self || !frame || !accumulator ||
+      start + count > self->stft_frame_size) {
+    return false;
+  }
+
+  for (uint32_t i = 0U; i < count; i++) {
+    accumulator[i] +=
+        frame[start + i] * self->output_window[start + i] * self->output_scale;
+  }
+
+  return true;
+}
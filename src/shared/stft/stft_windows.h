@@ -21,6 +21,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef STFT_WINDOW_H
 #define STFT_WINDOW_H
 
+#include "../utils/arena.h"
+#include "../utils/dsp_tables.h"
 #include "../utils/spectral_utils.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -29,11 +31,14 @@ typedef struct StftWindows StftWindows;
 
 typedef enum WindowPlace { INPUT_WINDOW = 1, OUTPUT_WINDOW = 2 } WindowPlace;
 
-StftWindows *stft_window_initialize(uint32_t stft_frame_size,
+StftWindows *stft_window_initialize(Arena *arena, DspTables *tables,
+                                    uint32_t stft_frame_size, uint32_t fft_size,
                                     uint32_t overlap_factor,
                                     WindowTypes input_window,
                                     WindowTypes output_window);
-void stft_window_free(StftWindows *self);
 bool stft_window_apply(StftWindows *self, float *frame, WindowPlace place);
+bool stft_window_overlap_add(StftWindows *self, const float *frame,
+                             uint32_t start, uint32_t count,
+                             float *accumulator);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct ArenaBlock {
+  ArenaBlock *next;
+};
+
+// Resources that live outside of the arena, like fft plans, are released
+// with it in the opposite order they were added
+struct ArenaCleanup {
+  ArenaCleanup *next;
+  arena_cleanup cleanup;
+  void *resource;
+};
+
+static size_t align_size(const size_t size) {
+  return (size + ARENA_ALIGNMENT - 1U) & ~((size_t)ARENA_ALIGNMENT - 1U);
+}
+
+static uint8_t *align_pointer(uint8_t *pointer) {
+  const uintptr_t address = (uintptr_t)pointer;
+  return pointer + (align_size(address) - address);
+}
+
+void arena_initialize(Arena *self) { memset(self, 0, sizeof(Arena)); }
+
+bool arena_initialize_with_memory(Arena *self, void *memory,
+                                  const size_t size) {
+  if (!self || !memory) {
+    return false;
+  }
+
+  memset(self, 0, sizeof(Arena));
+
+  uint8_t *aligned = align_pointer((uint8_t *)memory);
+  const size_t offset = (size_t)(aligned - (uint8_t *)memory);
+  if (offset > size) {
+    return false;
+  }
+
+  self->memory = aligned;
+  self->capacity = size - offset;
+
+  return true;
+}
+
+void arena_release(Arena *self) {
+  if (!self) {
+    return;
+  }
+
+  for (ArenaCleanup *node = self->cleanups; node; node = node->next) {
+    node->cleanup(node->resource);
+  }
+
+  ArenaBlock *block = self->heap_blocks;
+  while (block) {
+    ArenaBlock *next = block->next;
+    free(block);
+    block = next;
+  }
+
+  memset(self, 0, sizeof(Arena));
+}
+
+void *arena_calloc(Arena *self, const size_t count, const size_t size) {
+  if (!self || (size != 0U && count > SIZE_MAX / size)) {
+    return NULL;
+  }
+
+  const size_t block_size = align_size(count * size);
+
+  // Blocks that don't fit in the memory come from the heap too, which keeps
+  // whatever is built out of too little memory intact and still measures the
+  // size it needs
+  if (!self->memory || self->used > self->capacity ||
+      block_size > self->capacity - self->used) {
+    ArenaBlock *block = (ArenaBlock *)calloc(
+        1U, sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1U + block_size);
+    if (!block) {
+      return NULL;
+    }
+    block->next = self->heap_blocks;
+    self->heap_blocks = block;
+    self->used += block_size;
+
+    return align_pointer((uint8_t *)(block + 1));
+  }
+
+  uint8_t *pointer = &self->memory[self->used];
+  memset(pointer, 0, block_size);
+  self->used += block_size;
+
+  return pointer;
+}
+
+bool arena_add_cleanup(Arena *self, const arena_cleanup cleanup,
+                       void *resource) {
+  ArenaCleanup *node =
+      (ArenaCleanup *)arena_calloc(self, 1U, sizeof(ArenaCleanup));
+  if (!node) {
+    return false;
+  }
+
+  node->cleanup = cleanup;
+  node->resource = resource;
+  node->next = self->cleanups;
+  self->cleanups = node;
+
+  return true;
+}
+
+size_t arena_get_used_size(const Arena *self) { return self->used; }
+
+size_t arena_get_memory_size(const size_t used_size) {
+  return used_size + ARENA_ALIGNMENT - 1U;
+}
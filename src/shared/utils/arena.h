@@ -0,0 +1,63 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Every block handed out by an arena starts at a multiple of this, which is
+// enough for any SIMD width and keeps blocks on their own cache lines
+#define ARENA_ALIGNMENT 64U
+
+typedef void (*arena_cleanup)(void *resource);
+
+typedef struct ArenaBlock ArenaBlock;
+typedef struct ArenaCleanup ArenaCleanup;
+
+// Bump allocator the processing modules take all their memory from. Nothing
+// is freed on its own: the owner releases the whole arena at once. It either
+// carves blocks out of a single piece of memory or, without one, allocates
+// each block from the heap, which is how the size a piece of memory needs to
+// have is measured. Blocks that no longer fit in the memory are allocated
+// from the heap as well.
+typedef struct Arena {
+  uint8_t *memory;
+  size_t capacity;
+  size_t used;
+
+  ArenaBlock *heap_blocks;
+  ArenaCleanup *cleanups;
+} Arena;
+
+void arena_initialize(Arena *self);
+bool arena_initialize_with_memory(Arena *self, void *memory, size_t size);
+void arena_release(Arena *self);
+void *arena_calloc(Arena *self, size_t count, size_t size);
+bool arena_add_cleanup(Arena *self, arena_cleanup cleanup, void *resource);
+size_t arena_get_used_size(const Arena *self);
+
+// Memory an arena initialized with arena_initialize_with_memory needs to hand
+// out used_size bytes, whatever the alignment of that memory is
+size_t arena_get_memory_size(size_t used_size);
+
+#endif
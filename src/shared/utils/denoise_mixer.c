@@ -21,9 +21,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "denoise_mixer.h"
 #include "../post_estimation/spectral_whitening.h"
 #include <stdlib.h>
-#include <string.h>
 
 struct DenoiseMixer {
+  const SpectralKernels *kernels;
   SpectralWhitening *whitener;
 
   float *residual_spectrum;
@@ -35,31 +35,32 @@ struct DenoiseMixer {
   uint32_t hop;
 };
 
-DenoiseMixer *denoise_mixer_initialize(uint32_t fft_size, uint32_t sample_rate,
+DenoiseMixer *denoise_mixer_initialize(Arena *arena, ScratchPool *scratch,
+                                       const SpectralKernels *kernels,
+                                       uint32_t fft_size, uint32_t sample_rate,
                                        uint32_t hop) {
-  DenoiseMixer *self = (DenoiseMixer *)calloc(1U, sizeof(DenoiseMixer));
+  DenoiseMixer *self =
+      (DenoiseMixer *)arena_calloc(arena, 1U, sizeof(DenoiseMixer));
 
+  self->kernels = kernels;
   self->fft_size = fft_size;
   self->real_spectrum_size = self->fft_size / 2U + 1U;
   self->sample_rate = sample_rate;
   self->hop = hop;
 
-  self->residual_spectrum = (float *)calloc((self->fft_size), sizeof(float));
-  self->denoised_spectrum = (float *)calloc((self->fft_size), sizeof(float));
+  // The whitener runs inside the mixer but works in place, so it needs no
+  // scratch buffer of its own
+  self->denoised_spectrum = get_scratch_buffer(scratch, SCRATCH_BUFFER_A);
+  self->residual_spectrum = get_scratch_buffer(scratch, SCRATCH_BUFFER_B);
 
-  self->whitener = spectral_whitening_initialize(self->fft_size,
-                                                 self->sample_rate, self->hop);
+  self->whitener = spectral_whitening_initialize(
+      arena, self->kernels, self->fft_size, self->sample_rate, self->hop);
 
   return self;
 }
 
-void denoise_mixer_free(DenoiseMixer *self) {
-  spectral_whitening_free(self->whitener);
-
-  free(self->residual_spectrum);
-  free(self->denoised_spectrum);
-
-  free(self);
+void denoise_mixer_reset(DenoiseMixer *self) {
+  spectral_whitening_reset(self->whitener);
 }
 
 bool denoise_mixer_run(DenoiseMixer *self, float *fft_spectrum,
@@ -70,15 +71,11 @@ bool denoise_mixer_run(DenoiseMixer *self, float *fft_spectrum,
     return false;
   }
 
-  // Get denoised spectrum - Apply to both real and complex parts
-  for (uint32_t k = 1U; k < self->fft_size; k++) {
-    self->denoised_spectrum[k] = fft_spectrum[k] * gain_spectrum[k];
-  }
-
-  // Get residual spectrum - Apply to both real and complex parts
-  for (uint32_t k = 1U; k < self->fft_size; k++) {
-    self->residual_spectrum[k] = fft_spectrum[k] - self->denoised_spectrum[k];
-  }
+  // Get denoised and residual spectra - Apply to both real and complex parts
+  self->kernels->split_spectrum(&fft_spectrum[1], &gain_spectrum[1],
+                                &self->denoised_spectrum[1],
+                                &self->residual_spectrum[1],
+                                self->fft_size - 1U);
 
   if (parameters.whitening_amount > 0.F) {
     spectral_whitening_run(self->whitener, parameters.whitening_amount,
@@ -91,10 +88,9 @@ bool denoise_mixer_run(DenoiseMixer *self, float *fft_spectrum,
       fft_spectrum[k] = self->residual_spectrum[k];
     }
   } else {
-    for (uint32_t k = 1U; k < self->fft_size; k++) {
-      fft_spectrum[k] = self->denoised_spectrum[k] +
-                        self->residual_spectrum[k] * parameters.noise_level;
-    }
+    self->kernels->mix_spectrum(&fft_spectrum[1], &self->denoised_spectrum[1],
+                                &self->residual_spectrum[1],
+                                parameters.noise_level, self->fft_size - 1U);
   }
 
   return true;
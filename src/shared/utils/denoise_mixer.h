@@ -21,6 +21,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef DENOISE_MIXER_H
 #define DENOISE_MIXER_H
 
+#include "arena.h"
+#include "scratch_pool.h"
+#include "spectral_kernels.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -32,9 +35,11 @@ typedef struct DenoiseMixerParameters {
 
 typedef struct DenoiseMixer DenoiseMixer;
 
-DenoiseMixer *denoise_mixer_initialize(uint32_t fft_size, uint32_t sample_rate,
+DenoiseMixer *denoise_mixer_initialize(Arena *arena, ScratchPool *scratch,
+                                       const SpectralKernels *kernels,
+                                       uint32_t fft_size, uint32_t sample_rate,
                                        uint32_t hop);
-void denoise_mixer_free(DenoiseMixer *self);
+void denoise_mixer_reset(DenoiseMixer *self);
 bool denoise_mixer_run(DenoiseMixer *self, float *fft_spectrum,
                        const float *gain_spectrum,
                        DenoiseMixerParameters parameters);
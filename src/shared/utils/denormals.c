@@ -0,0 +1,70 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "denormals.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||           \
+    defined(_M_IX86)
+#include <xmmintrin.h>
+#define DENORMALS_X86 1
+#define MXCSR_DAZ (1U << 6)
+#define MXCSR_FTZ (1U << 15)
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && defined(__GNUC__)
+#define DENORMALS_ARM64 1
+#define FPCR_FZ (1ULL << 24)
+#endif
+
+#if DENORMALS_ARM64
+static uint64_t get_fpcr(void) {
+  uint64_t fpcr = 0;
+  __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+  return fpcr;
+}
+
+static void set_fpcr(const uint64_t fpcr) {
+  __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+}
+#endif
+
+DenormalsState disable_denormals(void) {
+  DenormalsState state = {0};
+
+#if DENORMALS_X86
+  state.control_register = _mm_getcsr();
+  _mm_setcsr((unsigned int)state.control_register | MXCSR_DAZ | MXCSR_FTZ);
+#elif DENORMALS_ARM64
+  // ARM64 has no separate denormals-are-zero flag, FZ covers both inputs and
+  // outputs for single precision
+  state.control_register = get_fpcr();
+  set_fpcr(state.control_register | FPCR_FZ);
+#endif
+
+  return state;
+}
+
+void restore_denormals(const DenormalsState state) {
+#if DENORMALS_X86
+  _mm_setcsr((unsigned int)state.control_register);
+#elif DENORMALS_ARM64
+  set_fpcr(state.control_register);
+#else
+  (void)state;
+#endif
+}
@@ -0,0 +1,37 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef DENORMALS_H
+#define DENORMALS_H
+
+#include <stdint.h>
+
+// Floating point control state of the calling thread (MXCSR on x86, FPCR on
+// ARM64) as it was before denormals were disabled.
+typedef struct DenormalsState {
+  uint64_t control_register;
+} DenormalsState;
+
+// Enables flush-to-zero and denormals-are-zero for the calling thread and
+// returns the previous state so it can be restored once processing finishes.
+DenormalsState disable_denormals(void);
+void restore_denormals(DenormalsState state);
+
+#endif
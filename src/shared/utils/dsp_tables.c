@@ -0,0 +1,141 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "dsp_tables.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+typedef struct DspTable DspTable;
+
+struct DspTable {
+  DspTable *next;
+  DspTableKey key;
+  void *table;
+};
+
+// References are only counted for tables with an arena of their own. Zero
+// means the tables live in someone else's arena. New tables go in front of
+// the list, which is published once they are complete
+struct DspTables {
+  Arena *arena;
+  Arena own_arena;
+  _Atomic(DspTable *) tables;
+  const DspTables *shared;
+  uint32_t references;
+};
+
+DspTables *dsp_tables_create(void) {
+  DspTables *self = (DspTables *)calloc(1U, sizeof(DspTables));
+  if (!self) {
+    return NULL;
+  }
+
+  arena_initialize(&self->own_arena);
+  self->arena = &self->own_arena;
+  self->references = 1U;
+
+  return self;
+}
+
+DspTables *dsp_tables_initialize(Arena *arena) {
+  DspTables *self = (DspTables *)arena_calloc(arena, 1U, sizeof(DspTables));
+  if (!self) {
+    return NULL;
+  }
+
+  self->arena = arena;
+
+  return self;
+}
+
+DspTables *dsp_tables_initialize_over(Arena *arena, const DspTables *shared) {
+  DspTables *self = dsp_tables_initialize(arena);
+  if (!self) {
+    return NULL;
+  }
+
+  self->shared = shared;
+
+  return self;
+}
+
+DspTables *dsp_tables_retain(DspTables *self) {
+  if (!self || self->references == 0U) {
+    return NULL;
+  }
+
+  self->references++;
+
+  return self;
+}
+
+void dsp_tables_release(DspTables *self) {
+  if (!self || self->references == 0U) {
+    return;
+  }
+
+  self->references--;
+  if (self->references == 0U) {
+    arena_release(&self->own_arena);
+    free(self);
+  }
+}
+
+bool dsp_tables_is_shared(const DspTables *self) {
+  return self->references > 1U;
+}
+
+Arena *get_dsp_tables_arena(DspTables *self) { return self->arena; }
+
+static bool keys_equal(const DspTableKey a, const DspTableKey b) {
+  return a.type == b.type && a.size == b.size && a.variant == b.variant &&
+         a.sample_rate == b.sample_rate;
+}
+
+void *dsp_tables_find(const DspTables *self, const DspTableKey key) {
+  for (const DspTable *node =
+           atomic_load_explicit(&self->tables, memory_order_acquire);
+       node; node = node->next) {
+    if (keys_equal(node->key, key)) {
+      return node->table;
+    }
+  }
+
+  return self->shared ? dsp_tables_find(self->shared, key) : NULL;
+}
+
+// Returns the table, or NULL if it couldn't be registered
+void *dsp_tables_add(DspTables *self, const DspTableKey key, void *table) {
+  if (!table) {
+    return NULL;
+  }
+
+  DspTable *node = (DspTable *)arena_calloc(self->arena, 1U, sizeof(DspTable));
+  if (!node) {
+    return NULL;
+  }
+
+  node->key = key;
+  node->table = table;
+  node->next = atomic_load_explicit(&self->tables, memory_order_relaxed);
+  atomic_store_explicit(&self->tables, node, memory_order_release);
+
+  return table;
+}
@@ -0,0 +1,72 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef DSP_TABLES_H
+#define DSP_TABLES_H
+
+#include "arena.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum DspTableType {
+  DSP_TABLE_WINDOW = 0,
+  DSP_TABLE_FFT_PLAN = 1,
+  DSP_TABLE_CRITICAL_BANDS = 2,
+  DSP_TABLE_HEARING_THRESHOLDS = 3,
+  DSP_TABLE_SPREADING_FUNCTION = 4,
+  DSP_TABLE_SPREADED_UNITY_GAIN = 5,
+} DspTableType;
+
+// What a table is built from. Fields a type doesn't depend on are left zero
+typedef struct DspTableKey {
+  DspTableType type;
+  uint32_t size;
+  uint32_t variant;
+  uint32_t sample_rate;
+} DspTableKey;
+
+// Tables the modules build once and only read afterwards, like windows, fft
+// plans and critical band layouts. Modules look them up by what they are
+// built from before building them, so instances that share tables only pay
+// for their own processing state. Tables are only added while modules are
+// being built, by one thread at a time, and a table is complete before it can
+// be found, so looking them up while another thread adds one is safe.
+typedef struct DspTables DspTables;
+
+// Tables with an arena of their own, freed once the last instance using them
+// releases them
+DspTables *dsp_tables_create(void);
+// Tables out of an arena that already exists, which frees them with the rest
+// of its memory. These can't be shared
+DspTables *dsp_tables_initialize(Arena *arena);
+// Tables out of an arena that also find the ones of shared tables, but never
+// add to them. Modules built at any time by one of the instances sharing them
+// go through these, so they don't have to be built from the thread that
+// builds the others
+DspTables *dsp_tables_initialize_over(Arena *arena, const DspTables *shared);
+DspTables *dsp_tables_retain(DspTables *self);
+void dsp_tables_release(DspTables *self);
+bool dsp_tables_is_shared(const DspTables *self);
+
+Arena *get_dsp_tables_arena(DspTables *self);
+void *dsp_tables_find(const DspTables *self, DspTableKey key);
+void *dsp_tables_add(DspTables *self, DspTableKey key, void *table);
+
+#endif
@@ -0,0 +1,45 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "scratch_pool.h"
+
+struct ScratchPool {
+  float *buffers[SCRATCH_BUFFER_COUNT];
+};
+
+ScratchPool *scratch_pool_initialize(Arena *arena,
+                                     const uint32_t buffer_size) {
+  ScratchPool *self =
+      (ScratchPool *)arena_calloc(arena, 1U, sizeof(ScratchPool));
+  if (!self) {
+    return NULL;
+  }
+
+  // Separate arena blocks keep each buffer aligned
+  for (uint32_t i = 0U; i < SCRATCH_BUFFER_COUNT; i++) {
+    self->buffers[i] = (float *)arena_calloc(arena, buffer_size, sizeof(float));
+  }
+
+  return self;
+}
+
+float *get_scratch_buffer(ScratchPool *self, const ScratchBuffer buffer) {
+  return self->buffers[buffer];
+}
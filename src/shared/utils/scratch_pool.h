@@ -0,0 +1,45 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef SCRATCH_POOL_H
+#define SCRATCH_POOL_H
+
+#include "arena.h"
+#include <stdint.h>
+
+// Buffers of one spectrum that only hold values while a single stage of a
+// frame runs. The stages of a frame run one after the other, so they all
+// borrow the same few buffers instead of each keeping its own. A stage that
+// runs another one inside of it uses the first buffers and leaves the later
+// ones to the inner stage. Nothing survives from one stage to the next, so
+// every stage writes the parts of a buffer it reads.
+typedef enum ScratchBuffer {
+  SCRATCH_BUFFER_A = 0,
+  SCRATCH_BUFFER_B = 1,
+  SCRATCH_BUFFER_C = 2,
+  SCRATCH_BUFFER_COUNT = 3,
+} ScratchBuffer;
+
+typedef struct ScratchPool ScratchPool;
+
+ScratchPool *scratch_pool_initialize(Arena *arena, uint32_t buffer_size);
+float *get_scratch_buffer(ScratchPool *self, ScratchBuffer buffer);
+
+#endif
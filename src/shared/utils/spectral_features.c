@@ -22,49 +22,26 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <math.h>
 #include <stdlib.h>
 
+// Only one feature is asked for at a time, so all of them share a buffer
 struct SpectralFeatures {
-  float *power_spectrum;
-  float *phase_spectrum;
-  float *magnitude_spectrum;
+  float *feature_spectrum;
 
   uint32_t real_spectrum_size;
 };
 
 SpectralFeatures *
-spectral_features_initialize(const uint32_t real_spectrum_size) {
+spectral_features_initialize(Arena *arena, const uint32_t real_spectrum_size) {
   SpectralFeatures *self =
-      (SpectralFeatures *)calloc(1U, sizeof(SpectralFeatures));
+      (SpectralFeatures *)arena_calloc(arena, 1U, sizeof(SpectralFeatures));
 
   self->real_spectrum_size = real_spectrum_size;
 
-  self->power_spectrum =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
-  self->phase_spectrum =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
-  self->magnitude_spectrum =
-      (float *)calloc(self->real_spectrum_size, sizeof(float));
+  self->feature_spectrum =
+      (float *)arena_calloc(arena, self->real_spectrum_size, sizeof(float));
 
   return self;
 }
 
-void spectral_features_free(SpectralFeatures *self) {
-  free(self->power_spectrum);
-  free(self->phase_spectrum);
-  free(self->magnitude_spectrum);
-
-  free(self);
-}
-
-float *get_power_spectrum(SpectralFeatures *self) {
-  return self->power_spectrum;
-}
-float *get_magnitude_spectrum(SpectralFeatures *self) {
-  return self->magnitude_spectrum;
-}
-float *get_phase_spectrum(SpectralFeatures *self) {
-  return self->phase_spectrum;
-}
-
 static bool compute_power_spectrum(SpectralFeatures *self,
                                    const float *fft_spectrum,
                                    const uint32_t fft_spectrum_size) {
@@ -74,7 +51,7 @@ static bool compute_power_spectrum(SpectralFeatures *self,
 
   float real_bin = fft_spectrum[0];
 
-  self->power_spectrum[0] = real_bin * real_bin;
+  self->feature_spectrum[0] = real_bin * real_bin;
 
   for (uint32_t k = 1U; k < self->real_spectrum_size; k++) {
     float power = 0.F;
@@ -88,7 +65,7 @@ static bool compute_power_spectrum(SpectralFeatures *self,
       power = real_bin * real_bin;
     }
 
-    self->power_spectrum[k] = power;
+    self->feature_spectrum[k] = power;
   }
 
   return true;
@@ -103,7 +80,7 @@ static bool compute_magnitude_spectrum(SpectralFeatures *self,
 
   float real_bin = fft_spectrum[0];
 
-  self->magnitude_spectrum[0] = real_bin;
+  self->feature_spectrum[0] = real_bin;
 
   for (uint32_t k = 1U; k < self->real_spectrum_size; k++) {
     float magnitude = 0.F;
@@ -118,7 +95,7 @@ static bool compute_magnitude_spectrum(SpectralFeatures *self,
       magnitude = real_bin;
     }
 
-    self->magnitude_spectrum[k] = magnitude;
+    self->feature_spectrum[k] = magnitude;
   }
 
   return true;
@@ -132,7 +109,7 @@ static bool compute_phase_spectrum(SpectralFeatures *self,
   }
 
   float real_bin = fft_spectrum[0];
-  self->phase_spectrum[0] = atan2f(real_bin, 0.F);
+  self->feature_spectrum[0] = atan2f(real_bin, 0.F);
 
   for (uint32_t k = 1U; k < self->real_spectrum_size; k++) {
     float phase = 0.F;
@@ -146,7 +123,7 @@ static bool compute_phase_spectrum(SpectralFeatures *self,
       phase = atan2f(real_bin, 0.F);
     }
 
-    self->phase_spectrum[k] = phase;
+    self->feature_spectrum[k] = phase;
   }
 
   return true;
@@ -161,15 +138,15 @@ float *get_spectral_feature(SpectralFeatures *self, const float *fft_spectrum,
   switch (type) {
   case POWER_SPECTRUM:
     compute_power_spectrum(self, fft_spectrum, fft_spectrum_size);
-    return get_power_spectrum(self);
+    return self->feature_spectrum;
     break;
   case MAGNITUDE_SPECTRUM:
     compute_magnitude_spectrum(self, fft_spectrum, fft_spectrum_size);
-    return get_magnitude_spectrum(self);
+    return self->feature_spectrum;
     break;
   case PHASE_SPECTRUM:
     compute_phase_spectrum(self, fft_spectrum, fft_spectrum_size);
-    return get_phase_spectrum(self);
+    return self->feature_spectrum;
     break;
 
   default:
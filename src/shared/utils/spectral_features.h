@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef SPECTRAL_FEATURES_H
 #define SPECTRAL_FEATURES_H
 
+#include "arena.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -32,8 +33,8 @@ typedef enum SpectrumType {
   PHASE_SPECTRUM = 2,
 } SpectrumType;
 
-SpectralFeatures *spectral_features_initialize(uint32_t real_spectrum_size);
-void spectral_features_free(SpectralFeatures *self);
+SpectralFeatures *spectral_features_initialize(Arena *arena,
+                                               uint32_t real_spectrum_size);
 float *get_spectral_feature(SpectralFeatures *self, const float *fft_spectrum,
                             uint32_t fft_spectrum_size, SpectrumType type);
 
@@ -0,0 +1,350 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "spectral_kernels.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The vector kernels are built with a target attribute each instead of
+// compiler flags, so the rest of the library keeps the target of the build
+// and only runs them once the CPU says it can
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define KERNELS_X86 1
+#define CPUID_SSE2 (1U << 26)
+#define CPUID_OSXSAVE (1U << 27)
+#define CPUID_AVX (1U << 28)
+#define CPUID_AVX2 (1U << 5)
+#define CPUID_AVX512F (1U << 16)
+// SSE and AVX registers, then the AVX-512 mask and upper registers
+#define XCR0_AVX_STATE 0x6U
+#define XCR0_AVX512_STATE 0xE0U
+#endif
+
+// Every kernel rounds each product and sum on its own, so this file is built
+// with -ffp-contract=off. Otherwise compilers fuse them on targets with FMA,
+// which AVX-512 always has, and the variants stop giving the same output
+
+static void multiply_spectrum_scalar(float *spectrum, const float *factors,
+                                     const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    spectrum[k] *= factors[k];
+  }
+}
+
+static void min_spectrum_scalar(float *spectrum_one, const float *spectrum_two,
+                                const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    spectrum_one[k] = fminf(spectrum_one[k], spectrum_two[k]);
+  }
+}
+
+static void max_spectrum_scalar(float *spectrum_one, const float *spectrum_two,
+                                const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    spectrum_one[k] = fmaxf(spectrum_one[k], spectrum_two[k]);
+  }
+}
+
+static void update_mean_spectrum_scalar(float *mean, const float *spectrum,
+                                        const float count, const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    mean[k] += (spectrum[k] - mean[k]) / count;
+  }
+}
+
+static void wiener_gains_scalar(const float *spectrum,
+                                const float *noise_spectrum, float *gains,
+                                const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    if (noise_spectrum[k] > FLT_MIN) {
+      if (spectrum[k] > noise_spectrum[k]) {
+        gains[k] = (spectrum[k] - noise_spectrum[k]) / spectrum[k];
+      } else {
+        gains[k] = 0.F;
+      }
+    } else {
+      gains[k] = 1.F;
+    }
+  }
+}
+
+static void gate_gains_scalar(const float *spectrum,
+                              const float *noise_spectrum, float *gains,
+                              const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    if (noise_spectrum[k] > FLT_MIN) {
+      gains[k] = spectrum[k] >= noise_spectrum[k] ? 1.F : 0.F;
+    } else {
+      gains[k] = 1.F;
+    }
+  }
+}
+
+static void split_spectrum_scalar(const float *spectrum, const float *gains,
+                                  float *denoised, float *residual,
+                                  const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    denoised[k] = spectrum[k] * gains[k];
+    residual[k] = spectrum[k] - denoised[k];
+  }
+}
+
+static void mix_spectrum_scalar(float *spectrum, const float *denoised,
+                                const float *residual,
+                                const float residual_level, const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    spectrum[k] = denoised[k] + residual[k] * residual_level;
+  }
+}
+
+static void update_peak_spectrum_scalar(float *peaks, const float *spectrum,
+                                        const float floor, const float decay,
+                                        const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    peaks[k] = fmaxf(fmaxf(spectrum[k], floor), peaks[k] * decay);
+  }
+}
+
+static void whiten_spectrum_scalar(float *spectrum, const float *peaks,
+                                   const float amount, const uint32_t n) {
+  for (uint32_t k = 0U; k < n; k++) {
+    if (spectrum[k] > FLT_MIN) {
+      const float whitened = spectrum[k] / peaks[k];
+      spectrum[k] = (1.F - amount) * spectrum[k] + amount * whitened;
+    }
+  }
+}
+
+static const SpectralKernels scalar_kernels = {
+    .isa = KERNEL_ISA_SCALAR,
+    .multiply_spectrum = multiply_spectrum_scalar,
+    .min_spectrum = min_spectrum_scalar,
+    .max_spectrum = max_spectrum_scalar,
+    .update_mean_spectrum = update_mean_spectrum_scalar,
+    .wiener_gains = wiener_gains_scalar,
+    .gate_gains = gate_gains_scalar,
+    .split_spectrum = split_spectrum_scalar,
+    .mix_spectrum = mix_spectrum_scalar,
+    .update_peak_spectrum = update_peak_spectrum_scalar,
+    .whiten_spectrum = whiten_spectrum_scalar,
+};
+
+#if KERNELS_X86
+
+// Comparisons set every bit of the lanes where they hold, so selecting is
+// masking both sides and merging them
+#define KERNEL_ISA KERNEL_ISA_SSE2
+#define KERNEL_NAME(name) name##_sse2
+#define KERNEL_TARGET __attribute__((target("sse2")))
+#define VECTOR __m128
+#define VECTOR_WIDTH 4U
+#define VECTOR_LOAD(pointer) _mm_loadu_ps(pointer)
+#define VECTOR_STORE(pointer, value) _mm_storeu_ps(pointer, value)
+#define VECTOR_SET(value) _mm_set1_ps(value)
+#define VECTOR_ADD(a, b) _mm_add_ps(a, b)
+#define VECTOR_SUB(a, b) _mm_sub_ps(a, b)
+#define VECTOR_MUL(a, b) _mm_mul_ps(a, b)
+#define VECTOR_DIV(a, b) _mm_div_ps(a, b)
+#define VECTOR_MIN(a, b) _mm_min_ps(a, b)
+#define VECTOR_MAX(a, b) _mm_max_ps(a, b)
+#define VECTOR_SELECT(mask, if_true, if_false)                                 \
+  _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false))
+#define VECTOR_SELECT_GREATER(a, b, if_true, if_false)                         \
+  VECTOR_SELECT(_mm_cmpgt_ps(a, b), if_true, if_false)
+#define VECTOR_SELECT_GREATER_EQUAL(a, b, if_true, if_false)                   \
+  VECTOR_SELECT(_mm_cmpge_ps(a, b), if_true, if_false)
+#include "spectral_kernels_simd.h"
+#undef KERNEL_ISA
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+#undef VECTOR
+#undef VECTOR_WIDTH
+#undef VECTOR_LOAD
+#undef VECTOR_STORE
+#undef VECTOR_SET
+#undef VECTOR_ADD
+#undef VECTOR_SUB
+#undef VECTOR_MUL
+#undef VECTOR_DIV
+#undef VECTOR_MIN
+#undef VECTOR_MAX
+#undef VECTOR_SELECT
+#undef VECTOR_SELECT_GREATER
+#undef VECTOR_SELECT_GREATER_EQUAL
+
+#define KERNEL_ISA KERNEL_ISA_AVX2
+#define KERNEL_NAME(name) name##_avx2
+#define KERNEL_TARGET __attribute__((target("avx2")))
+#define VECTOR __m256
+#define VECTOR_WIDTH 8U
+#define VECTOR_LOAD(pointer) _mm256_loadu_ps(pointer)
+#define VECTOR_STORE(pointer, value) _mm256_storeu_ps(pointer, value)
+#define VECTOR_SET(value) _mm256_set1_ps(value)
+#define VECTOR_ADD(a, b) _mm256_add_ps(a, b)
+#define VECTOR_SUB(a, b) _mm256_sub_ps(a, b)
+#define VECTOR_MUL(a, b) _mm256_mul_ps(a, b)
+#define VECTOR_DIV(a, b) _mm256_div_ps(a, b)
+#define VECTOR_MIN(a, b) _mm256_min_ps(a, b)
+#define VECTOR_MAX(a, b) _mm256_max_ps(a, b)
+#define VECTOR_SELECT_GREATER(a, b, if_true, if_false)                         \
+  _mm256_blendv_ps(if_false, if_true, _mm256_cmp_ps(a, b, _CMP_GT_OQ))
+#define VECTOR_SELECT_GREATER_EQUAL(a, b, if_true, if_false)                   \
+  _mm256_blendv_ps(if_false, if_true, _mm256_cmp_ps(a, b, _CMP_GE_OQ))
+#include "spectral_kernels_simd.h"
+#undef KERNEL_ISA
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+#undef VECTOR
+#undef VECTOR_WIDTH
+#undef VECTOR_LOAD
+#undef VECTOR_STORE
+#undef VECTOR_SET
+#undef VECTOR_ADD
+#undef VECTOR_SUB
+#undef VECTOR_MUL
+#undef VECTOR_DIV
+#undef VECTOR_MIN
+#undef VECTOR_MAX
+#undef VECTOR_SELECT_GREATER
+#undef VECTOR_SELECT_GREATER_EQUAL
+
+#define KERNEL_ISA KERNEL_ISA_AVX512
+#define KERNEL_NAME(name) name##_avx512
+#define KERNEL_TARGET __attribute__((target("avx512f")))
+#define VECTOR __m512
+#define VECTOR_WIDTH 16U
+#define VECTOR_LOAD(pointer) _mm512_loadu_ps(pointer)
+#define VECTOR_STORE(pointer, value) _mm512_storeu_ps(pointer, value)
+#define VECTOR_SET(value) _mm512_set1_ps(value)
+#define VECTOR_ADD(a, b) _mm512_add_ps(a, b)
+#define VECTOR_SUB(a, b) _mm512_sub_ps(a, b)
+#define VECTOR_MUL(a, b) _mm512_mul_ps(a, b)
+#define VECTOR_DIV(a, b) _mm512_div_ps(a, b)
+#define VECTOR_MIN(a, b) _mm512_min_ps(a, b)
+#define VECTOR_MAX(a, b) _mm512_max_ps(a, b)
+#define VECTOR_SELECT_GREATER(a, b, if_true, if_false)                         \
+  _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_GT_OQ), if_false,       \
+                       if_true)
+#define VECTOR_SELECT_GREATER_EQUAL(a, b, if_true, if_false)                   \
+  _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_GE_OQ), if_false,       \
+                       if_true)
+#include "spectral_kernels_simd.h"
+
+static uint64_t read_xcr0(void) {
+  uint32_t eax = 0U;
+  uint32_t edx = 0U;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return ((uint64_t)edx << 32) | eax;
+}
+
+static KernelIsa detect_kernel_isa(void) {
+  unsigned int eax = 0U;
+  unsigned int ebx = 0U;
+  unsigned int ecx = 0U;
+  unsigned int edx = 0U;
+
+  if (!__get_cpuid(1U, &eax, &ebx, &ecx, &edx) || !(edx & CPUID_SSE2)) {
+    return KERNEL_ISA_SCALAR;
+  }
+
+  // The CPU having the instructions isn't enough, the OS has to save the
+  // wider registers when switching threads too
+  if (!(ecx & CPUID_OSXSAVE) || !(ecx & CPUID_AVX)) {
+    return KERNEL_ISA_SSE2;
+  }
+  const uint64_t xcr0 = read_xcr0();
+  if ((xcr0 & XCR0_AVX_STATE) != XCR0_AVX_STATE ||
+      !__get_cpuid_count(7U, 0U, &eax, &ebx, &ecx, &edx) ||
+      !(ebx & CPUID_AVX2)) {
+    return KERNEL_ISA_SSE2;
+  }
+
+  if ((xcr0 & XCR0_AVX512_STATE) != XCR0_AVX512_STATE ||
+      !(ebx & CPUID_AVX512F)) {
+    return KERNEL_ISA_AVX2;
+  }
+
+  return KERNEL_ISA_AVX512;
+}
+
+#endif
+
+KernelIsa get_supported_kernel_isa(void) {
+#if KERNELS_X86
+  return detect_kernel_isa();
+#else
+  return KERNEL_ISA_SCALAR;
+#endif
+}
+
+static KernelIsa get_environment_kernel_isa(void) {
+  const char *value = getenv("SPECBLEACH_KERNEL_ISA");
+  if (!value) {
+    return KERNEL_ISA_AUTO;
+  }
+
+  if (strcmp(value, "scalar") == 0) {
+    return KERNEL_ISA_SCALAR;
+  }
+  if (strcmp(value, "sse2") == 0) {
+    return KERNEL_ISA_SSE2;
+  }
+  if (strcmp(value, "avx2") == 0) {
+    return KERNEL_ISA_AVX2;
+  }
+  if (strcmp(value, "avx512") == 0) {
+    return KERNEL_ISA_AVX512;
+  }
+
+  return KERNEL_ISA_AUTO;
+}
+
+KernelIsa resolve_kernel_isa(const KernelIsa requested) {
+  const KernelIsa supported = get_supported_kernel_isa();
+
+  KernelIsa isa = requested;
+  if (isa == KERNEL_ISA_AUTO) {
+    isa = get_environment_kernel_isa();
+  }
+  if (isa == KERNEL_ISA_AUTO || isa > supported) {
+    isa = supported;
+  }
+
+  return isa;
+}
+
+const SpectralKernels *get_spectral_kernels(const KernelIsa isa) {
+  switch (resolve_kernel_isa(isa)) {
+#if KERNELS_X86
+  case KERNEL_ISA_SSE2:
+    return &kernels_sse2;
+  case KERNEL_ISA_AVX2:
+    return &kernels_avx2;
+  case KERNEL_ISA_AVX512:
+    return &kernels_avx512;
+#endif
+  default:
+    return &scalar_kernels;
+  }
+}
@@ -0,0 +1,85 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef SPECTRAL_KERNELS_H
+#define SPECTRAL_KERNELS_H
+
+#include <stdint.h>
+
+// Instruction sets the per bin kernels are built for. Every binary has all of
+// them, and each instance picks the one it runs when it is built, so a build
+// for a generic target still uses the widest vectors the machine has. Values
+// match SpectralBleachKernelIsa
+typedef enum KernelIsa {
+  KERNEL_ISA_AUTO = 0,
+  KERNEL_ISA_SCALAR = 1,
+  KERNEL_ISA_SSE2 = 2,
+  KERNEL_ISA_AVX2 = 3,
+  KERNEL_ISA_AVX512 = 4,
+} KernelIsa;
+
+// The loops every frame runs over each bin. They all work on n consecutive
+// bins, so callers skip the DC bin by offsetting the pointers. Every variant
+// does the same operations in the same order on each bin, so they give the
+// same results as the scalar one.
+typedef struct SpectralKernels {
+  KernelIsa isa;
+
+  // spectrum *= factors
+  void (*multiply_spectrum)(float *spectrum, const float *factors, uint32_t n);
+  // Keeps the smallest or largest of both
+  void (*min_spectrum)(float *spectrum_one, const float *spectrum_two,
+                       uint32_t n);
+  void (*max_spectrum)(float *spectrum_one, const float *spectrum_two,
+                       uint32_t n);
+  // Moves the mean towards the spectrum as the count-th one averaged
+  void (*update_mean_spectrum)(float *mean, const float *spectrum, float count,
+                               uint32_t n);
+  // Gains of the Wiener filter and of the gates. Bins without noise keep
+  // everything
+  void (*wiener_gains)(const float *spectrum, const float *noise_spectrum,
+                       float *gains, uint32_t n);
+  void (*gate_gains)(const float *spectrum, const float *noise_spectrum,
+                     float *gains, uint32_t n);
+  // Splits the spectrum into what the gains keep and what they remove
+  void (*split_spectrum)(const float *spectrum, const float *gains,
+                         float *denoised, float *residual, uint32_t n);
+  // spectrum = denoised + residual * residual_level
+  void (*mix_spectrum)(float *spectrum, const float *denoised,
+                       const float *residual, float residual_level,
+                       uint32_t n);
+  // Peaks decay and follow the spectrum, never going below the floor
+  void (*update_peak_spectrum)(float *peaks, const float *spectrum,
+                               float floor, float decay, uint32_t n);
+  // Blends the positive bins with their ratio to the peaks
+  void (*whiten_spectrum)(float *spectrum, const float *peaks, float amount,
+                          uint32_t n);
+} SpectralKernels;
+
+// Widest instruction set both the CPU and the OS support
+KernelIsa get_supported_kernel_isa(void);
+// Instruction set an instance asking for the given one runs. Auto takes the
+// SPECBLEACH_KERNEL_ISA environment variable (scalar, sse2, avx2 or avx512)
+// if set, or the widest supported otherwise. Sets the machine doesn't support
+// fall back to the widest it does
+KernelIsa resolve_kernel_isa(KernelIsa requested);
+const SpectralKernels *get_spectral_kernels(KernelIsa isa);
+
+#endif
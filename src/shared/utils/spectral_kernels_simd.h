@@ -0,0 +1,192 @@
+/*
+libspecbleach - A spectral processing library
+
+Copyright 2022 Luciano Dato <lucianodato@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Vector kernels, written once in terms of the VECTOR_ macros and included by
+// spectral_kernels.c once for each instruction set with those defined, so
+// there is no include guard. Bins past the last whole vector go through the
+// scalar kernels.
+
+static KERNEL_TARGET void KERNEL_NAME(multiply_spectrum)(float *spectrum,
+                                                         const float *factors,
+                                                         const uint32_t n) {
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    VECTOR_STORE(&spectrum[k], VECTOR_MUL(VECTOR_LOAD(&spectrum[k]),
+                                          VECTOR_LOAD(&factors[k])));
+  }
+  multiply_spectrum_scalar(&spectrum[k], &factors[k], n - k);
+}
+
+static KERNEL_TARGET void KERNEL_NAME(min_spectrum)(float *spectrum_one,
+                                                    const float *spectrum_two,
+                                                    const uint32_t n) {
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    VECTOR_STORE(&spectrum_one[k], VECTOR_MIN(VECTOR_LOAD(&spectrum_one[k]),
+                                              VECTOR_LOAD(&spectrum_two[k])));
+  }
+  min_spectrum_scalar(&spectrum_one[k], &spectrum_two[k], n - k);
+}
+
+static KERNEL_TARGET void KERNEL_NAME(max_spectrum)(float *spectrum_one,
+                                                    const float *spectrum_two,
+                                                    const uint32_t n) {
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    VECTOR_STORE(&spectrum_one[k], VECTOR_MAX(VECTOR_LOAD(&spectrum_one[k]),
+                                              VECTOR_LOAD(&spectrum_two[k])));
+  }
+  max_spectrum_scalar(&spectrum_one[k], &spectrum_two[k], n - k);
+}
+
+static KERNEL_TARGET void
+KERNEL_NAME(update_mean_spectrum)(float *mean, const float *spectrum,
+                                  const float count, const uint32_t n) {
+  const VECTOR count_vector = VECTOR_SET(count);
+
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const VECTOR current = VECTOR_LOAD(&mean[k]);
+    const VECTOR step =
+        VECTOR_DIV(VECTOR_SUB(VECTOR_LOAD(&spectrum[k]), current),
+                   count_vector);
+    VECTOR_STORE(&mean[k], VECTOR_ADD(current, step));
+  }
+  update_mean_spectrum_scalar(&mean[k], &spectrum[k], count, n - k);
+}
+
+static KERNEL_TARGET void
+KERNEL_NAME(wiener_gains)(const float *spectrum, const float *noise_spectrum,
+                          float *gains, const uint32_t n) {
+  const VECTOR zero = VECTOR_SET(0.F);
+  const VECTOR one = VECTOR_SET(1.F);
+  const VECTOR noise_floor = VECTOR_SET(FLT_MIN);
+
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const VECTOR signal = VECTOR_LOAD(&spectrum[k]);
+    const VECTOR noise = VECTOR_LOAD(&noise_spectrum[k]);
+    const VECTOR gain = VECTOR_SELECT_GREATER(
+        signal, noise, VECTOR_DIV(VECTOR_SUB(signal, noise), signal), zero);
+    VECTOR_STORE(&gains[k],
+                 VECTOR_SELECT_GREATER(noise, noise_floor, gain, one));
+  }
+  wiener_gains_scalar(&spectrum[k], &noise_spectrum[k], &gains[k], n - k);
+}
+
+static KERNEL_TARGET void
+KERNEL_NAME(gate_gains)(const float *spectrum, const float *noise_spectrum,
+                        float *gains, const uint32_t n) {
+  const VECTOR zero = VECTOR_SET(0.F);
+  const VECTOR one = VECTOR_SET(1.F);
+  const VECTOR noise_floor = VECTOR_SET(FLT_MIN);
+
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const VECTOR signal = VECTOR_LOAD(&spectrum[k]);
+    const VECTOR noise = VECTOR_LOAD(&noise_spectrum[k]);
+    const VECTOR gain = VECTOR_SELECT_GREATER_EQUAL(signal, noise, one, zero);
+    VECTOR_STORE(&gains[k],
+                 VECTOR_SELECT_GREATER(noise, noise_floor, gain, one));
+  }
+  gate_gains_scalar(&spectrum[k], &noise_spectrum[k], &gains[k], n - k);
+}
+
+static KERNEL_TARGET void
+KERNEL_NAME(split_spectrum)(const float *spectrum, const float *gains,
+                            float *denoised, float *residual,
+                            const uint32_t n) {
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const VECTOR signal = VECTOR_LOAD(&spectrum[k]);
+    const VECTOR kept = VECTOR_MUL(signal, VECTOR_LOAD(&gains[k]));
+    VECTOR_STORE(&denoised[k], kept);
+    VECTOR_STORE(&residual[k], VECTOR_SUB(signal, kept));
+  }
+  split_spectrum_scalar(&spectrum[k], &gains[k], &denoised[k], &residual[k],
+                        n - k);
+}
+
+static KERNEL_TARGET void
+KERNEL_NAME(mix_spectrum)(float *spectrum, const float *denoised,
+                          const float *residual, const float residual_level,
+                          const uint32_t n) {
+  const VECTOR level = VECTOR_SET(residual_level);
+
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const VECTOR scaled_residual = VECTOR_MUL(VECTOR_LOAD(&residual[k]), level);
+    VECTOR_STORE(&spectrum[k],
+                 VECTOR_ADD(VECTOR_LOAD(&denoised[k]), scaled_residual));
+  }
+  mix_spectrum_scalar(&spectrum[k], &denoised[k], &residual[k],
+                      residual_level, n - k);
+}
+
+static KERNEL_TARGET void
+KERNEL_NAME(update_peak_spectrum)(float *peaks, const float *spectrum,
+                                  const float floor, const float decay,
+                                  const uint32_t n) {
+  const VECTOR floor_vector = VECTOR_SET(floor);
+  const VECTOR decay_vector = VECTOR_SET(decay);
+
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const VECTOR floored = VECTOR_MAX(VECTOR_LOAD(&spectrum[k]), floor_vector);
+    const VECTOR decayed = VECTOR_MUL(VECTOR_LOAD(&peaks[k]), decay_vector);
+    VECTOR_STORE(&peaks[k], VECTOR_MAX(floored, decayed));
+  }
+  update_peak_spectrum_scalar(&peaks[k], &spectrum[k], floor, decay, n - k);
+}
+
+static KERNEL_TARGET void KERNEL_NAME(whiten_spectrum)(float *spectrum,
+                                                       const float *peaks,
+                                                       const float amount,
+                                                       const uint32_t n) {
+  const VECTOR kept_amount = VECTOR_SET(1.F - amount);
+  const VECTOR whitened_amount = VECTOR_SET(amount);
+  const VECTOR signal_floor = VECTOR_SET(FLT_MIN);
+
+  uint32_t k = 0U;
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const VECTOR signal = VECTOR_LOAD(&spectrum[k]);
+    const VECTOR whitened = VECTOR_DIV(signal, VECTOR_LOAD(&peaks[k]));
+    const VECTOR blended =
+        VECTOR_ADD(VECTOR_MUL(kept_amount, signal),
+                   VECTOR_MUL(whitened_amount, whitened));
+    VECTOR_STORE(&spectrum[k], VECTOR_SELECT_GREATER(signal, signal_floor,
+                                                     blended, signal));
+  }
+  whiten_spectrum_scalar(&spectrum[k], &peaks[k], amount, n - k);
+}
+
+static const SpectralKernels KERNEL_NAME(kernels) = {
+    .isa = KERNEL_ISA,
+    .multiply_spectrum = KERNEL_NAME(multiply_spectrum),
+    .min_spectrum = KERNEL_NAME(min_spectrum),
+    .max_spectrum = KERNEL_NAME(max_spectrum),
+    .update_mean_spectrum = KERNEL_NAME(update_mean_spectrum),
+    .wiener_gains = KERNEL_NAME(wiener_gains),
+    .gate_gains = KERNEL_NAME(gate_gains),
+    .split_spectrum = KERNEL_NAME(split_spectrum),
+    .mix_spectrum = KERNEL_NAME(mix_spectrum),
+    .update_peak_spectrum = KERNEL_NAME(update_peak_spectrum),
+    .whiten_spectrum = KERNEL_NAME(whiten_spectrum),
+};
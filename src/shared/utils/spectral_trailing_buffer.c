@@ -31,25 +31,26 @@ struct SpectralTrailingBuffer {
 };
 
 SpectralTrailingBuffer *
-spectral_trailing_buffer_initialize(const uint32_t real_spectrum_size,
+spectral_trailing_buffer_initialize(Arena *arena,
+                                    const uint32_t real_spectrum_size,
                                     const uint32_t buffer_size) {
-  SpectralTrailingBuffer *self =
-      (SpectralTrailingBuffer *)calloc(1U, sizeof(SpectralTrailingBuffer));
+  SpectralTrailingBuffer *self = (SpectralTrailingBuffer *)arena_calloc(
+      arena, 1U, sizeof(SpectralTrailingBuffer));
 
   self->real_spectrum_size = real_spectrum_size;
   self->buffer_size = buffer_size;
 
-  self->buffer = (float *)calloc(
-      ((size_t)self->real_spectrum_size * (size_t)self->buffer_size),
+  self->buffer = (float *)arena_calloc(
+      arena, ((size_t)self->real_spectrum_size * (size_t)self->buffer_size),
       sizeof(float));
 
   return self;
 }
 
-void spectral_trailing_buffer_free(SpectralTrailingBuffer *self) {
-  free(self->buffer);
-
-  free(self);
+void spectral_trailing_buffer_reset(SpectralTrailingBuffer *self) {
+  memset(self->buffer, 0,
+         sizeof(float) * (size_t)self->real_spectrum_size *
+             (size_t)self->buffer_size);
 }
 
 bool spectral_trailing_buffer_push_back(SpectralTrailingBuffer *self,
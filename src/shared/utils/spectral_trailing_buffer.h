@@ -21,15 +21,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef SPECTRAL_TRAILING_BUFFER_H
 #define SPECTRAL_TRAILING_BUFFER_H
 
+#include "arena.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 typedef struct SpectralTrailingBuffer SpectralTrailingBuffer;
 
 SpectralTrailingBuffer *
-spectral_trailing_buffer_initialize(uint32_t real_spectrum_size,
+spectral_trailing_buffer_initialize(Arena *arena, uint32_t real_spectrum_size,
                                     uint32_t buffer_size);
-void spectral_trailing_buffer_free(SpectralTrailingBuffer *self);
+void spectral_trailing_buffer_reset(SpectralTrailingBuffer *self);
 bool spectral_trailing_buffer_push_back(SpectralTrailingBuffer *self,
                                         const float *input_spectrum);
 float *get_trailing_spectral_buffer(SpectralTrailingBuffer *self);
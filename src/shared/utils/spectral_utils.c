@@ -24,6 +24,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <float.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 static float blackman(const uint32_t bin_index, const uint32_t fft_size) {
   const float p = ((float)(bin_index)) / ((float)(fft_size));
@@ -113,28 +114,24 @@ float min_spectral_value(const float *spectrum,
   return min;
 }
 
-bool min_spectrum(float *spectrum_one, const float *spectrum_two,
-                  const uint32_t spectrum_size) {
+bool min_spectrum(const SpectralKernels *kernels, float *spectrum_one,
+                  const float *spectrum_two, const uint32_t spectrum_size) {
   if (!spectrum_one || !spectrum_two || spectrum_size <= 0U) {
     return false;
   }
 
-  for (uint32_t k = 0; k < spectrum_size; k++) {
-    spectrum_one[k] = fminf(spectrum_one[k], spectrum_two[k]);
-  }
+  kernels->min_spectrum(spectrum_one, spectrum_two, spectrum_size);
 
   return true;
 }
 
-bool max_spectrum(float *spectrum_one, const float *spectrum_two,
-                  const uint32_t spectrum_size) {
+bool max_spectrum(const SpectralKernels *kernels, float *spectrum_one,
+                  const float *spectrum_two, const uint32_t spectrum_size) {
   if (!spectrum_one || !spectrum_two || spectrum_size <= 0U) {
     return false;
   }
 
-  for (uint32_t k = 0; k < spectrum_size; k++) {
-    spectrum_one[k] = fmaxf(spectrum_one[k], spectrum_two[k]);
-  }
+  kernels->max_spectrum(spectrum_one, spectrum_two, spectrum_size);
 
   return true;
 }
@@ -182,7 +179,8 @@ float spectral_flux(const float *spectrum, const float *previous_spectrum,
   return spectral_flux;
 }
 
-bool get_rolling_mean_spectrum(float *averaged_spectrum,
+bool get_rolling_mean_spectrum(const SpectralKernels *kernels,
+                               float *averaged_spectrum,
                                const float *current_spectrum,
                                const uint32_t number_of_blocks,
                                const uint32_t spectrum_size) {
@@ -190,13 +188,12 @@ bool get_rolling_mean_spectrum(float *averaged_spectrum,
     return false;
   }
 
-  for (uint32_t k = 1U; k < spectrum_size; k++) {
-    if (number_of_blocks <= 1U) {
-      averaged_spectrum[k] = current_spectrum[k];
-    } else {
-      averaged_spectrum[k] += (current_spectrum[k] - averaged_spectrum[k]) /
-                              (float)number_of_blocks;
-    }
+  if (number_of_blocks <= 1U) {
+    memcpy(&averaged_spectrum[1], &current_spectrum[1],
+           (spectrum_size - 1U) * sizeof(float));
+  } else {
+    kernels->update_mean_spectrum(&averaged_spectrum[1], &current_spectrum[1],
+                                  (float)number_of_blocks, spectrum_size - 1U);
   }
 
   return true;
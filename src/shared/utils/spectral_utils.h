@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef SPECTRAL_UTILS_H
 #define SPECTRAL_UTILS_H
 
+#include "spectral_kernels.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -40,16 +41,17 @@ bool direct_matrix_to_vector_spectral_convolution(const float *matrix_spectum,
                                                   uint32_t spectrum_size);
 float max_spectral_value(const float *spectrum, uint32_t real_spectrum_size);
 float min_spectral_value(const float *spectrum, uint32_t real_spectrum_size);
-bool min_spectrum(float *spectrum_one, const float *spectrum_two,
-                  uint32_t spectrum_size);
-bool max_spectrum(float *spectrum_one, const float *spectrum_two,
-                  uint32_t spectrum_size);
+bool min_spectrum(const SpectralKernels *kernels, float *spectrum_one,
+                  const float *spectrum_two, uint32_t spectrum_size);
+bool max_spectrum(const SpectralKernels *kernels, float *spectrum_one,
+                  const float *spectrum_two, uint32_t spectrum_size);
 float fft_bin_to_freq(uint32_t bin_index, uint32_t sample_rate,
                       uint32_t fft_size);
 uint32_t freq_to_fft_bin(float freq, uint32_t sample_rate, uint32_t fft_size);
 float spectral_flux(const float *spectrum, const float *previous_spectrum,
                     uint32_t spectrum_size);
-bool get_rolling_mean_spectrum(float *averaged_spectrum,
+bool get_rolling_mean_spectrum(const SpectralKernels *kernels,
+                               float *averaged_spectrum,
                                const float *current_spectrum,
                                uint32_t number_of_blocks,
                                uint32_t spectrum_size);